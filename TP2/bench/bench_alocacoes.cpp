@@ -0,0 +1,127 @@
+/*
+ * Conta as alocações de memória feitas pela simulação.
+ *
+ * Substitui o operator new global por uma versão que conta chamadas e bytes,
+ * gera uma carga sintética fixa (semente constante), agrupa as demandas e
+ * simula com a saída descartada. As contagens são separadas por fase:
+ *   agrupamento   agruparDemandas
+ *   simulacao     montagem das corridas (rota e trechos) e eventos
+ *
+ * Saída: uma linha por (carga, fase), separada por tabulações, com o número
+ * de alocações, os bytes alocados e as alocações por corrida.
+ */
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <streambuf>
+
+#include "demanda.hpp"
+#include "agrupador.hpp"
+#include "escalonador.hpp"
+#include "fontegrupos.hpp"
+
+using namespace std;
+
+static long long contagemAlocacoes = 0;
+static long long contagemBytes = 0;
+
+void* operator new(size_t bytes) {
+    ++contagemAlocacoes;
+    contagemBytes += static_cast<long long>(bytes);
+    void* p = malloc(bytes ? bytes : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// Descarta tudo o que for escrito
+class BufferNulo : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct Carga {
+    const char* nome;
+    int numDemandas;
+    int numCentros;     // menos centros, mais demandas vizinhas compatíveis
+    Parametros params;
+};
+
+/*
+ * Demandas com chegadas de Poisson e origens/destinos em torno de
+ * poucos centros, para que os grupos tenham tamanhos variados.
+ */
+static Demanda* gerarDemandas(int n, int numCentros, unsigned long long semente) {
+    mt19937_64 rng(semente);
+    exponential_distribution<double> chegada(2.0);
+    normal_distribution<double> espalhamento(0.0, 3.0);
+    uniform_int_distribution<int> centro(0, numCentros - 1);
+    const double cx[] = {10.0, 60.0, 20.0, 80.0};
+    const double cy[] = {10.0, 20.0, 70.0, 90.0};
+
+    Demanda* demandas = new Demanda[n];
+    double t = 0.0;
+    for (int i = 0; i < n; ++i) {
+        t += chegada(rng);
+        int co = centro(rng);
+        int cd = centro(rng);
+        Ponto origem = {cx[co] + espalhamento(rng), cy[co] + espalhamento(rng)};
+        Ponto destino = {cx[cd] + espalhamento(rng), cy[cd] + espalhamento(rng)};
+        demandas[i] = Demanda(i, t, origem, destino);
+    }
+    return demandas;
+}
+
+static void imprimirFase(const char* carga, const char* fase, long long alocacoes,
+                         long long bytes, int qtdCorridas) {
+    cout << carga << "\t" << fase << "\t" << alocacoes << "\t" << bytes << "\t"
+         << (qtdCorridas > 0 ? static_cast<double>(alocacoes) / qtdCorridas : 0.0) << "\n";
+}
+
+int main() {
+    const Carga cargas[] = {
+        {"individual", 200000, 4, {4, 1.0, 0.5, 2.0, 2.0, 0.9}},
+        {"compartilhada", 200000, 2, {4, 1.0, 5.0, 10.0, 10.0, 0.5}},
+        {"onibus", 200000, 1, {12, 1.0, 20.0, 15.0, 15.0, 0.3}},
+    };
+
+    BufferNulo nulo;
+    cout << "carga\tfase\talocacoes\tbytes\talocacoes_por_corrida\n";
+
+    for (const Carga& c : cargas) {
+        Demanda* demandas = gerarDemandas(c.numDemandas, c.numCentros, 7);
+        TabelaDemandas tabela(c.numDemandas);
+        for (int i = 0; i < c.numDemandas; ++i) {
+            tabela.definir(i, demandas[i]);
+        }
+
+        long long a0 = contagemAlocacoes, b0 = contagemBytes;
+        int qtdGrupos;
+        int* limites = agruparDemandas(tabela.getColunas(), c.params, nullptr, qtdGrupos);
+        imprimirFase(c.nome, "agrupamento", contagemAlocacoes - a0, contagemBytes - b0, qtdGrupos);
+
+        a0 = contagemAlocacoes;
+        b0 = contagemBytes;
+        streambuf* original = cout.rdbuf(&nulo);
+        {
+            Escalonador escalonador(1024, c.params.gama);
+            FonteGrupos fonte(tabela, limites, qtdGrupos);
+            escalonador.simularEImprimir(&fonte);
+        }
+        cout.rdbuf(original);
+        imprimirFase(c.nome, "simulacao", contagemAlocacoes - a0, contagemBytes - b0, qtdGrupos);
+
+        delete[] limites;
+        delete[] demandas;
+    }
+    return 0;
+}
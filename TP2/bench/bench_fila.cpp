@@ -0,0 +1,164 @@
+/*
+ * Benchmark das filas de eventos do Escalonador (modelo "hold"):
+ * a fila é preenchida com n eventos e, em seguida, cada operação remove o
+ * menor evento e insere outro em tempo + incremento, como numa simulação.
+ *
+ * Os incrementos seguem distribuições próximas das do TP2:
+ *   exponencial   chegadas de Poisson
+ *   uniforme      espaçamento regular
+ *   bimodal       trechos curtos dentro de um bairro e alguns longos
+ *   triangular    tempos de trecho concentrados em torno da média
+ *
+ * Filas comparadas: MinHeap e DaryHeap binário crus, com chave double e
+ * valor int (o DaryHeap é o heap da FilaHeap, com o mesmo item de 16 bytes),
+ * e as filas de eventos do Escalonador.
+ *
+ * Saída: uma linha por (fila, distribuição, n), separada por tabulações,
+ * com o tempo médio por operação (remoção + inserção) em nanossegundos.
+ */
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "minheap.hpp"
+#include "daryheap.hpp"
+#include "filaheap.hpp"
+#include "filacalendario.hpp"
+
+using namespace std;
+
+enum Distribuicao {
+    DIST_EXPONENCIAL = 0,
+    DIST_UNIFORME,
+    DIST_BIMODAL,
+    DIST_TRIANGULAR,
+    NUM_DISTRIBUICOES
+};
+
+static const char* NOMES_DIST[] = {"exponencial", "uniforme", "bimodal", "triangular"};
+
+/*
+ * Gera incrementos de tempo com média próxima de 1 na distribuição escolhida.
+ */
+class GeradorIncrementos {
+private:
+    mt19937_64 rng;
+    Distribuicao dist;
+    uniform_real_distribution<double> u01;
+
+public:
+    GeradorIncrementos(Distribuicao dist_, unsigned long long semente)
+        : rng(semente), dist(dist_), u01(0.0, 1.0) {}
+
+    double proximo() {
+        double u = u01(rng);
+        switch (dist) {
+            case DIST_EXPONENCIAL:
+                return -log(1.0 - u);
+            case DIST_UNIFORME:
+                return 2.0 * u;
+            case DIST_BIMODAL:
+                return (u < 0.9) ? 0.2 * u01(rng) : 9.0 + 2.0 * u01(rng);
+            case DIST_TRIANGULAR:
+            default:
+                return u + u01(rng);
+        }
+    }
+};
+
+/*
+ * Fila crua sobre o MinHeap (chave, valor), sem guardar eventos,
+ * para separar o custo do heap do custo da interface FilaEventos.
+ */
+static double medirMinHeap(Distribuicao dist, int n, int operacoes) {
+    GeradorIncrementos gerador(dist, 42);
+    MinHeap heap(n);
+    for (int i = 0; i < n; ++i) {
+        heap.inserir(gerador.proximo(), i);
+    }
+
+    auto inicio = chrono::steady_clock::now();
+    double tempo = 0.0;
+    int valor = 0;
+    for (int k = 0; k < operacoes; ++k) {
+        if (!heap.removerMinimo(tempo, valor)) break;  // nunca vazio: n >= 1
+        heap.inserir(tempo + gerador.proximo(), valor);
+    }
+    auto fim = chrono::steady_clock::now();
+
+    return chrono::duration<double, nano>(fim - inicio).count() / operacoes;
+}
+
+/*
+ * Mesmo modelo sobre o DaryHeap binário, preenchido como a FilaHeap
+ * (inserções seguidas).
+ */
+static double medirDaryHeap(Distribuicao dist, int n, int operacoes) {
+    GeradorIncrementos gerador(dist, 42);
+    DaryHeap<double, int, 2> heap(n);
+    for (int i = 0; i < n; ++i) {
+        heap.inserir(gerador.proximo(), i);
+    }
+
+    auto inicio = chrono::steady_clock::now();
+    double tempo = 0.0;
+    int valor = 0;
+    for (int k = 0; k < operacoes; ++k) {
+        if (!heap.removerMinimo(tempo, valor)) break;  // nunca vazio: n >= 1
+        heap.inserir(tempo + gerador.proximo(), valor);
+    }
+    auto fim = chrono::steady_clock::now();
+
+    return chrono::duration<double, nano>(fim - inicio).count() / operacoes;
+}
+
+/*
+ * Mesmo modelo sobre uma FilaEventos qualquer.
+ */
+static double medirFila(FilaEventos& fila, Distribuicao dist, int n, int operacoes) {
+    GeradorIncrementos gerador(dist, 42);
+    Evento e;
+    e.tipo = EVENTO_PARADA;
+    e.corrida = nullptr;
+    for (int i = 0; i < n; ++i) {
+        e.tempo = gerador.proximo();
+        e.indiceParada = i;
+        fila.inserir(e);
+    }
+
+    auto inicio = chrono::steady_clock::now();
+    for (int k = 0; k < operacoes; ++k) {
+        fila.removerMinimo(e);
+        e.tempo += gerador.proximo();
+        fila.inserir(e);
+    }
+    auto fim = chrono::steady_clock::now();
+
+    return chrono::duration<double, nano>(fim - inicio).count() / operacoes;
+}
+
+int main() {
+    const int tamanhos[] = {1000, 100000, 1000000};
+    const int operacoes = 2000000;
+
+    cout << "fila\tdistribuicao\tn\tns_por_operacao\n";
+    for (int d = 0; d < NUM_DISTRIBUICOES; ++d) {
+        Distribuicao dist = static_cast<Distribuicao>(d);
+        for (int n : tamanhos) {
+            double ns = medirMinHeap(dist, n, operacoes);
+            cout << "minheap\t" << NOMES_DIST[d] << "\t" << n << "\t" << ns << "\n";
+
+            ns = medirDaryHeap(dist, n, operacoes);
+            cout << "dary2\t" << NOMES_DIST[d] << "\t" << n << "\t" << ns << "\n";
+
+            FilaHeap filaHeap(n);
+            ns = medirFila(filaHeap, dist, n, operacoes);
+            cout << "heap\t" << NOMES_DIST[d] << "\t" << n << "\t" << ns << "\n";
+
+            FilaCalendario calendario;
+            ns = medirFila(calendario, dist, n, operacoes);
+            cout << "calendario\t" << NOMES_DIST[d] << "\t" << n << "\t" << ns << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * Compara os dois motores da simulação sobre a mesma carga sintética
+ * (ver geradordemandas.hpp), já agrupada:
+ *   eventos      Escalonador::simularEImprimir (um Evento por parada)
+ *   corrotinas   Escalonador::simularCorrotinas (uma corrotina por corrida)
+ *
+ * A saída de cada execução passa por um resumo (FNV-1a de 64 bits e número
+ * de bytes) em vez de ser escrita; os resumos dos dois motores têm de ser
+ * iguais. Cada motor roda REPETICOES vezes; a saída tem uma linha por motor,
+ * separada por tabulações, com o tempo por corrida (menor e mediana), os
+ * bytes e o resumo.
+ *
+ * Uso:
+ *   bench_motores.out [--n N]   N demandas (padrão 1000000)
+ *
+ * Retorna 1 se as saídas dos motores forem diferentes.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+
+#include "geradordemandas.hpp"
+#include "agrupador.hpp"
+#include "escalonador.hpp"
+#include "fontegrupos.hpp"
+
+using namespace std;
+
+static const int REPETICOES = 5;
+
+// Parâmetros da carga: η, γ, δ, α, β, λ (os mesmos de bench_tp2)
+static const Parametros PARAMS_BENCH = {4, 1.0, 5.0, 8.0, 8.0, 0.4};
+
+// Taxa média de chegada (demandas por minuto do dia simulado)
+static const double TAXA_MEDIA = 20.0;
+
+// Resume tudo o que for escrito, sem guardar
+class BufferResumo : public streambuf {
+private:
+    static const int TAMANHO = 64 * 1024;
+    char area[TAMANHO];
+    unsigned long long resumo;
+    long long bytes;
+
+    void consumir() {
+        for (char* p = pbase(); p < pptr(); ++p) {
+            resumo ^= static_cast<unsigned char>(*p);
+            resumo *= 1099511628211ULL;
+        }
+        bytes += pptr() - pbase();
+        setp(area, area + TAMANHO);
+    }
+
+protected:
+    int overflow(int c) override {
+        consumir();
+        if (c != traits_type::eof()) {
+            *pptr() = static_cast<char>(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        consumir();
+        return 0;
+    }
+
+public:
+    BufferResumo() : resumo(14695981039346656037ULL), bytes(0) {
+        setp(area, area + TAMANHO);
+    }
+
+    unsigned long long getResumo() {
+        consumir();
+        return resumo;
+    }
+
+    long long getBytes() {
+        consumir();
+        return bytes;
+    }
+};
+
+struct Medicao {
+    const char* motor;
+    double minimoNs;
+    double medianaNs;
+    long long bytes;
+    unsigned long long resumo;
+};
+
+/*
+ * Simula os grupos REPETICOES vezes com o motor pedido e devolve o menor
+ * tempo e a mediana por corrida, com o resumo da última saída.
+ */
+static Medicao medir(const char* motor, bool corrotinas, TabelaDemandas& tabela,
+                     int* limites, int qtdGrupos) {
+    double tempos[REPETICOES];
+    Medicao m = {motor, 0.0, 0.0, 0, 0};
+
+    for (int r = 0; r < REPETICOES; ++r) {
+        BufferResumo buffer;
+        streambuf* original = cout.rdbuf(&buffer);
+        cout << fixed << setprecision(2);
+
+        auto inicio = chrono::steady_clock::now();
+        {
+            Escalonador escalonador(1024, PARAMS_BENCH.gama);
+            FonteGrupos fonte(tabela, limites, qtdGrupos);
+            if (corrotinas) {
+                escalonador.simularCorrotinas(&fonte);
+            } else {
+                escalonador.simularEImprimir(&fonte);
+            }
+        }
+        cout.flush();
+        auto fim = chrono::steady_clock::now();
+
+        cout.rdbuf(original);
+        tempos[r] = chrono::duration<double, nano>(fim - inicio).count() / qtdGrupos;
+        m.bytes = buffer.getBytes();
+        m.resumo = buffer.getResumo();
+    }
+
+    // ordenação por inserção (poucos valores)
+    for (int i = 1; i < REPETICOES; ++i) {
+        double x = tempos[i];
+        int j = i - 1;
+        while (j >= 0 && tempos[j] > x) {
+            tempos[j + 1] = tempos[j];
+            --j;
+        }
+        tempos[j + 1] = x;
+    }
+    m.minimoNs = tempos[0];
+    m.medianaNs = tempos[REPETICOES / 2];
+    return m;
+}
+
+int main(int argc, char** argv) {
+    int n = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = atoi(argv[++i]);
+        } else {
+            cerr << "uso: " << argv[0] << " [--n N]\n";
+            return 2;
+        }
+    }
+    if (n <= 0) {
+        cerr << "--n deve ser positivo\n";
+        return 2;
+    }
+
+    GeradorDemandas gerador(configCidade(TAXA_MEDIA), 2024);
+    Demanda* demandas = gerador.gerar(n);
+
+    TabelaDemandas tabela(n);
+    for (int i = 0; i < n; ++i) {
+        tabela.definir(i, demandas[i]);
+    }
+
+    int qtdGrupos;
+    int* limites = agruparDemandas(tabela.getColunas(), PARAMS_BENCH, nullptr, qtdGrupos);
+
+    Medicao medicoes[2];
+    medicoes[0] = medir("eventos", false, tabela, limites, qtdGrupos);
+    medicoes[1] = medir("corrotinas", true, tabela, limites, qtdGrupos);
+
+    cout << "motor\tcorridas\tmin_ns\tmediana_ns\tbytes\tresumo\n";
+    for (int k = 0; k < 2; ++k) {
+        const Medicao& m = medicoes[k];
+        cout << m.motor << "\t" << qtdGrupos << "\t"
+             << fixed << setprecision(1) << m.minimoNs << "\t" << m.medianaNs << "\t"
+             << m.bytes << "\t" << hex << m.resumo << dec << "\n";
+    }
+
+    delete[] limites;
+    delete[] demandas;
+
+    bool iguais = medicoes[0].bytes == medicoes[1].bytes &&
+                  medicoes[0].resumo == medicoes[1].resumo;
+    if (!iguais) {
+        cerr << "saidas diferentes entre os motores\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+/*
+ * Benchmarks do TP2 sobre demandas sintéticas realistas (ver geradordemandas.hpp).
+ *
+ * Casos (tempo por operação, em nanossegundos):
+ *   distanciaRota          uma chamada por grupo formado
+ *   agrupamento            agruparDemandas, por demanda
+ *   rota_e_trechos         Corrida + construirRotaBasica + calcularTrechosEDistancia,
+ *                          por corrida
+ *   minheap                remoção + inserção em um MinHeap de 100000 itens
+ *   fim_a_fim_heap         agrupamento + simulação (saída descartada), por demanda
+ *   fim_a_fim_calendario   o mesmo com a fila calendário
+ *   fim_a_fim_analitico    o mesmo com simularAnalitico
+ *
+ * Cada caso roda REPETICOES vezes; a saída tem uma linha por caso, separada
+ * por tabulações, com o menor tempo e a mediana.
+ *
+ * Uso:
+ *   bench_tp2.out [--n N]                 mede (N demandas; padrão 200000)
+ *   bench_tp2.out --base ARQ [--tolerancia T]
+ *                                         mede e compara com uma saída anterior;
+ *                                         retorna 1 se algum caso ficar mais de
+ *                                         T (padrão 0.10) mais lento
+ *   bench_tp2.out --gerar N [--semente S] escreve uma entrada do TP2 com N demandas
+ */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include "geradordemandas.hpp"
+#include "agrupador.hpp"
+#include "escalonador.hpp"
+#include "fontegrupos.hpp"
+#include "minheap.hpp"
+#include "simulacaoanalitica.hpp"
+
+using namespace std;
+
+static const int REPETICOES = 5;
+static const int MAX_CASOS = 16;
+
+// Parâmetros usados em todos os casos: η, γ, δ, α, β, λ
+static const Parametros PARAMS_BENCH = {4, 1.0, 5.0, 8.0, 8.0, 0.4};
+
+// Taxa média de chegada (demandas por minuto do dia simulado)
+static const double TAXA_MEDIA = 20.0;
+
+// Descarta tudo o que for escrito
+class BufferNulo : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct Medicao {
+    const char* caso;
+    long long operacoes;
+    double minimoNs;
+    double medianaNs;
+};
+
+/*
+ * Executa corpo() REPETICOES vezes e devolve o menor tempo e a mediana,
+ * por operação.
+ */
+template <typename Corpo>
+static Medicao medir(const char* caso, long long operacoes, Corpo corpo) {
+    double tempos[REPETICOES];
+    for (int r = 0; r < REPETICOES; ++r) {
+        auto inicio = chrono::steady_clock::now();
+        corpo();
+        auto fim = chrono::steady_clock::now();
+        tempos[r] = chrono::duration<double, nano>(fim - inicio).count() / operacoes;
+    }
+
+    // ordenação por inserção (poucos valores)
+    for (int i = 1; i < REPETICOES; ++i) {
+        double x = tempos[i];
+        int j = i - 1;
+        while (j >= 0 && tempos[j] > x) {
+            tempos[j + 1] = tempos[j];
+            --j;
+        }
+        tempos[j + 1] = x;
+    }
+
+    Medicao m = {caso, operacoes, tempos[0], tempos[REPETICOES / 2]};
+    return m;
+}
+
+// Evita que o compilador descarte cálculos cujo resultado não é usado
+static volatile double sumidouro;
+
+static int executarCasos(int n, Medicao* medicoes) {
+    int qtd = 0;
+
+    GeradorDemandas gerador(configCidade(TAXA_MEDIA), 2024);
+    Demanda* demandas = gerador.gerar(n);
+
+    TabelaDemandas tabela(n);
+    for (int i = 0; i < n; ++i) {
+        tabela.definir(i, demandas[i]);
+    }
+    const ColunasDemandas& colunas = tabela.getColunas();
+
+    int qtdGrupos;
+    int* limites = agruparDemandas(colunas, PARAMS_BENCH, nullptr, qtdGrupos);
+
+    int* indices = new int[n];
+    for (int i = 0; i < n; ++i) {
+        indices[i] = i;
+    }
+
+    medicoes[qtd++] = medir("distanciaRota", qtdGrupos, [&] {
+        double soma = 0.0;
+        for (int g = 0; g < qtdGrupos; ++g) {
+            soma += distanciaRota(colunas, indices + limites[g], limites[g + 1] - limites[g]);
+        }
+        sumidouro = soma;
+    });
+
+    medicoes[qtd++] = medir("agrupamento", n, [&] {
+        int q;
+        int* l = agruparDemandas(colunas, PARAMS_BENCH, nullptr, q);
+        delete[] l;
+    });
+
+    medicoes[qtd++] = medir("rota_e_trechos", qtdGrupos, [&] {
+        double soma = 0.0;
+        for (int g = 0; g < qtdGrupos; ++g) {
+            Corrida corrida(&tabela, limites[g + 1] - limites[g]);
+            for (int k = limites[g]; k < limites[g + 1]; ++k) {
+                corrida.adicionarDemanda(k);
+            }
+            corrida.construirRotaBasica();
+            corrida.calcularTrechosEDistancia();
+            soma += corrida.getDistanciaTotal();
+        }
+        sumidouro = soma;
+    });
+
+    const int tamHeap = 100000;
+    const int operacoesHeap = 1000000;
+    medicoes[qtd++] = medir("minheap", operacoesHeap, [&] {
+        mt19937_64 rng(7);
+        exponential_distribution<double> incremento(1.0);
+        MinHeap heap(tamHeap);
+        for (int i = 0; i < tamHeap; ++i) {
+            heap.inserir(incremento(rng), i);
+        }
+        double tempo;
+        int valor;
+        for (int k = 0; k < operacoesHeap; ++k) {
+            heap.removerMinimo(tempo, valor);
+            heap.inserir(tempo + incremento(rng), valor);
+        }
+    });
+
+    BufferNulo nulo;
+    streambuf* original = cout.rdbuf(&nulo);
+
+    const TipoFila filas[] = {FILA_HEAP, FILA_CALENDARIO};
+    const char* nomesFila[] = {"fim_a_fim_heap", "fim_a_fim_calendario"};
+    for (int f = 0; f < 2; ++f) {
+        medicoes[qtd++] = medir(nomesFila[f], n, [&] {
+            int q;
+            int* l = agruparDemandas(colunas, PARAMS_BENCH, nullptr, q);
+            Escalonador escalonador(1024, PARAMS_BENCH.gama, filas[f]);
+            FonteGrupos fonte(tabela, l, q);
+            escalonador.simularEImprimir(&fonte);
+            delete[] l;
+        });
+    }
+
+    medicoes[qtd++] = medir("fim_a_fim_analitico", n, [&] {
+        int q;
+        int* l = agruparDemandas(colunas, PARAMS_BENCH, nullptr, q);
+        simularAnalitico(colunas, l, q, PARAMS_BENCH.gama, nullptr, cout);
+        delete[] l;
+    });
+
+    cout.rdbuf(original);
+
+    delete[] indices;
+    delete[] limites;
+    delete[] demandas;
+    return qtd;
+}
+
+/*
+ * Procura o caso na saída anterior (mesmo formato) e devolve seu menor tempo,
+ * ou um valor negativo se o caso não estiver lá ou tiver outro n.
+ */
+static double tempoBase(const char* arquivo, const Medicao& m) {
+    ifstream in(arquivo);
+    string linha;
+    while (getline(in, linha)) {
+        istringstream campos(linha);
+        string caso;
+        long long operacoes;
+        double minimo;
+        if (!(campos >> caso >> operacoes >> minimo)) continue;   // cabeçalho
+        if (caso == m.caso && operacoes == m.operacoes) return minimo;
+    }
+    return -1.0;
+}
+
+static void gerarEntrada(int n, unsigned long long semente) {
+    const Parametros& p = PARAMS_BENCH;
+    cout << p.eta << " " << p.gama << " " << p.delta << " " << p.alfa << " "
+         << p.beta << " " << p.lambda << " " << n << "\n";
+
+    GeradorDemandas gerador(configCidade(TAXA_MEDIA), semente);
+    cout << fixed << setprecision(4);
+    for (int i = 0; i < n; ++i) {
+        Demanda d = gerador.proxima();
+        cout << d.getId() << " " << d.getTempoSolicitacao() << " "
+             << d.getOrigem().x << " " << d.getOrigem().y << " "
+             << d.getDestino().x << " " << d.getDestino().y << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int n = 200000;
+    int gerar = 0;
+    unsigned long long semente = 1;
+    const char* base = nullptr;
+    double tolerancia = 0.10;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--gerar") == 0 && i + 1 < argc) {
+            gerar = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--base") == 0 && i + 1 < argc) {
+            base = argv[++i];
+        } else if (strcmp(argv[i], "--tolerancia") == 0 && i + 1 < argc) {
+            tolerancia = atof(argv[++i]);
+        } else {
+            cerr << "opcao desconhecida: " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    if (gerar > 0) {
+        gerarEntrada(gerar, semente);
+        return 0;
+    }
+    if (n <= 0) {
+        cerr << "valor invalido para --n\n";
+        return 1;
+    }
+
+    Medicao medicoes[MAX_CASOS];
+    int qtd = executarCasos(n, medicoes);
+
+    bool regressao = false;
+    cout << "caso\toperacoes\tmin_ns\tmediana_ns";
+    if (base) cout << "\tbase_min_ns\trazao\tsituacao";
+    cout << "\n";
+
+    for (int i = 0; i < qtd; ++i) {
+        const Medicao& m = medicoes[i];
+        cout << m.caso << "\t" << m.operacoes << "\t" << m.minimoNs << "\t" << m.medianaNs;
+        if (base) {
+            double b = tempoBase(base, m);
+            if (b > 0.0) {
+                double razao = m.minimoNs / b;
+                bool pior = razao > 1.0 + tolerancia;
+                regressao = regressao || pior;
+                cout << "\t" << b << "\t" << razao << "\t" << (pior ? "REGRESSAO" : "ok");
+            } else {
+                cout << "\t-\t-\tsem_base";
+            }
+        }
+        cout << "\n";
+    }
+    return regressao ? 1 : 0;
+}
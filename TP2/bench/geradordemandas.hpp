@@ -0,0 +1,168 @@
+#ifndef GERADORDEMANDAS_HPP
+#define GERADORDEMANDAS_HPP
+
+#include <cmath>
+#include <numbers>
+#include <random>
+
+#include "demanda.hpp"
+
+// Gerador de demandas sintéticas para os benchmarks, determinístico para
+// uma semente:
+//  - chegadas de Poisson com taxa que varia ao longo do dia (processo não
+//    homogêneo, por rejeição): a taxa é taxaMedia vezes a curva diária,
+//    interpolada linearmente entre as faixas;
+//  - origens concentradas em pontos quentes (mistura de gaussianas com
+//    pesos), mais uma fração espalhada uniformemente pelo mapa;
+//  - destinos a uma distância log-normal da origem (mediana e dispersão
+//    configuráveis), na direção de um ponto quente sorteado.
+
+// Região de alta demanda
+struct PontoQuente {
+    double x;
+    double y;
+    double raio;    // desvio padrão em cada eixo
+    double peso;    // peso relativo no sorteio
+};
+
+struct ConfigGerador {
+    double taxaMedia;           // demandas por unidade de tempo, na média do dia
+    double duracaoDia;          // período da curva diária
+    const double* curvaTaxa;    // multiplicador da taxa em cada faixa do dia
+    int numFaixas;
+
+    const PontoQuente* pontos;
+    int numPontos;
+    double fracaoDispersa;      // fração das origens uniformes no mapa
+    double ladoMapa;            // mapa [0, ladoMapa]²
+
+    double comprimentoMediano;  // mediana da distância origem -> destino
+    double dispersaoComprimento; // desvio do log da distância
+};
+
+// Dia com picos de manhã e no fim da tarde (24 faixas, média 1: a
+// interpolação é circular, então a média do dia é a das faixas)
+static const double CURVA_DIA_UTIL[24] = {
+    0.2, 0.1, 0.1, 0.1, 0.2, 0.5, 1.1, 2.1, 2.2, 1.3, 1.0, 1.0,
+    1.1, 1.1, 1.0, 1.1, 1.4, 2.1, 2.2, 1.5, 1.0, 0.8, 0.5, 0.3
+};
+
+// Centro, dois bairros comerciais, aeroporto e rodoviária
+static const PontoQuente PONTOS_CIDADE[5] = {
+    {50.0, 50.0, 4.0, 4.0},
+    {30.0, 70.0, 3.0, 2.0},
+    {72.0, 35.0, 3.0, 2.0},
+    {90.0, 90.0, 1.5, 1.0},
+    {15.0, 20.0, 2.0, 1.0},
+};
+
+// Configuração padrão: um dia por 1440 unidades de tempo (minutos)
+inline ConfigGerador configCidade(double taxaMedia) {
+    ConfigGerador c;
+    c.taxaMedia = taxaMedia;
+    c.duracaoDia = 1440.0;
+    c.curvaTaxa = CURVA_DIA_UTIL;
+    c.numFaixas = 24;
+    c.pontos = PONTOS_CIDADE;
+    c.numPontos = 5;
+    c.fracaoDispersa = 0.2;
+    c.ladoMapa = 100.0;
+    c.comprimentoMediano = 8.0;
+    c.dispersaoComprimento = 0.6;
+    return c;
+}
+
+class GeradorDemandas {
+private:
+    ConfigGerador config;
+    std::mt19937_64 rng;
+    std::uniform_real_distribution<double> u01;
+    std::normal_distribution<double> normal;
+
+    double taxaMaxima;
+    double pesoTotal;
+    double tempo;
+    int proximoId;
+
+    // Multiplicador da taxa no instante t (interpolação linear, periódica)
+    double curva(double t) const {
+        double fase = std::fmod(t, config.duracaoDia) / config.duracaoDia * config.numFaixas;
+        int f = static_cast<int>(fase);
+        if (f >= config.numFaixas) f = config.numFaixas - 1;
+        double r = fase - f;
+        double a = config.curvaTaxa[f];
+        double b = config.curvaTaxa[(f + 1) % config.numFaixas];
+        return a + (b - a) * r;
+    }
+
+    const PontoQuente& sortearPonto() {
+        double alvo = u01(rng) * pesoTotal;
+        for (int i = 0; i < config.numPontos - 1; ++i) {
+            alvo -= config.pontos[i].peso;
+            if (alvo < 0.0) return config.pontos[i];
+        }
+        return config.pontos[config.numPontos - 1];
+    }
+
+    double limitar(double v) const {
+        if (v < 0.0) return 0.0;
+        if (v > config.ladoMapa) return config.ladoMapa;
+        return v;
+    }
+
+public:
+    GeradorDemandas(const ConfigGerador& config_, unsigned long long semente)
+        : config(config_), rng(semente), u01(0.0, 1.0), normal(0.0, 1.0),
+          taxaMaxima(0.0), pesoTotal(0.0), tempo(0.0), proximoId(0) {
+        for (int f = 0; f < config.numFaixas; ++f) {
+            if (config.curvaTaxa[f] > taxaMaxima) taxaMaxima = config.curvaTaxa[f];
+        }
+        taxaMaxima *= config.taxaMedia;
+        for (int i = 0; i < config.numPontos; ++i) {
+            pesoTotal += config.pontos[i].peso;
+        }
+    }
+
+    Demanda proxima() {
+        // chegada: candidatos à taxa máxima, aceitos com taxa(t) / taxaMaxima
+        do {
+            tempo += -std::log(1.0 - u01(rng)) / taxaMaxima;
+        } while (u01(rng) * taxaMaxima > config.taxaMedia * curva(tempo));
+
+        Ponto origem;
+        if (config.numPontos == 0 || u01(rng) < config.fracaoDispersa) {
+            origem.x = u01(rng) * config.ladoMapa;
+            origem.y = u01(rng) * config.ladoMapa;
+        } else {
+            const PontoQuente& p = sortearPonto();
+            origem.x = limitar(p.x + p.raio * normal(rng));
+            origem.y = limitar(p.y + p.raio * normal(rng));
+        }
+
+        // destino: distância log-normal, em direção a um ponto quente
+        double comprimento = config.comprimentoMediano *
+                             std::exp(config.dispersaoComprimento * normal(rng));
+        double angulo;
+        if (config.numPontos > 0) {
+            const PontoQuente& p = sortearPonto();
+            angulo = std::atan2(p.y - origem.y, p.x - origem.x) + 0.5 * normal(rng);
+        } else {
+            angulo = 2.0 * std::numbers::pi * u01(rng);
+        }
+        Ponto destino = {limitar(origem.x + comprimento * std::cos(angulo)),
+                         limitar(origem.y + comprimento * std::sin(angulo))};
+
+        return Demanda(proximoId++, tempo, origem, destino);
+    }
+
+    // Vetor com n demandas (alocado com new[])
+    Demanda* gerar(int n) {
+        Demanda* demandas = new Demanda[n];
+        for (int i = 0; i < n; ++i) {
+            demandas[i] = proxima();
+        }
+        return demandas;
+    }
+};
+
+#endif // GERADORDEMANDAS_HPP
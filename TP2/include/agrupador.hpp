@@ -0,0 +1,141 @@
+#ifndef AGRUPADOR_HPP
+#define AGRUPADOR_HPP
+
+#include "demanda.hpp"
+#include "colunasdemandas.hpp"
+#include "tabelademandas.hpp"
+#include "corrida.hpp"
+#include "parametros.hpp"
+#include "custorota.hpp"
+#include "compatibilidade.hpp"
+#include "poolthreads.hpp"
+#include "metricas.hpp"
+#include "redeviaria.hpp"
+
+// Distância euclidiana entre dois pontos do plano
+double distPontos(const Ponto& a, const Ponto& b);
+
+// Distância da rota compartilhada (origens na ordem, depois destinos na mesma ordem)
+double distanciaRota(const ColunasDemandas& demandas, const int* grupo, int tamGrupo);
+
+// Soma das distâncias individuais (origem -> destino) das demandas do grupo
+double distanciaIndividualTotal(const ColunasDemandas& demandas, const int* grupo, int tamGrupo);
+
+// Faixa ocupada por um conjunto de pontos: mínimo e máximo em cada eixo.
+// Se a coordenada de um candidato dista mais que o limite de algum extremo,
+// o candidato certamente está além do limite do ponto que realiza esse extremo
+// (|dx| <= sqrt(dx² + dy²)), sem precisar calcular nenhuma raiz.
+struct Faixa {
+    double minX;
+    double maxX;
+    double minY;
+    double maxY;
+
+    void iniciar(const Ponto& p);
+    void expandir(const Ponto& p);
+    bool excede(const Ponto& p, double limite) const;
+};
+
+// Algoritmo guloso de agrupamento baseado nas restrições (δ, α, β, λ, η).
+//
+// O grupo semeado por c0 recebe as demandas seguintes enquanto todas forem
+// admitidas, e a primeira recusada encerra o grupo. Assim, cada grupo é um
+// bloco contíguo [i, i + tamGrupo) das demandas ordenadas por tempo, e a
+// próxima semente é sempre a primeira demanda depois do bloco.
+//
+// Por isso cada demanda é candidata uma única vez (ou entra, ou vira a
+// semente seguinte), e cada par (membro, candidato) passa por α e β no
+// máximo uma vez: não há trabalho a reaproveitar entre sementes, e uma
+// matriz de compatibilidade da janela δ custaria o tamanho da janela por
+// demanda, contra no máximo η - 1 membros no teste sob demanda.
+//
+// Com uma RedeViaria, α, β e λ usam as distâncias pela malha, consultadas
+// por uma ConsultaViaria própria, e cada demanda aceita tem os trechos da
+// rota gravados na rede (ver redeviaria.hpp).
+class Agrupador {
+private:
+    ColunasDemandas demandas; // todas as demandas, em ordem de solicitação
+    const int* ids;           // id de cada demanda destas colunas, para o rastro
+    Parametros params;
+
+    int* grupo;            // índices do grupo em formação (capacidade η)
+    int tamGrupo;
+
+    Faixa faixaOrigens;    // faixas ocupadas pelas origens e destinos do grupo
+    Faixa faixaDestinos;
+
+    MembrosGrupo membros;  // origens e destinos do grupo, em colunas
+    LimiteQuadrado limiteAlfa;
+    LimiteQuadrado limiteBeta;
+
+    CustoRota custo;       // distâncias da rota e individuais do grupo, incrementais
+
+    ContadoresAgrupamento contadores;  // ver metricas.hpp (o histograma fica vazio)
+
+    // modo viário (rede nullptr no euclidiano); a demanda i destas colunas é
+    // a demanda deslocamento + i da rede
+    RedeViaria* rede;
+    int deslocamento;
+    ConsultaViaria* consulta;
+    double cadeiaOrigens;  // rota do grupo pela malha: origens em ordem,
+    double ligacao;        // última origem -> primeiro destino
+    double cadeiaDestinos; // e destinos em ordem
+    double somaIndividual;
+
+    // Restrições espaciais α e β de cj contra todos os membros do grupo:
+    // RECUSA_ALFA, RECUSA_BETA ou RECUSA_NENHUMA
+    MotivoRecusa verificarDistancias(const Ponto& origem, const Ponto& destino);
+
+    // Conta a recusa de cj, que encerra o grupo (e a grava no rastro, com
+    // os ids da semente e de cj); retorna false
+    bool recusar(MotivoRecusa motivo, int j);
+
+    // tentarAdicionar depois de δ e η, no modo viário
+    bool tentarAdicionarViario(int j);
+    int noOrigem(int i) const;
+    int noDestino(int i) const;
+
+public:
+    // ids_ acompanha demandas_ (posição i = demanda i); sem ele, o rastro
+    // grava as posições deslocamento + i no lugar dos ids
+    Agrupador(const ColunasDemandas& demandas_, const Parametros& params_,
+              RedeViaria* rede_ = nullptr, int deslocamento_ = 0,
+              const int* ids_ = nullptr);
+    ~Agrupador();
+
+    // Forma o grupo semeado pela demanda i e retorna a próxima semente
+    int formarGrupo(int i);
+
+    // Passos de formarGrupo, para quem recebe as demandas aos poucos:
+    // começa o grupo na semente i e tenta incluir a demanda j (false encerra o grupo)
+    void iniciarGrupo(int i);
+    bool tentarAdicionar(int j);
+
+    int getTamGrupo() const;
+    const int* getGrupo() const;
+    const ContadoresAgrupamento& getContadores() const;
+    const ConsultaViaria* getConsulta() const;  // nullptr no modo euclidiano
+};
+
+// Cria a Corrida do grupo demandas[inicio, fim), já com rota e trechos calculados
+Corrida* montarCorrida(TabelaDemandas& demandas, int inicio, int fim);
+
+// Agrupa todas as demandas e devolve os limites dos grupos na ordem do
+// agrupamento sequencial: o grupo g é demandas[limites[g], limites[g + 1]).
+// O vetor tem qtdGrupos + 1 posições e é alocado com new[].
+//
+// Nenhum grupo atravessa um intervalo de pelo menos δ entre uma solicitação e
+// todas as anteriores, então a sequência é cortada nesses pontos em blocos
+// independentes. Com um pool, os blocos são agrupados em paralelo e seus
+// grupos concatenados em ordem; sem pool (nullptr), tudo roda em um bloco só.
+// Se contadores não for nullptr, os contadores de todos os blocos e o
+// histograma de tamanhos dos grupos são somados a ele. Com uma RedeViaria
+// (das mesmas demandas), o agrupamento é o do modo viário, os trechos das
+// rotas ficam gravados nela e as estatísticas das consultas são somadas.
+// ids são os das demandas (ver TabelaDemandas::getIds), gravados no rastro.
+int* agruparDemandas(const ColunasDemandas& demandas, const Parametros& params,
+                     PoolThreads* pool, int& qtdGrupos,
+                     ContadoresAgrupamento* contadores = nullptr,
+                     RedeViaria* rede = nullptr, const int* ids = nullptr);
+
+#endif // AGRUPADOR_HPP
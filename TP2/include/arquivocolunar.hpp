@@ -0,0 +1,53 @@
+#ifndef ARQUIVOCOLUNAR_HPP
+#define ARQUIVOCOLUNAR_HPP
+
+#include <cstddef>
+
+#include "colunasdemandas.hpp"
+#include "tabelademandas.hpp"
+#include "parametros.hpp"
+
+// Arquivo binário de demandas em colunas, lido sem conversão.
+//
+// Formato (versão 1, na ordem de bytes da máquina que gravou):
+//   - cabeçalho de 128 bytes: assinatura "TP2COLS\0", versão (uint32),
+//     η (int32), γ, δ, α, β, λ (double), número de demandas (int64) e o
+//     deslocamento de cada coluna a partir do início do arquivo (int64);
+//   - as colunas, cada uma começando em um múltiplo de 64 bytes:
+//     ids (int32), tempos, origem x, origem y, destino x, destino y (double).
+//
+// O arquivo é mapeado na memória e as colunas são usadas no lugar, então
+// abrir custa o mesmo para qualquer tamanho e as páginas só são lidas do
+// disco quando o agrupamento chega a elas. Um arquivo gravado em uma máquina
+// de outra ordem de bytes é recusado pela versão.
+class ArquivoColunar {
+private:
+    void* mapa;
+    std::size_t tamanho;
+    Parametros params;
+    ColunasDemandas colunas;
+    const int* ids;
+
+public:
+    ArquivoColunar();
+    ~ArquivoColunar();
+
+    ArquivoColunar(const ArquivoColunar&) = delete;
+    ArquivoColunar& operator=(const ArquivoColunar&) = delete;
+
+    // Mapeia o arquivo e confere o cabeçalho. Retorna false (após escrever
+    // o erro em std::cerr) se o arquivo não existir ou não estiver no formato.
+    bool abrir(const char* caminho);
+
+    const Parametros& getParametros() const;
+    const ColunasDemandas& getColunas() const;
+    const int* getIds() const;
+};
+
+// Grava os parâmetros e as demandas (colunas quentes e ids) no formato acima.
+// Retorna false (após escrever o erro em std::cerr) se o arquivo não puder
+// ser escrito.
+bool gravarArquivoColunar(const char* caminho, const Parametros& params,
+                          const TabelaDemandas& demandas);
+
+#endif // ARQUIVOCOLUNAR_HPP
@@ -0,0 +1,62 @@
+#ifndef BUSCABIDIRECIONAL_HPP
+#define BUSCABIDIRECIONAL_HPP
+
+#include "grafoviario.hpp"
+#include "minheap.hpp"
+#include <limits>
+
+static const double INFINITO_BUSCA = std::numeric_limits<double>::infinity();
+
+// Menor caminho entre dois nós da malha por Dijkstra bidirecional: uma busca
+// sai da origem pelos arcos de saída e outra sai do destino pelos arcos de
+// entrada, alternando pelo lado de menor chave, até que a soma das menores
+// chaves das duas filas alcance o melhor caminho já encontrado.
+//
+// As chaves somam a cada distância um potencial tirado da reta até as pontas
+// (vezes o fatorReta da malha, que nunca passa do caminho), o que puxa as
+// duas buscas uma para a outra em vez de crescerem em círculos. Numa malha
+// com fatorReta zero, o potencial é nulo e a busca é o Dijkstra comum.
+//
+// Os vetores de distâncias têm um valor por nó e são reaproveitados entre
+// consultas: só os nós tocados na anterior são reinicializados. Cada thread
+// usa a sua busca.
+class BuscaBidirecional {
+private:
+    const GrafoViario& grafo;
+
+    double* distIda;       // distância desde a origem (infinito se não tocado)
+    double* distVolta;     // distância até o destino
+    int* tocadosIda;       // nós com distância finita em cada lado
+    int* tocadosVolta;
+    int qtdTocadosIda;
+    int qtdTocadosVolta;
+
+    MinHeap filaIda;       // (distância, nó), com entradas antigas descartadas ao sair
+    MinHeap filaVolta;
+
+    long long nosFixados;  // nós retirados das filas desde a construção
+
+    double fatorReta;
+    Ponto pontoOrigem;     // pontas da consulta atual
+    Ponto pontoDestino;
+
+    void reiniciar();
+    double potencial(int v) const;
+
+public:
+    explicit BuscaBidirecional(const GrafoViario& grafo_);
+    ~BuscaBidirecional();
+
+    BuscaBidirecional(const BuscaBidirecional&) = delete;
+    BuscaBidirecional& operator=(const BuscaBidirecional&) = delete;
+
+    // Comprimento do menor caminho origem -> destino (infinito se não houver).
+    // Com um limite, a busca para assim que o caminho certamente passa dele:
+    // o valor devolvido é exato se não passar do limite e, se passar, é
+    // apenas algum valor acima do limite.
+    double distancia(int origem, int destino, double limite = INFINITO_BUSCA);
+
+    long long getNosFixados() const;
+};
+
+#endif // BUSCABIDIRECIONAL_HPP
@@ -0,0 +1,35 @@
+#ifndef COLUNASDEMANDAS_HPP
+#define COLUNASDEMANDAS_HPP
+
+#include "demanda.hpp"
+
+// Campos quentes das demandas em colunas: um vetor por campo, todos com
+// numDemandas posições, em ordem de solicitação. O agrupamento e a simulação
+// analítica só leem tempos e coordenadas, que assim ficam contíguos na memória.
+//
+// É só uma visão, não é dona dos vetores: eles podem estar em uma
+// TabelaDemandas (entrada em texto) ou direto no arquivo binário mapeado
+// (ver ArquivoColunar). Copiar a visão não copia as demandas.
+struct ColunasDemandas {
+    int numDemandas;
+    const double* tempos;
+    const double* origemX;
+    const double* origemY;
+    const double* destinoX;
+    const double* destinoY;
+
+    // Modo viário: distância pela malha do trecho que chega à origem e ao
+    // destino de cada demanda na rota do seu grupo (ver RedeViaria).
+    // nullptr quando as distâncias são euclidianas.
+    const double* trechosEmbarque;
+    const double* trechosDesembarque;
+
+    double tempo(int i) const { return tempos[i]; }
+    Ponto origem(int i) const { return Ponto{origemX[i], origemY[i]}; }
+    Ponto destino(int i) const { return Ponto{destinoX[i], destinoY[i]}; }
+
+    // Visão das demandas [inicio, inicio + qtd), reindexadas a partir de 0
+    ColunasDemandas trecho(int inicio, int qtd) const;
+};
+
+#endif // COLUNASDEMANDAS_HPP
@@ -0,0 +1,67 @@
+#ifndef COMPATIBILIDADE_HPP
+#define COMPATIBILIDADE_HPP
+
+#include "demanda.hpp"
+#include "metricas.hpp"
+
+// Restrições α e β de um candidato contra todos os membros do grupo, sem
+// raízes: as distâncias ao quadrado são comparadas com α² e β², quatro
+// membros por vez com AVX2 (se o processador tiver) ou um a um.
+
+// Limite de distância decidido pela distância ao quadrado.
+// Como limite² é arredondado, d² perto dele não decide sozinho se
+// sqrt(d²) > limite; fora de uma faixa de largura relativa 2^-40 em torno de
+// limite² a decisão é certa, e dentro dela a raiz é calculada. Assim o
+// resultado é sempre o mesmo de distPontos(...) > limite.
+struct LimiteQuadrado {
+    double limite;
+    double aceita;    // d² <= aceita: a distância não passa do limite
+    double recusa;    // d² >= recusa: a distância passa do limite
+
+    void definir(double limite_);
+
+    // Mesmo resultado de sqrt(d2) > limite; soma 1 a raizes se precisar dela
+    bool excede(double d2, long long& raizes) const;
+};
+
+// Origens e destinos dos membros do grupo em colunas, com capacidade
+// arredondada para múltiplo de 4 (as posições extras valem zero)
+class MembrosGrupo {
+private:
+    double* memoria;
+    int capacidade;
+
+public:
+    double* origemX;
+    double* origemY;
+    double* destinoX;
+    double* destinoY;
+
+    explicit MembrosGrupo(int capacidadeMinima);
+    ~MembrosGrupo();
+
+    MembrosGrupo(const MembrosGrupo&) = delete;
+    MembrosGrupo& operator=(const MembrosGrupo&) = delete;
+
+    void definir(int k, const Ponto& origem, const Ponto& destino);
+};
+
+// Primeiro membro, na ordem do grupo, cuja origem está a mais de α ou cujo
+// destino está a mais de β do candidato: RECUSA_ALFA ou RECUSA_BETA (α é
+// verificada antes de β no mesmo membro), ou RECUSA_NENHUMA. As raízes
+// calculadas na faixa duvidosa são somadas a raizes.
+MotivoRecusa verificarMembros(const MembrosGrupo& membros, int qtdMembros,
+                              const Ponto& origem, const Ponto& destino,
+                              const LimiteQuadrado& alfa, const LimiteQuadrado& beta,
+                              long long& raizes);
+
+// Versão sem SIMD, usada quando o processador não tem AVX2
+MotivoRecusa verificarMembrosEscalar(const MembrosGrupo& membros, int qtdMembros,
+                                     const Ponto& origem, const Ponto& destino,
+                                     const LimiteQuadrado& alfa, const LimiteQuadrado& beta,
+                                     long long& raizes);
+
+// Nome da versão escolhida por verificarMembros ("avx2" ou "escalar")
+const char* implementacaoCompatibilidade();
+
+#endif // COMPATIBILIDADE_HPP
@@ -1,37 +1,68 @@
 #ifndef CORRIDA_HPP
 #define CORRIDA_HPP
 
-#include "demanda.hpp"
+#include "tabelademandas.hpp"
 #include "parada.hpp"
 #include "trecho.hpp"
 #include <iosfwd> // std::ostream
 
+// As demandas são índices em uma TabelaDemandas, de onde vêm as coordenadas
+// e onde ficam o estado e a corrida de cada uma.
+//
+// Paradas e trechos ficam em vetores contíguos de objetos, não de ponteiros.
+// Para grupos de até CAPACIDADE_INTERNA demandas, os três vetores ficam dentro
+// do próprio objeto e a corrida inteira custa uma única alocação; grupos
+// maiores usam um único bloco externo para os três vetores.
 class Corrida {
+public:
+    static const int CAPACIDADE_INTERNA = 4;
+
 private:
-    Demanda** demandas;
+    TabelaDemandas* tabela;
+    int* demandas;            // índices na tabela
     int qtdDemandas;
-    int capacidadeDemandas;
+    int capacidadeDemandas;   // paradas e trechos têm capacidade 2x esta
 
-    Parada** paradas;
+    Parada* paradas;
     int qtdParadas;
-    int capacidadeParadas;
 
-    Trecho** trechos;
+    Trecho* trechos;
     int qtdTrechos;
-    int capacidadeTrechos;
 
     double distanciaTotal;
     double tempoInicio;
     double tempoFim;
 
+    char* blocoExterno;       // vetores fora do objeto (nullptr se internos)
+    bool donaDaTabela;        // a tabela é liberada junto com a corrida
+
+    double instanteEntrada;   // relógio de parede em que o grupo ficou completo
+    int veiculo;              // veículo da frota que a atende (-1 sem frota)
+
+    int demandasInternas[CAPACIDADE_INTERNA];
+    Parada paradasInternas[2 * CAPACIDADE_INTERNA];
+    Trecho trechosInternos[2 * CAPACIDADE_INTERNA];
+
+    // Aponta os três vetores para um bloco externo com a capacidade dada
+    void alocarBloco(int capacidade);
+
 public:
-    explicit Corrida(int capacidadeInicialDemandas);
+    Corrida(TabelaDemandas* tabela_, int capacidadeInicialDemandas);
     ~Corrida();
 
-    void adicionarDemanda(Demanda* d);
+    Corrida(const Corrida&) = delete;             // os vetores podem apontar
+    Corrida& operator=(const Corrida&) = delete;  // para dentro do objeto
 
+    // Adiciona a demanda de índice `indice` na tabela
+    void adicionarDemanda(int indice);
+
+    // Passa a ser dona da tabela (alocada com new) e a libera junto com a
+    // corrida; usado quando a tabela só tem as demandas desta corrida
+    void assumirTabela();
+
+    TabelaDemandas* getTabela() const;
     int getQtdDemandas() const;
-    Demanda* getDemanda(int idx) const;
+    int getDemanda(int idx) const;   // índice na tabela (-1 se idx for inválido)
 
     // Rota básica: origens na ordem, depois destinos na mesma ordem
     void construirRotaBasica();
@@ -45,6 +76,15 @@ public:
     double getTempoInicio() const;
     double getTempoFim() const;
 
+    // Instante (relógio de parede, em segundos) em que a última demanda do
+    // grupo foi lida; usado para medir a latência entre entrada e saída
+    void setInstanteEntrada(double t);
+    double getInstanteEntrada() const;
+
+    // Modo frota (ver Frota)
+    void setVeiculo(int v);
+    int getVeiculo() const;
+
     // Acesso à estrutura da corrida
     double getDistanciaTotal() const;
     int getNumeroParadas() const;
@@ -53,6 +93,13 @@ public:
 
     // Impressão da linha de saída
     void imprimirSaida(std::ostream& out) const;
+
+    // A mesma linha, escrita diretamente a partir de p sem std::ostream
+    // (ver formatacao.hpp). tamanhoMaximoSaida() limita o que é escrito.
+    // Retorna o fim da linha, ou nullptr se algum valor precisar do
+    // formatador geral; nesse caso usar imprimirSaida.
+    int tamanhoMaximoSaida() const;
+    char* formatarSaida(char* p) const;
 };
 
 #endif // CORRIDA_HPP
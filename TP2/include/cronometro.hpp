@@ -0,0 +1,12 @@
+#ifndef CRONOMETRO_HPP
+#define CRONOMETRO_HPP
+
+#include <chrono>
+
+// Relógio de parede monotônico, em segundos, para medir durações
+inline double instanteAtual() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // CRONOMETRO_HPP
@@ -0,0 +1,56 @@
+#ifndef CUSTOROTA_HPP
+#define CUSTOROTA_HPP
+
+#include "demanda.hpp"
+
+// Custo incremental da rota compartilhada de um grupo em formação.
+//
+// A rota é o0 -> o1 -> ... -> ok -> d0 -> d1 -> ... -> dk. Mantendo o comprimento
+// da cadeia de origens, o da cadeia de destinos e a soma das distâncias
+// individuais, a rota de "grupo + cj" custa três trechos novos e uma distância
+// individual, em O(1), sem percorrer o grupo.
+class CustoRota {
+private:
+    Ponto ultimaOrigem;       // ok
+    Ponto primeiroDestino;    // d0
+    Ponto ultimoDestino;      // dk
+
+    double cadeiaOrigens;     // o0 -> ... -> ok
+    double cadeiaDestinos;    // d0 -> ... -> dk
+    double somaIndividual;    // soma das distâncias oi -> di
+
+    // Candidato avaliado por avaliar(), pendente de confirmar()
+    Ponto candOrigem;
+    Ponto candDestino;
+    double candCadeiaOrigens;
+    double candCadeiaDestinos;
+    double candIndividual;
+
+public:
+    CustoRota();
+
+    // Reinicia o custo com o grupo formado apenas pela semente
+    void iniciar(const Ponto& origem, const Ponto& destino);
+
+    // Limite sem raízes: verdadeiro se a eficiência de "grupo + cj" certamente
+    // não passa de λ. Usa |dx| + |dy| como teto das distâncias individuais e
+    // max(|dx|, |dy|) como piso dos trechos da rota.
+    bool descartaPorLimite(const Ponto& origem, const Ponto& destino, double lambda) const;
+
+    // Eficiência (soma individual / rota) do grupo com o candidato incluído.
+    // O candidato fica pendente até confirmar(); descartá-lo não custa nada.
+    double avaliar(const Ponto& origem, const Ponto& destino);
+
+    // Incorpora ao grupo o último candidato avaliado
+    void confirmar();
+
+    // A rota é somada aqui em outra ordem que em distanciaRota, então a
+    // eficiência pode diferir no último bit. Perto de λ a decisão é refeita
+    // com a soma completa para manter os mesmos grupos.
+    static bool ambigua(double eficiencia, double lambda);
+
+    double getDistanciaRota() const;
+    double getDistanciaIndividual() const;
+};
+
+#endif // CUSTOROTA_HPP
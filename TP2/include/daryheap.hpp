@@ -0,0 +1,195 @@
+#ifndef DARYHEAP_HPP
+#define DARYHEAP_HPP
+
+#include <functional>
+#include <new>
+#include <utility>
+
+// Heap d-ário genérico de pares (chave, valor), mínimo segundo Compare.
+//
+// Em relação ao MinHeap binário:
+//  - chave e valor ficam juntos em um único vetor, então cada troca move um
+//    item só, e o valor (por exemplo um evento inteiro) é guardado no próprio
+//    heap, sem vetor auxiliar;
+//  - cada nó tem Arity filhos contíguos: a árvore é mais baixa e os filhos
+//    comparados em descer() ficam lado a lado na memória. O vetor é alinhado
+//    a 64 bytes e deslocado de forma que cada grupo de irmãos comece em um
+//    múltiplo de Arity itens; se Arity * sizeof(item) for múltiplo de 64,
+//    cada grupo ocupa linhas de cache inteiras;
+//  - o crescimento move os itens para o novo vetor em vez de copiá-los;
+//  - acrescentar() + heapificar() montam o heap de n itens em O(n).
+// Com Arity 2, subir() e descer() escolhem as mesmas posições que o MinHeap
+// (o filho da esquerda no empate, e só descem ou sobem com desigualdade
+// estrita), então chaves iguais saem na mesma ordem que sairiam dele.
+template <typename Key, typename Value, int Arity = 4, typename Compare = std::less<Key>>
+class DaryHeap {
+    static_assert(Arity >= 2, "DaryHeap precisa de pelo menos 2 filhos por nó");
+
+private:
+    struct Item {
+        Key chave;
+        Value valor;
+    };
+
+    static const std::size_t ALINHAMENTO = 64;
+    static const int DESLOCAMENTO = Arity - 1;   // itens vazios antes da raiz
+
+    void* memoria;      // bloco alinhado (inclui o deslocamento)
+    Item* itens;        // itens[0] é a raiz
+    int tamanho;
+    int capacidade;
+    Compare comp;
+
+    static int pai(int i) { return (i - 1) / Arity; }
+    static int primeiroFilho(int i) { return Arity * i + 1; }
+
+    // Troca o bloco de memória por um de novaCap itens, movendo os atuais
+    void realocar(int novaCap) {
+        std::size_t bytes = sizeof(Item) * static_cast<std::size_t>(novaCap + DESLOCAMENTO);
+        void* novaMemoria = ::operator new(bytes, std::align_val_t(ALINHAMENTO));
+        Item* novos = static_cast<Item*>(novaMemoria) + DESLOCAMENTO;
+
+        for (int i = 0; i < tamanho; ++i) {
+            new (&novos[i]) Item(std::move(itens[i]));
+            itens[i].~Item();
+        }
+        liberarMemoria();
+
+        memoria = novaMemoria;
+        itens = novos;
+        capacidade = novaCap;
+    }
+
+    void liberarMemoria() {
+        if (memoria) {
+            ::operator delete(memoria, std::align_val_t(ALINHAMENTO));
+        }
+    }
+
+    void garantirEspaco() {
+        if (tamanho == capacidade) {
+            realocar(capacidade == 0 ? 16 : capacidade * 2);
+        }
+    }
+
+    // Sobe o item da posição i abrindo um "buraco" em vez de trocar a cada nível
+    void subir(int i) {
+        Item x(std::move(itens[i]));
+        while (i > 0) {
+            int p = pai(i);
+            if (!comp(x.chave, itens[p].chave)) break;
+            itens[i] = std::move(itens[p]);
+            i = p;
+        }
+        itens[i] = std::move(x);
+    }
+
+    // Desce o item da posição i até que nenhum filho seja menor que ele
+    void descer(int i) {
+        Item x(std::move(itens[i]));
+        while (true) {
+            int f = primeiroFilho(i);
+            if (f >= tamanho) break;
+
+            int ultimo = f + Arity;
+            if (ultimo > tamanho) ultimo = tamanho;
+
+            int menor = f;
+            for (int k = f + 1; k < ultimo; ++k) {
+                if (comp(itens[k].chave, itens[menor].chave)) menor = k;
+            }
+            if (!comp(itens[menor].chave, x.chave)) break;
+
+            itens[i] = std::move(itens[menor]);
+            i = menor;
+        }
+        itens[i] = std::move(x);
+    }
+
+public:
+    DaryHeap() : memoria(nullptr), itens(nullptr), tamanho(0), capacidade(0) {}
+
+    explicit DaryHeap(int capacidadeInicial)
+        : memoria(nullptr), itens(nullptr), tamanho(0), capacidade(0) {
+        if (capacidadeInicial > 0) {
+            realocar(capacidadeInicial);
+        }
+    }
+
+    ~DaryHeap() {
+        limpar();
+        liberarMemoria();
+    }
+
+    DaryHeap(const DaryHeap&) = delete;
+    DaryHeap& operator=(const DaryHeap&) = delete;
+
+    bool vazio() const { return tamanho == 0; }
+    int getTamanho() const { return tamanho; }
+    int getCapacidade() const { return capacidade; }
+
+    // Garante espaço para pelo menos cap itens sem nova realocação
+    void reservar(int cap) {
+        if (cap > capacidade) realocar(cap);
+    }
+
+    void inserir(const Key& chave, const Value& valor) {
+        garantirEspaco();
+        new (&itens[tamanho]) Item{chave, valor};
+        subir(tamanho++);
+    }
+
+    // Acrescenta no fim sem restaurar a ordem; chamar heapificar() depois
+    void acrescentar(const Key& chave, const Value& valor) {
+        garantirEspaco();
+        new (&itens[tamanho++]) Item{chave, valor};
+    }
+
+    // Restaura a propriedade de heap em O(n), descendo os nós internos
+    // do último ao primeiro
+    void heapificar() {
+        if (tamanho < 2) return;
+        for (int i = pai(tamanho - 1); i >= 0; --i) {
+            descer(i);
+        }
+    }
+
+    bool obterMinimo(Key& chave, Value& valor) const {
+        if (tamanho == 0) return false;
+        chave = itens[0].chave;
+        valor = itens[0].valor;
+        return true;
+    }
+
+    bool removerMinimo(Key& chave, Value& valor) {
+        if (tamanho == 0) return false;
+
+        chave = std::move(itens[0].chave);
+        valor = std::move(itens[0].valor);
+
+        --tamanho;
+        if (tamanho > 0) {
+            itens[0] = std::move(itens[tamanho]);
+            itens[tamanho].~Item();
+            descer(0);
+        } else {
+            itens[0].~Item();
+        }
+        return true;
+    }
+
+    // Item da posição i do vetor (0 é a raiz). Copiados em ordem e
+    // devolvidos com acrescentar(), sem heapificar(), refazem o mesmo heap.
+    const Key& getChave(int i) const { return itens[i].chave; }
+    const Value& getValor(int i) const { return itens[i].valor; }
+
+    // Remove todos os itens mantendo a capacidade
+    void limpar() {
+        for (int i = 0; i < tamanho; ++i) {
+            itens[i].~Item();
+        }
+        tamanho = 0;
+    }
+};
+
+#endif // DARYHEAP_HPP
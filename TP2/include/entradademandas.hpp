@@ -0,0 +1,31 @@
+#ifndef ENTRADADEMANDAS_HPP
+#define ENTRADADEMANDAS_HPP
+
+#include <iosfwd>
+
+#include "demanda.hpp"
+
+// Demandas entregues uma a uma, em ordem de solicitação, para quem agrupa
+// enquanto lê (ver FonteContinua).
+class EntradaDemandas {
+public:
+    virtual ~EntradaDemandas() {}
+
+    // Próxima demanda; false quando a entrada acaba
+    virtual bool ler(int& id, double& tempo, Ponto& origem, Ponto& destino) = 0;
+};
+
+// Linhas "id tempo ox oy dx dy" de um istream (o cabeçalho já foi lido),
+// até o número de demandas anunciado ou o fim da entrada
+class EntradaTexto : public EntradaDemandas {
+private:
+    std::istream& entrada;
+    int restantes;
+
+public:
+    EntradaTexto(std::istream& entrada_, int numDemandas);
+
+    bool ler(int& id, double& tempo, Ponto& origem, Ponto& destino) override;
+};
+
+#endif // ENTRADADEMANDAS_HPP
@@ -1,44 +1,118 @@
 #ifndef ESCALONADOR_HPP
 #define ESCALONADOR_HPP
 
-#include "minheap.hpp"
+#include "filaeventos.hpp"
+#include "fontecorridas.hpp"
+#include "observadorcorridas.hpp"
+#include "saidaassincrona.hpp"
+#include "metricas.hpp"
 #include "corrida.hpp"
 
-// Tipos de evento da simulação
-enum TipoEvento {
-    EVENTO_PARADA = 0
-    // Poderíamos ter EVENTO_FIM, mas o último EVENTO_PARADA já é o fim.
-};
-
-struct Evento {
-    double tempo;
-    TipoEvento tipo;
-    Corrida* corrida;
-    int indiceParada; // índice da parada na corrida
-};
+class PontoControle;
+class Frota;
+class QualidadeServico;
+class AgendaCorrotinas;
+struct TarefaCorrida;
 
+// Simulador de eventos discretos das corridas.
+// O Escalonador é dono das corridas que recebe: cada uma é liberada assim
+// que sua última parada é processada e impressa, e cada corrida em andamento
+// tem exatamente um evento pendente. Quando os inícios são agendados antes
+// (ver simularEImprimir), a fila guarda também um EVENTO_INICIO de poucos
+// bytes por grupo ainda não iniciado, e a memória ocupada é proporcional a
+// esses grupos mais as corridas em andamento; senão, só às corridas.
 class Escalonador {
 private:
-    MinHeap heap;      // min-heap de eventos (chave = tempo, valor = índice em eventos[])
-    Evento* eventos;
-    int qtdEventos;
-    int capacidadeEventos;
-
-    Corrida** corridas;   // só para gerenciar memória das corridas
-    int qtdCorridas;
-    int capacidadeCorridas;
+    FilaEventos* fila;    // eventos pendentes, em ordem de tempo
 
     double relogio;
     double gama;          // velocidade (mesma para todos os veículos)
 
-    int adicionarEvento(const Evento& e); // retorna índice do evento no array
+    ObservadorCorridas* observador;  // opcional (nullptr se nenhum)
+    SaidaAssincrona* saida;          // se definida, as linhas são formatadas nela
+    std::ostream* destino;           // onde as linhas são escritas (nullptr: em lugar nenhum)
+
+    ContadoresFila contadoresFila;   // sempre contados (ver metricas.hpp)
+    long long pendentes;             // eventos na fila, para o tamanho máximo
+    Metricas* metricas;              // se definida, recebe contadores e tempos
+
+    PontoControle* pontoControle;    // se definido, grava o estado periodicamente
+    long long intervaloControle;     // corridas finalizadas entre gravações
+    long long corridasFinalizadas;
+    long long proximoControle;       // gravar quando corridasFinalizadas chegar aqui
+
+    Frota* frota;                    // se definida, as corridas disputam os veículos
+    QualidadeServico* qualidade;     // se definida, recebe cada corrida finalizada
+
+    void adicionarEvento(const Evento& e);
+    void processarEvento(const Evento& ev);
+    void finalizarCorrida(Corrida* c);
+    bool agendarInicios(FonteCorridas* fonte);
+    Corrida* criarCorrida(FonteCorridas* fonte, int g);
+    void imprimirCorrida(const Corrida* c);
+    void gravarPontoControle();
+    Evento eventoInicial(Corrida* corrida) const;
+    void atenderPedido(Corrida* c);
+    void liberarVeiculo(int v);
+    void atribuirVeiculo(Corrida* c, int v);
+    TarefaCorrida executarCorrida(AgendaCorrotinas& agenda, Corrida* c);
 
 public:
-    Escalonador(int capacidadeInicialCorridas, double gama_);
+    Escalonador(int capacidadeInicialEventos, double gama_, TipoFila tipoFila = FILA_HEAP);
     ~Escalonador();
 
+    void setObservador(ObservadorCorridas* obs);
+
+    // Escreve as linhas das corridas direto nos blocos da saída assíncrona
+    // (que deve ser o streambuf de std::cout), sem passar pelo ostream
+    void setSaida(SaidaAssincrona* saida_);
+
+    // Escreve as linhas em destino_ em vez de std::cout; com nullptr, nada é
+    // impresso, e quem precisar das linhas as formata pelo observador
+    void setDestino(std::ostream* destino_);
+
+    // Ao fim de simularEImprimir, copia os contadores da fila e soma os tempos
+    // de montagem das corridas, impressão e o restante da simulação
+    void setMetricas(Metricas* metricas_);
+
+    // A cada `intervalo` corridas finalizadas, simularEImprimir grava o
+    // estado (eventos pendentes, relógio e contadores) entre dois eventos
+    void setPontoControle(PontoControle* pontoControle_, long long intervalo);
+
+    // Continua de um ponto de controle: devolve à fila os eventos copiados
+    // dela (ver FilaEventos::copiarPendentes), o que refaz os mesmos
+    // desempates, e recupera relógio e contadores. Assume a posse das
+    // corridas dos eventos; os inícios (EVENTO_INICIO) são grupos da fonte
+    // passada a simularEImprimir.
+    void restaurar(const Evento* eventos, int qtd, double relogio_,
+                   const ContadoresFila& contadores);
+
+    // Modo frota: cada corrida começa com um pedido de veículo, e o
+    // primeiro embarque é agendado quando o veículo chega até ele. Os
+    // empates saem por ordem de chegada com qualquer fila, então pedidos
+    // simultâneos são atendidos na ordem dos pedidos
+    void setFrota(Frota* frota_);
+
+    // Registra espera, desvio, ocupação e duração de cada corrida finalizada
+    void setQualidade(QualidadeServico* qualidade_);
+
     void adicionarCorrida(Corrida* corrida);
-    void simularEImprimir();
+    void adicionarCorridas(Corrida** novas, int qtd); // agenda todas de uma vez
+
+    // Processa todos os eventos em ordem de tempo. Se houver fonte, suas
+    // corridas são construídas só quando o relógio chega a elas. Com a fila
+    // heap e uma fonte que conhece os grupos de antemão, os inícios de todos
+    // são agendados antes, como no simulador original, e os empates saem na
+    // mesma ordem que saíam nele. Senão, e sempre com frota, cada corrida é
+    // iniciada quando o relógio chega a ela, antes de um evento já agendado
+    // no mesmo instante, como se tivesse sido agendada primeiro, e os demais
+    // empates saem por ordem de chegada.
+    void simularEImprimir(FonteCorridas* fonte = nullptr);
+
+    // A mesma simulação, com cada corrida da fonte como uma corrotina que
+    // espera a chegada a cada parada (ver motorcorrotinas.hpp). Usa agenda
+    // própria no lugar da fila de eventos; não tem frota nem ponto de controle.
+    void simularCorrotinas(FonteCorridas* fonte);
 };
 
 #endif // ESCALONADOR_HPP
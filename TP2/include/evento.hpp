@@ -0,0 +1,27 @@
+#ifndef EVENTO_HPP
+#define EVENTO_HPP
+
+class Corrida;
+
+// Tipos de evento da simulação
+enum TipoEvento {
+    EVENTO_PARADA = 0,
+    // Poderíamos ter EVENTO_FIM, mas o último EVENTO_PARADA já é o fim.
+
+    // Modo frota (ver Frota)
+    EVENTO_PEDIDO,        // a corrida precisa de um veículo
+    EVENTO_VEICULO_LIVRE, // um veículo terminou sua corrida (sem corrida)
+
+    // Início de uma corrida ainda não montada: o grupo indiceParada da fonte
+    // (sem corrida), agendado antes da simulação (ver Escalonador)
+    EVENTO_INICIO
+};
+
+struct Evento {
+    double tempo;
+    TipoEvento tipo;
+    Corrida* corrida;
+    int indiceParada; // índice da parada na corrida (o veículo ou o grupo nos outros tipos)
+};
+
+#endif // EVENTO_HPP
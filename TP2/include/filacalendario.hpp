@@ -0,0 +1,52 @@
+#ifndef FILACALENDARIO_HPP
+#define FILACALENDARIO_HPP
+
+#include "filaeventos.hpp"
+
+// Fila calendário (R. Brown, 1988): o tempo é dividido em "dias" de largura
+// fixa e cada dia cai em um balde (dia mod numBaldes), como as folhas de um
+// calendário de um ano. Cada balde é uma lista ordenada por (tempo, ordem de
+// chegada). Com a largura ajustada ao espaçamento dos eventos, cada balde tem
+// poucos eventos e inserção e remoção custam O(1) amortizado.
+class FilaCalendario : public FilaEventos {
+private:
+    // Nó das listas dos baldes; os nós livres formam outra lista
+    struct No {
+        Evento evento;
+        long long seq;   // ordem de chegada (desempate entre tempos iguais)
+        long long dia;   // floor(tempo / largura)
+        int prox;        // próximo nó na lista (-1 no fim)
+    };
+
+    No* nos;
+    int capacidadeNos;
+    int livre;           // primeiro nó livre (-1 se nenhum)
+
+    int* baldes;         // primeiro nó de cada balde (-1 se vazio)
+    int numBaldes;       // sempre potência de 2
+    double largura;      // duração de um dia
+
+    long long diaAtual;  // nenhum evento pendente tem dia menor
+    int tamanho;
+    long long proximaSeq;
+
+    long long diaDe(double tempo) const;
+    bool precede(int a, int b) const;     // (tempo, seq) do nó a < do nó b
+    int alocarNo();
+    void encadear(int idx);               // insere o nó no seu balde, em ordem
+    void redimensionar(int novoNumBaldes);
+    int localizarMinimo();                // balde do menor evento (fila não vazia)
+
+public:
+    FilaCalendario();
+    ~FilaCalendario() override;
+
+    void inserir(const Evento& e) override;
+    bool obterMinimo(Evento& e) override;
+    bool removerMinimo(Evento& e) override;
+
+    bool vazia() const override;
+    int getTamanho() const override;
+};
+
+#endif // FILACALENDARIO_HPP
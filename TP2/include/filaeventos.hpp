@@ -0,0 +1,72 @@
+#ifndef FILAEVENTOS_HPP
+#define FILAEVENTOS_HPP
+
+#include "evento.hpp"
+
+// Implementações disponíveis da fila de eventos do Escalonador
+enum TipoFila {
+    FILA_HEAP = 0,        // heap binário (DaryHeap), O(log n) por operação
+    FILA_CALENDARIO       // fila calendário, O(1) amortizado
+};
+
+// Fila de prioridade de eventos ordenada por tempo.
+//
+// A ordem entre eventos com o mesmo tempo depende da implementação:
+//  - FilaHeap: a do MinHeap original, que resulta da sequência de inserções
+//    e remoções (com o início de todas as corridas agendado antes da
+//    simulação, ver agendaInicios), e é a saída de referência;
+//  - FilaCalendario, e a FilaHeap no modo contínuo: a ordem em que foram
+//    inseridos.
+// Assim, com --fila calendario ou --continuo, só linhas com o mesmo tempo
+// final podem sair em outra ordem.
+class FilaEventos {
+public:
+    virtual ~FilaEventos() {}
+
+    virtual void inserir(const Evento& e) = 0;
+
+    // Insere vários eventos de uma vez, como em inserções seguidas na ordem
+    // do vetor.
+    virtual void inserirLote(const Evento* eventos, int qtd) {
+        for (int i = 0; i < qtd; ++i) {
+            inserir(eventos[i]);
+        }
+    }
+
+    // true se o desempate depende do que está na fila, e então o Escalonador
+    // agenda os inícios de todas as corridas antes de simular, como o
+    // simulador original; com desempate por chegada, iniciar cada corrida
+    // quando o relógio chega a ela dá a mesma ordem.
+    virtual bool agendaInicios() const { return false; }
+
+    // Chamado quando os inícios não puderam ser agendados antes: daí em
+    // diante, empates saem na ordem de chegada (ver FilaHeap)
+    virtual void desempatarPorChegada() {}
+
+    // Copia os eventos pendentes para `destino` (getTamanho() posições) sem
+    // mudar a ordem em que sairão, e restaurar(), numa fila vazia, volta a
+    // esse mesmo estado (ver PontoControle). Por padrão, os eventos são
+    // tirados em ordem e devolvidos com inserirLote.
+    virtual void copiarPendentes(Evento* destino) {
+        int qtd = getTamanho();
+        for (int k = 0; k < qtd; ++k) {
+            removerMinimo(destino[k]);
+        }
+        inserirLote(destino, qtd);
+    }
+
+    virtual void restaurar(const Evento* eventos, int qtd) {
+        inserirLote(eventos, qtd);
+    }
+
+    virtual bool obterMinimo(Evento& e) = 0;    // lê sem remover; false se vazia
+    virtual bool removerMinimo(Evento& e) = 0;  // false se vazia
+
+    virtual bool vazia() const = 0;
+    virtual int getTamanho() const = 0;
+};
+
+// Cria a fila do tipo pedido (liberar com delete)
+FilaEventos* criarFilaEventos(TipoFila tipo, int capacidadeInicial);
+
+#endif // FILAEVENTOS_HPP
@@ -0,0 +1,74 @@
+#ifndef FILAHEAP_HPP
+#define FILAHEAP_HPP
+
+#include "filaeventos.hpp"
+#include "daryheap.hpp"
+
+// Chave de ordenação dos eventos depois de desempatarPorChegada: tempo e,
+// no empate, a ordem de chegada
+struct ChaveEvento {
+    double tempo;
+    long long seq;
+};
+
+struct PrecedeChaveEvento {
+    bool operator()(const ChaveEvento& a, const ChaveEvento& b) const {
+        if (a.tempo != b.tempo) return a.tempo < b.tempo;
+        return a.seq < b.seq;
+    }
+};
+
+// Restante do evento, guardado fora do heap (o tempo já está na chave)
+struct CargaEvento {
+    Corrida* corrida;
+    int indiceParada;
+    TipoEvento tipo;
+};
+
+// Fila de eventos sobre um heap binário de (tempo, posição), com o restante
+// de cada evento em um vetor à parte, cujas posições são reaproveitadas.
+// Cada item do heap ocupa 16 bytes, então um par de irmãos fica em meia
+// linha de cache, e a carga só é lida quando o evento sai.
+//
+// Por padrão, só o tempo decide, e o heap faz as mesmas comparações e
+// movimentos do MinHeap original, então eventos com o mesmo tempo saem na
+// mesma ordem que saíam dele (a que o formato do heap der). Por isso o heap
+// é binário: com mais filhos por nó, essa ordem mudaria. Quando os inícios
+// não podem ser agendados antes (modo contínuo), essa ordem não existe, e a
+// fila passa a um segundo heap, com chave (tempo, chegada), que desempata
+// pela ordem de chegada, como a calendário.
+class FilaHeap : public FilaEventos {
+private:
+    DaryHeap<double, int, 2> heap;      // tempo → posição em cargas[]
+    DaryHeap<ChaveEvento, int, 2, PrecedeChaveEvento> heapChegada;
+    bool porChegada;                    // usa heapChegada em vez de heap
+    long long proximaSeq;
+
+    CargaEvento* cargas;
+    int* livres;            // posições de cargas[] liberadas (pilha)
+    int qtdLivres;
+    int qtdCargas;          // posições de cargas[] já usadas alguma vez
+    int capacidadeCargas;
+
+    int guardar(const Evento& e);       // retorna a posição da carga
+    void montarEvento(double tempo, int posicao, Evento& e) const;
+
+public:
+    explicit FilaHeap(int capacidadeInicial);
+    ~FilaHeap() override;
+
+    void inserir(const Evento& e) override;
+    void inserirLote(const Evento* eventos, int qtd) override;
+    bool obterMinimo(Evento& e) override;
+    bool removerMinimo(Evento& e) override;
+
+    bool agendaInicios() const override;
+    void desempatarPorChegada() override;
+    void copiarPendentes(Evento* destino) override;
+    void restaurar(const Evento* eventos, int qtd) override;
+
+    bool vazia() const override;
+    int getTamanho() const override;
+};
+
+#endif // FILAHEAP_HPP
@@ -0,0 +1,55 @@
+#ifndef FONTECONTINUA_HPP
+#define FONTECONTINUA_HPP
+
+#include "fontecorridas.hpp"
+#include "entradademandas.hpp"
+#include "agrupador.hpp"
+#include "parametros.hpp"
+
+// Fonte de corridas do modo contínuo: lê as demandas da entrada uma a uma
+// (do texto ou da mescla de fragmentos, ver EntradaDemandas),
+// enquanto a simulação avança, e agrupa-as com o mesmo algoritmo guloso.
+//
+// Só o grupo em formação fica em memória (no máximo η demandas mais a que o
+// encerrou). Um grupo é fechado assim que chega a demanda que ele recusa
+// (em particular, a primeira fora da janela δ da semente) ou a entrada acaba;
+// a demanda recusada vira a semente do próximo grupo. Cada corrida recebe uma
+// tabela só com as suas demandas e a libera ao terminar.
+//
+// A entrada precisa estar ordenada por tempo de solicitação: o Escalonador só
+// processa eventos até o início da próxima corrida, que é o tempo da última
+// demanda lida. Uma demanda com tempo menor que o da anterior encerra a
+// leitura (as corridas já formadas terminam normalmente), e getForaDeOrdem()
+// passa a informá-la.
+class FonteContinua : public FonteCorridas {
+private:
+    EntradaDemandas& entrada;
+
+    TabelaDemandas janela;  // posição 0 é a semente; depois, os candidatos
+    int qtdJanela;          // 0 (nada lido) ou 1 (semente aguardando)
+    Agrupador agrupador;    // opera sobre a janela
+    ContadoresAgrupamento histograma;  // só os tamanhos dos grupos fechados
+
+    double ultimoTempo;     // tempo da última demanda lida
+    bool foraDeOrdem;       // a leitura parou numa demanda fora de ordem
+    int idForaDeOrdem;
+
+    bool lerDemanda(int posicao);  // lê a próxima demanda para a janela
+
+public:
+    FonteContinua(EntradaDemandas& entrada_, const Parametros& params);
+    ~FonteContinua() override;
+
+    bool temProxima() override;
+    double tempoProxima() override;
+    Corrida* criarProxima() override;
+
+    // true se a leitura parou numa demanda anterior à última lida, cujo id
+    // vai para `id`
+    bool getForaDeOrdem(int& id) const;
+
+    // Soma a `destino` os contadores do agrupamento feito até agora
+    void coletarContadores(ContadoresAgrupamento& destino) const;
+};
+
+#endif // FONTECONTINUA_HPP
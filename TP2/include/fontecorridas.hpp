@@ -0,0 +1,33 @@
+#ifndef FONTECORRIDAS_HPP
+#define FONTECORRIDAS_HPP
+
+#include "corrida.hpp"
+
+// Origem das corridas consumidas pelo Escalonador durante a simulação.
+// As corridas são entregues em ordem de início (tempo da primeira demanda)
+// e só são construídas quando o relógio chega a elas, de modo que apenas as
+// corridas em andamento ocupam memória.
+class FonteCorridas {
+public:
+    virtual ~FonteCorridas() {}
+
+    virtual bool temProxima() = 0;
+    virtual double tempoProxima() = 0;    // início da próxima corrida
+    virtual Corrida* criarProxima() = 0;  // constrói a próxima e avança
+
+    // Fontes que já têm todos os grupos formados (FonteGrupos) podem
+    // entregá-los de uma vez, para que o Escalonador agende os inícios antes
+    // de simular (ver FilaEventos::agendaInicios) e monte cada corrida quando
+    // o seu início sai da fila, em qualquer ordem. entregarGrupos() marca
+    // como entregues os grupos que faltavam, [primeiro, primeiro + qtd) na
+    // ordem em que foram formados, e retorna qtd; retorna -1 se a fonte só
+    // conhece as corridas à medida que as entrega (como a contínua).
+    virtual int entregarGrupos(int& primeiro) {
+        primeiro = 0;
+        return -1;
+    }
+    virtual double tempoGrupo(int) { return 0.0; }        // início do grupo g
+    virtual Corrida* criarGrupo(int) { return nullptr; }  // constrói o grupo g
+};
+
+#endif // FONTECORRIDAS_HPP
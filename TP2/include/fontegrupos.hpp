@@ -0,0 +1,50 @@
+#ifndef FONTEGRUPOS_HPP
+#define FONTEGRUPOS_HPP
+
+#include "fontecorridas.hpp"
+#include "tabelademandas.hpp"
+
+// Fonte de corridas a partir dos grupos contíguos devolvidos por
+// agruparDemandas: o grupo g é demandas[limites[g], limites[g + 1]).
+//
+// Os grupos saem em ordem de (início, g), a mesma dos eventos iniciais quando
+// todos eram agendados antes da simulação. Com a entrada ordenada por tempo,
+// essa já é a ordem dos grupos; caso contrário, ela é calculada uma vez.
+// Também podem ser entregues todos de uma vez (entregarGrupos) e montados
+// em qualquer ordem. As corridas referenciam as demandas por índice na tabela.
+class FonteGrupos : public FonteCorridas {
+private:
+    TabelaDemandas& demandas;
+    const int* limites;
+    int qtdGrupos;
+    int* ordem;       // ordem de saída dos grupos (nullptr se já ordenados)
+    int proximo;      // posição do próximo grupo na ordem de saída
+
+    int grupoProximo() const;
+
+public:
+    // Os `entregues` primeiros grupos já saíram (ao retomar um ponto de
+    // controle, são os que já estavam na fila de eventos)
+    FonteGrupos(TabelaDemandas& demandas_, const int* limites_, int qtdGrupos_,
+                int entregues = 0);
+    ~FonteGrupos() override;
+
+    bool temProxima() override;
+    double tempoProxima() override;
+    Corrida* criarProxima() override;
+
+    int entregarGrupos(int& primeiro) override;
+    double tempoGrupo(int g) override;
+    Corrida* criarGrupo(int g) override;
+
+    // Demandas do grupo g: demandas[inicio, fim)
+    void getGrupo(int g, int& inicio, int& fim) const;
+
+    // Grupos que ainda não começaram, na ordem de saída (ver PontoControle):
+    // o k-ésimo é demandas[inicio, fim)
+    int getQtdRestantes() const;
+    void getRestante(int k, int& inicio, int& fim) const;
+    const TabelaDemandas& getDemandas() const;
+};
+
+#endif // FONTEGRUPOS_HPP
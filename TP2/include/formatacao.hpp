@@ -0,0 +1,22 @@
+#ifndef FORMATACAO_HPP
+#define FORMATACAO_HPP
+
+// Formatação numérica rápida para a linha de saída das corridas, sem
+// std::ostream. Cada função escreve a partir de p e retorna o fim do texto.
+
+// Maior texto escrito por escreverFixo2 / escreverInteiro
+static const int TAM_MAX_FIXO2 = 20;
+static const int TAM_MAX_INTEIRO = 11;
+
+// Escreve v com duas casas decimais, idêntico a std::fixed com
+// setprecision(2) (ou "%.2f"): o valor binário exato é arredondado ao
+// centésimo mais próximo, com empate para o par, e o sinal de -0.0 e de
+// negativos que arredondam a zero é mantido.
+// Retorna nullptr, sem garantia sobre o que foi escrito, se v não for finito
+// ou se |v| >= 2^53 / 100; nesses casos o chamador usa o formatador geral.
+char* escreverFixo2(char* p, double v);
+
+// Escreve um inteiro em base 10
+char* escreverInteiro(char* p, int v);
+
+#endif // FORMATACAO_HPP
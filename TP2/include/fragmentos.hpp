@@ -0,0 +1,78 @@
+#ifndef FRAGMENTOS_HPP
+#define FRAGMENTOS_HPP
+
+#include <iosfwd>
+
+#include "entradademandas.hpp"
+#include "arquivocolunar.hpp"
+#include "daryheap.hpp"
+#include "parametros.hpp"
+#include "poolthreads.hpp"
+
+// Entrada em fragmentos (--fragmentos): as demandas vêm de vários arquivos
+// binários em colunas (um por região, por exemplo; ver ArquivoColunar), e o
+// modo contínuo as recebe já intercaladas por tempo de solicitação.
+//
+// Os arquivos são mapeados, e as demandas são lidas direto das colunas. Um
+// fragmento fora de ordem ganha uma permutação dos seus índices por tempo
+// (ordenação estável, um fragmento por tarefa do pool); os que já estão em
+// ordem são lidos como estão. A mescla mantém um heap com a próxima demanda
+// de cada fragmento, então nada além das permutações é copiado e nenhuma
+// sequência combinada é montada.
+//
+// Tempos iguais saem na ordem dos fragmentos na linha de comando e, dentro
+// de um fragmento, na ordem do arquivo: o mesmo que ordenar de forma estável
+// a concatenação dos fragmentos.
+
+// Próxima demanda de um fragmento no heap da mescla
+struct ChaveFragmento {
+    double tempo;
+    int fragmento;
+};
+
+struct PrecedeChaveFragmento {
+    bool operator()(const ChaveFragmento& a, const ChaveFragmento& b) const {
+        if (a.tempo != b.tempo) return a.tempo < b.tempo;
+        return a.fragmento < b.fragmento;
+    }
+};
+
+class MesclaFragmentos : public EntradaDemandas {
+private:
+    ArquivoColunar* arquivos;
+    int qtdFragmentos;
+    int** ordens;          // permutação por tempo de cada fragmento (nullptr se já em ordem)
+    int* posicoes;         // próxima posição de cada fragmento
+    int qtdOrdenados;      // fragmentos que precisaram da permutação
+
+    Parametros params;
+    long long numDemandas;
+
+    DaryHeap<ChaveFragmento, int, 4, PrecedeChaveFragmento> heap;
+
+    void liberarMemoria();
+    void agendar(int f);   // põe a próxima demanda de f no heap, se houver
+
+public:
+    MesclaFragmentos();
+    ~MesclaFragmentos() override;
+
+    MesclaFragmentos(const MesclaFragmentos&) = delete;
+    MesclaFragmentos& operator=(const MesclaFragmentos&) = delete;
+
+    // Mapeia os arquivos, confere que todos têm os mesmos parâmetros e
+    // ordena os que estiverem fora de ordem (em paralelo com um pool).
+    // Retorna false (após escrever o erro em std::cerr) se algum arquivo
+    // não puder ser aberto ou os parâmetros forem diferentes.
+    bool abrir(char** caminhos, int qtd, PoolThreads* pool);
+
+    const Parametros& getParametros() const;
+    long long getNumDemandas() const;   // soma dos fragmentos
+
+    // Uma linha com fragmentos, demandas e quantos precisaram ser ordenados
+    void imprimirResumo(std::ostream& out) const;
+
+    bool ler(int& id, double& tempo, Ponto& origem, Ponto& destino) override;
+};
+
+#endif // FRAGMENTOS_HPP
@@ -0,0 +1,120 @@
+#ifndef FROTA_HPP
+#define FROTA_HPP
+
+#include <iosfwd>
+
+#include "demanda.hpp"
+
+class Corrida;
+
+// Modo frota (--frota): um número fixo de veículos em vez de um veículo novo
+// para cada corrida.
+//
+// Quando uma corrida é pedida, ela recebe o veículo livre mais próximo do seu
+// primeiro embarque, que vai até lá pela reta antes da primeira parada; sem
+// veículo livre, a corrida espera numa fila por ordem de pedido. Ao fim de
+// cada corrida, o veículo fica na última parada e é liberado por um evento
+// do Escalonador, que o entrega à corrida mais antiga da espera ou o devolve
+// aos livres. Pedidos no mesmo instante são atendidos na ordem em que foram
+// feitos, com qualquer fila de eventos (o Escalonador desempata por ordem
+// de chegada), então a atribuição não depende de --fila.
+//
+// Os veículos livres ficam em uma grade uniforme (cerca de dois veículos por
+// célula sobre o retângulo das posições iniciais; quem sai dele fica na célula
+// da borda), com uma lista encadeada por célula. A busca percorre anéis de
+// células em volta do embarque; com poucos livres (quadrado menor que o dobro
+// da frota), percorrer a lista de livres custa menos que os anéis vazios, e
+// ela é usada no lugar. Nos dois casos o empate fica com o menor índice.
+
+// Contadores da frota, escritos em std::cerr ao fim da simulação com --metricas
+struct EstatisticasFrota {
+    long long atribuicoes;      // corridas que receberam veículo
+    long long esperas;          // das quais esperaram por um veículo
+    double tempoEspera;         // soma das esperas (pedido até atribuição)
+    double maiorEspera;
+    double aproximacao;         // soma das distâncias até o primeiro embarque
+    long long buscasGrade;      // buscas pelos anéis da grade
+    long long buscasLista;      // buscas pela lista de livres
+    long long celulasVisitadas; // nas buscas pela grade
+
+    void zerar();
+
+    // Uma linha com atribuições, esperas e o custo das buscas
+    void imprimirResumo(std::ostream& out) const;
+};
+
+class Frota {
+private:
+    int numVeiculos;
+    double* xs;                 // posição atual de cada veículo
+    double* ys;
+
+    // grade dos veículos livres
+    double minX;
+    double minY;
+    double tamCelula;
+    int colunasGrade;
+    int linhasGrade;
+    int* primeiroCelula;        // primeiro livre de cada célula (-1 se vazia)
+    int* proximoCelula;         // encadeamento dos livres na célula
+    int* anteriorCelula;
+    int* celulaVeiculo;
+
+    // lista dos livres, para a busca direta e para remover em O(1)
+    int* livres;
+    int* posicaoLivre;          // posição em livres (-1 se ocupado)
+    int qtdLivres;
+
+    // corridas à espera de veículo, em ordem de pedido (anel)
+    Corrida** espera;
+    int capacidadeEspera;
+    int inicioEspera;
+    int qtdEspera;
+
+    EstatisticasFrota estatisticas;
+
+    void liberarMemoria();
+    void montarGrade();
+    int celulaDe(const Ponto& p, int& cx, int& cy) const;
+    void inserirNaGrade(int v);
+    void removerDaGrade(int v);
+    int buscarNaGrade(const Ponto& p);
+    int buscarNaLista(const Ponto& p) const;
+
+public:
+    Frota();
+    ~Frota();
+
+    Frota(const Frota&) = delete;
+    Frota& operator=(const Frota&) = delete;
+
+    // Lê "numVeiculos" e uma linha "x y" por veículo; todos começam livres.
+    // Retorna false (após escrever o erro em std::cerr) se o arquivo não
+    // existir ou não estiver no formato.
+    bool carregar(const char* caminho);
+
+    int getNumVeiculos() const;
+    int getQtdLivres() const;
+    Ponto getPosicao(int v) const;
+
+    // Ocupa e devolve o veículo livre mais próximo de p (-1 se não houver)
+    int ocuparMaisProximo(const Ponto& p);
+
+    // O veículo ocupado v para em p (a última parada da sua corrida)
+    void estacionar(int v, const Ponto& p);
+
+    // Devolve v aos livres, na posição em que está
+    void liberar(int v);
+
+    // Fila das corridas sem veículo (a frota não é dona delas)
+    void esperar(Corrida* corrida);
+    Corrida* retirarEspera();   // a mais antiga (nullptr se nenhuma)
+
+    // Uma corrida pedida em `pedido` recebeu veículo em `agora`, a
+    // `aproximacao` do seu primeiro embarque
+    void registrarAtribuicao(double pedido, double agora, double aproximacao);
+
+    const EstatisticasFrota& getEstatisticas() const;
+};
+
+#endif // FROTA_HPP
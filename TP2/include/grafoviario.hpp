@@ -0,0 +1,77 @@
+#ifndef GRAFOVIARIO_HPP
+#define GRAFOVIARIO_HPP
+
+#include "demanda.hpp"
+
+// Malha viária: nós com coordenadas no mesmo plano das demandas e arcos
+// dirigidos com comprimento.
+//
+// Formato do arquivo de texto (linhas iniciadas por '#' são ignoradas):
+//   numNos numArcos
+//   x y              (numNos linhas: coordenadas do nó 0, 1, ...)
+//   u v comprimento  (numArcos linhas: arco u -> v)
+// Uma via de mão dupla é descrita por dois arcos.
+//
+// Os arcos ficam em vetores compactos por nó de origem (saídas) e, para a
+// busca no sentido contrário, por nó de destino (entradas). Uma grade
+// uniforme sobre os nós encontra o nó mais próximo de um ponto.
+class GrafoViario {
+private:
+    int numNos;
+    int numArcos;
+    double* xs;
+    double* ys;
+
+    int* inicioSaidas;       // arcos que saem de u: [inicioSaidas[u], inicioSaidas[u + 1])
+    int* destinosSaidas;
+    double* pesosSaidas;
+    int* inicioEntradas;     // arcos que chegam a v, com a origem de cada um
+    int* origensEntradas;
+    double* pesosEntradas;
+
+    // menor comprimento / distância em linha reta entre todos os arcos (até 1):
+    // a distância na malha entre dois nós é pelo menos fatorReta vezes a reta
+    double fatorReta;
+
+    // grade: células de lado tamCelula a partir de (minX, minY); os nós da
+    // célula c são nosCelulas[inicioCelulas[c] .. inicioCelulas[c + 1])
+    double minX;
+    double minY;
+    double tamCelula;
+    int colunasGrade;
+    int linhasGrade;
+    int* inicioCelulas;
+    int* nosCelulas;
+
+    void liberar();
+    void montarArcos(const int* origens, const int* destinos, const double* pesos);
+    void montarGrade();
+
+public:
+    GrafoViario();
+    ~GrafoViario();
+
+    GrafoViario(const GrafoViario&) = delete;
+    GrafoViario& operator=(const GrafoViario&) = delete;
+
+    // Lê o arquivo no formato acima. Retorna false (após escrever o erro em
+    // std::cerr) se ele não existir ou tiver algum nó, arco ou peso inválido.
+    bool carregar(const char* caminho);
+
+    int getNumNos() const;
+    int getNumArcos() const;
+    Ponto getPonto(int no) const;
+    double getFatorReta() const;
+
+    // Nó mais próximo de p (em linha reta); no empate, o de menor índice
+    int noMaisProximo(const Ponto& p) const;
+
+    const int* getInicioSaidas() const;
+    const int* getDestinosSaidas() const;
+    const double* getPesosSaidas() const;
+    const int* getInicioEntradas() const;
+    const int* getOrigensEntradas() const;
+    const double* getPesosEntradas() const;
+};
+
+#endif // GRAFOVIARIO_HPP
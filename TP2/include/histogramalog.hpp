@@ -0,0 +1,52 @@
+#ifndef HISTOGRAMALOG_HPP
+#define HISTOGRAMALOG_HPP
+
+// Histograma de memória fixa com baldes logarítmicos (no estilo HDR).
+//
+// Cada potência de 2 de |v| é dividida em SUBBALDES baldes iguais, então o
+// balde de um valor tem largura de no máximo 1/32 dele (erro relativo de até
+// cerca de 1,6% no ponto médio). O índice sai direto dos bits do double:
+// expoente e os primeiros bits da mantissa. Valores negativos têm baldes
+// próprios, espelhados; |v| abaixo de 2^EXPOENTE_MINIMO conta como zero, e
+// acima do maior balde vai para ele. Contagem, soma, mínimo e máximo são
+// exatos, e os percentis ficam entre o mínimo e o máximo.
+//
+// Dois histogramas se somam balde a balde, então cada thread pode ter o seu
+// e juntá-los no fim.
+class HistogramaLog {
+public:
+    static const int BITS_SUBBALDE = 5;
+    static const int SUBBALDES = 1 << BITS_SUBBALDE;
+    static const int EXPOENTE_MINIMO = -24;     // 2^-24 ~ 6e-8
+    static const int NUM_OITAVAS = 64;          // até 2^40 ~ 1e12
+    static const int BALDES_MAGNITUDE = NUM_OITAVAS * SUBBALDES;
+    static const int NUM_BALDES = 2 * BALDES_MAGNITUDE + 1;  // negativos, zero, positivos
+
+private:
+    long long contagens[NUM_BALDES];
+    long long total;
+    double soma;
+    double minimo;
+    double maximo;
+
+    static int baldeMagnitude(double magnitude);
+    static double centroMagnitude(int balde);
+
+public:
+    HistogramaLog();
+
+    void zerar();
+    void registrar(double v);
+    void somar(const HistogramaLog& outro);
+
+    long long getTotal() const;
+    double getMedia() const;
+    double getMinimo() const;
+    double getMaximo() const;
+
+    // Menor valor (pelo centro do balde) com pelo menos a fração p dos
+    // registros até ele; 0 se vazio
+    double percentil(double p) const;
+};
+
+#endif // HISTOGRAMALOG_HPP
@@ -0,0 +1,26 @@
+#ifndef MEDIDORLATENCIA_HPP
+#define MEDIDORLATENCIA_HPP
+
+#include <iosfwd>
+
+#include "observadorcorridas.hpp"
+
+// Mede, para cada corrida, o tempo de parede entre a leitura da última
+// demanda do seu grupo e a impressão da sua linha de saída.
+class MedidorLatencia : public ObservadorCorridas {
+private:
+    long long qtdCorridas;
+    double soma;
+    double minima;
+    double maxima;
+
+public:
+    MedidorLatencia();
+
+    void corridaFinalizada(const Corrida& c) override;
+
+    // Uma linha com quantidade, média, mínima e máxima (em milissegundos)
+    void imprimirResumo(std::ostream& out) const;
+};
+
+#endif // MEDIDORLATENCIA_HPP
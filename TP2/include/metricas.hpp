@@ -0,0 +1,78 @@
+#ifndef METRICAS_HPP
+#define METRICAS_HPP
+
+#include <iosfwd>
+
+// Métricas de execução, coletadas com --metricas e escritas em JSON.
+//
+// Os contadores do Agrupador e do Escalonador são somas simples em membros,
+// sempre ativas; só a coleta deles e a medição do tempo das fases dependem
+// da opção, então o custo sem ela é desprezível.
+
+// Motivo pelo qual um candidato não entrou no grupo
+enum MotivoRecusa {
+    RECUSA_DELTA = 0,     // fora da janela de tempo δ
+    RECUSA_ETA,           // grupo cheio (η)
+    RECUSA_ALFA,          // origem longe demais de algum membro
+    RECUSA_BETA,          // destino longe demais de algum membro
+    RECUSA_LAMBDA,        // eficiência da rota não passa de λ
+    NUM_MOTIVOS_RECUSA,
+    RECUSA_NENHUMA = NUM_MOTIVOS_RECUSA
+};
+
+// Nome do motivo ("delta", "eta", "alfa", "beta" ou "lambda")
+const char* nomeMotivoRecusa(MotivoRecusa motivo);
+
+// Grupos maiores que isso são contados juntos na última posição do histograma
+static const int MAX_TAM_HISTOGRAMA = 64;
+
+struct ContadoresAgrupamento {
+    long long candidatos;                       // demandas testadas contra um grupo
+    long long recusas[NUM_MOTIVOS_RECUSA];
+    long long recusasLambdaSemRaiz;             // recusas por λ decididas pelo limite
+    long long reavaliacoesCompletas;            // eficiências refeitas com a soma completa
+    long long raizes;                           // distâncias euclidianas calculadas
+    long long grupos;
+    long long tamanhos[MAX_TAM_HISTOGRAMA + 1]; // tamanhos[k]: grupos com k demandas
+
+    void zerar();
+    void somar(const ContadoresAgrupamento& outros);
+    void registrarGrupo(int tamanho);
+};
+
+struct ContadoresFila {
+    long long insercoes;
+    long long remocoes;
+    long long iniciosDiretos;     // inícios de corrida tratados sem passar pela fila
+    long long tamanhoMaximo;
+
+    void zerar();
+};
+
+// Fases da execução, com o tempo de parede de cada uma
+enum FaseExecucao {
+    FASE_LEITURA = 0,
+    FASE_AGRUPAMENTO,
+    FASE_MONTAGEM,        // rotas e trechos das corridas
+    FASE_SIMULACAO,
+    FASE_IMPRESSAO,
+    NUM_FASES
+};
+
+struct Metricas {
+    ContadoresAgrupamento agrupamento;
+    ContadoresFila fila;
+    double tempoFase[NUM_FASES];    // segundos
+
+    void zerar();
+    void escreverJson(std::ostream& out) const;
+};
+
+// Marcação das fases sem custo quando metricas é nullptr:
+//   double marca = iniciarFase(metricas);
+//   ... fase A ...
+//   marca = marcarFase(metricas, FASE_A, marca);   // soma e recomeça
+double iniciarFase(const Metricas* metricas);
+double marcarFase(Metricas* metricas, FaseExecucao fase, double inicio);
+
+#endif // METRICAS_HPP
@@ -0,0 +1,93 @@
+#ifndef MOTORCORROTINAS_HPP
+#define MOTORCORROTINAS_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+
+#include "daryheap.hpp"
+#include "filaheap.hpp"
+#include "metricas.hpp"
+
+// Motor de corrotinas (--motor corrotinas, ver Escalonador::simularCorrotinas).
+//
+// Em vez de um Evento por parada, cada corrida é uma corrotina que percorre
+// suas paradas em um laço e, a cada uma, faz co_await agenda.avancarAte(t):
+// a corrotina fica suspensa na agenda até o relógio chegar a t. A agenda é o
+// mesmo heap binário da FilaHeap, com a mesma chave, e recebe os inícios dos
+// grupos e as esperas na mesma sequência em que a FilaHeap recebe os inícios
+// e as paradas, então até os empates saem na mesma ordem e a saída é a mesma
+// do motor de eventos.
+//
+// Os quadros das corrotinas saem de uma lista livre por thread: todos têm o
+// mesmo tamanho, e um quadro liberado ao fim de uma corrida é reaproveitado
+// pela próxima, sem passar pelo alocador geral.
+
+// Quadros de corrotina do pool da thread (outros tamanhos vão para new)
+void* alocarQuadro(std::size_t bytes);
+void liberarQuadro(void* quadro, std::size_t bytes) noexcept;
+
+// Corrotina de uma corrida: roda até o primeiro co_await quando é chamada e
+// libera o próprio quadro ao terminar, então ninguém guarda a tarefa.
+struct TarefaCorrida {
+    struct promise_type {
+        TarefaCorrida get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void* operator new(std::size_t bytes) { return alocarQuadro(bytes); }
+        static void operator delete(void* quadro, std::size_t bytes) noexcept {
+            liberarQuadro(quadro, bytes);
+        }
+    };
+};
+
+// Corrotinas suspensas e inícios de grupos ainda não montados, em ordem de
+// tempo (empates como na FilaHeap)
+class AgendaCorrotinas {
+private:
+    struct Agendado {
+        void* corrotina;   // nullptr no início de um grupo
+        int grupo;
+    };
+
+    DaryHeap<ChaveEvento, Agendado, 2, PrecedeChaveEvento> heap;
+    long long proximaSeq;
+    bool porChegada;
+    ContadoresFila& contadores;
+
+    ChaveEvento chave(double tempo);
+
+    void registrarInsercao();
+
+public:
+    // Resultado de avancarAte: suspende a corrotina e a agenda para `tempo`
+    struct Espera {
+        AgendaCorrotinas& agenda;
+        double tempo;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> corrotina) { agenda.agendar(tempo, corrotina); }
+        void await_resume() const noexcept {}
+    };
+
+    AgendaCorrotinas(int capacidadeInicial, ContadoresFila& contadores_);
+    ~AgendaCorrotinas();   // destrói os quadros que ainda estiverem suspensos
+
+    AgendaCorrotinas(const AgendaCorrotinas&) = delete;
+    AgendaCorrotinas& operator=(const AgendaCorrotinas&) = delete;
+
+    Espera avancarAte(double tempo) { return Espera{*this, tempo}; }
+
+    void agendar(double tempo, std::coroutine_handle<> corrotina);
+    void agendarInicio(double tempo, int grupo);
+    void desempatarPorChegada();   // como na FilaHeap
+    bool obterMinimo(double& tempo) const;
+
+    // Remove o menor: uma corrotina ou, se ela for nula, o início de `grupo`
+    std::coroutine_handle<> removerMinimo(double& tempo, int& grupo);
+};
+
+#endif // MOTORCORROTINAS_HPP
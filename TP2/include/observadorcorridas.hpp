@@ -0,0 +1,15 @@
+#ifndef OBSERVADORCORRIDAS_HPP
+#define OBSERVADORCORRIDAS_HPP
+
+#include "corrida.hpp"
+
+// Recebe cada corrida no momento em que o Escalonador a finaliza, depois de
+// impressa e antes de ser liberada (a referência não vale após a chamada).
+class ObservadorCorridas {
+public:
+    virtual ~ObservadorCorridas() {}
+
+    virtual void corridaFinalizada(const Corrida& c) = 0;
+};
+
+#endif // OBSERVADORCORRIDAS_HPP
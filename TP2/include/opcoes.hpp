@@ -0,0 +1,37 @@
+#ifndef OPCOES_HPP
+#define OPCOES_HPP
+
+#include "filaeventos.hpp"
+
+// Opções de linha de comando do simulador.
+// Sem argumentos, o comportamento é o original: tudo sequencial.
+struct Opcoes {
+    int threads;        // threads usadas no agrupamento (1 = sequencial)
+    bool threadsDefinido; // --threads foi dado (senão --regioes escolhe pelos núcleos)
+    TipoFila fila;      // implementação da fila de eventos do Escalonador
+    bool corrotinas;    // simula com uma corrotina por corrida (ver motorcorrotinas.hpp)
+    bool continuo;      // lê e simula as demandas em fluxo (ver FonteContinua)
+    bool saidaAssincrona; // formata e escreve a saída em outra thread
+    bool analitico;     // calcula as corridas sem fila de eventos (ver simularAnalitico)
+    const char* varredura;        // arquivo de conjuntos de parâmetros (nullptr se nenhum)
+    const char* prefixoVarredura; // prefixo dos arquivos de saída completa da varredura
+    const char* metricas;         // destino do JSON de métricas ("-" = stderr; nullptr se nenhum)
+    bool qualidade;               // distribuições de espera, desvio, ocupação e duração (ver QualidadeServico)
+    const char* binario;          // entrada em colunas (ver ArquivoColunar) no lugar de std::cin
+    const char* converter;        // grava a entrada de texto neste arquivo binário e termina
+    const char* grafo;            // malha viária para as distâncias (ver GrafoViario)
+    const char* pontoControle;    // arquivo do ponto de controle (ver PontoControle)
+    int intervaloControle;        // corridas finalizadas entre pontos de controle
+    const char* retomar;          // continua a simulação deste ponto de controle
+    const char* frota;            // veículos e posições iniciais (ver Frota)
+    char** fragmentos;            // arquivos binários mesclados por tempo (ver MesclaFragmentos)
+    int qtdFragmentos;            // 0 se a entrada é a de sempre
+    const char* regioes;          // partição em regiões simuladas à parte (ver SimulacaoRegioes)
+    const char* rastro;           // destino do rastro de eventos (ver rastro.hpp)
+};
+
+// Preenche as opções a partir de argv. Retorna false (após escrever
+// a mensagem de erro em std::cerr) se algum argumento for inválido.
+bool lerOpcoes(int argc, char** argv, Opcoes& opcoes);
+
+#endif // OPCOES_HPP
@@ -3,8 +3,6 @@
 
 #include "demanda.hpp"
 
-class Demanda;
-
 // Tipo de parada em uma corrida: embarque ou desembarque
 enum TipoParada {
     PARADA_EMBARQUE = 0,
@@ -16,19 +14,19 @@ class Parada {
 private:
     Ponto ponto;          // Coordenadas da parada
     TipoParada tipo;      // Embarque ou desembarque
-    Demanda* demanda;     // Demanda associada a esta parada
+    int demanda;          // Índice da demanda associada na tabela da corrida
 
 public:
     Parada();                                      // Construtor padrão
-    Parada(const Ponto& p, TipoParada tipo_, Demanda* demanda_); // Construtor completo
+    Parada(const Ponto& p, TipoParada tipo_, int demanda_); // Construtor completo
 
     Ponto getPonto() const;                        // Obtém coordenadas da parada
     TipoParada getTipo() const;                    // Obtém o tipo da parada
-    Demanda* getDemanda() const;                   // Obtém a demanda associada
+    int getDemanda() const;                        // Obtém a demanda associada
 
     void setPonto(const Ponto& p);                 // Define posição da parada
     void setTipo(TipoParada t);                    // Define o tipo de parada
-    void setDemanda(Demanda* d);                   // Associa uma demanda
+    void setDemanda(int d);                        // Associa uma demanda
 };
 
 #endif // PARADA_HPP
@@ -0,0 +1,14 @@
+#ifndef PARAMETROS_HPP
+#define PARAMETROS_HPP
+
+// Parâmetros globais do sistema, lidos na primeira linha da entrada
+struct Parametros {
+    int eta;          // capacidade do veículo
+    double gama;      // velocidade de deslocamento
+    double delta;     // janela máxima para combinar corridas
+    double alfa;      // limite de distância entre origens
+    double beta;      // limite de distância entre destinos
+    double lambda;    // eficiência mínima exigida
+};
+
+#endif // PARAMETROS_HPP
@@ -0,0 +1,60 @@
+#ifndef PARTICAOREGIOES_HPP
+#define PARTICAOREGIOES_HPP
+
+#include "demanda.hpp"
+
+// Partição da cidade em regiões (--regioes), lida de um arquivo em um de
+// dois formatos:
+//
+//   grade NX NY XMIN YMIN XMAX YMAX
+//       NX por NY células iguais sobre o retângulo; a célula (cx, cy) é a
+//       região cy * NX + cx. A borda de cima e a da direita pertencem às
+//       últimas células.
+//
+//   poligonos K
+//   N x1 y1 x2 y2 ... xN yN        (K linhas, uma por polígono)
+//       a região k é o k-ésimo polígono (fechado do último vértice ao
+//       primeiro). Um ponto em mais de um polígono fica no primeiro; o teste
+//       é o do raio (par ou ímpar), depois do retângulo envolvente.
+//
+// Um ponto fora de todas as regiões está na região -1.
+class ParticaoRegioes {
+private:
+    int qtdRegioes;
+
+    // grade (colunasGrade == 0 se a partição é por polígonos)
+    int colunasGrade;
+    int linhasGrade;
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+
+    // polígonos: os vértices de k são xs/ys[inicioPoligono[k], inicioPoligono[k + 1])
+    int* inicioPoligono;
+    double* xs;
+    double* ys;
+    double* envolventes;   // minX, minY, maxX, maxY de cada polígono
+
+    void liberarMemoria();
+    int regiaoGrade(const Ponto& p) const;
+    bool dentroPoligono(int k, const Ponto& p) const;
+
+public:
+    ParticaoRegioes();
+    ~ParticaoRegioes();
+
+    ParticaoRegioes(const ParticaoRegioes&) = delete;
+    ParticaoRegioes& operator=(const ParticaoRegioes&) = delete;
+
+    // Retorna false (após escrever o erro em std::cerr) se o arquivo não
+    // puder ser aberto ou for inválido
+    bool carregar(const char* caminho);
+
+    int getQtdRegioes() const;
+
+    // Região do ponto, em [0, qtdRegioes), ou -1 se nenhuma
+    int regiao(const Ponto& p) const;
+};
+
+#endif // PARTICAOREGIOES_HPP
@@ -0,0 +1,133 @@
+#ifndef PONTOCONTROLE_HPP
+#define PONTOCONTROLE_HPP
+
+#include <streambuf>
+
+#include "evento.hpp"
+#include "fontegrupos.hpp"
+#include "metricas.hpp"
+#include "parametros.hpp"
+#include "tabelademandas.hpp"
+
+class Escalonador;
+
+// Pontos de controle da simulação por eventos (--ponto-controle e --retomar).
+//
+// Entre dois eventos, o Escalonador pode gravar tudo o que falta simular em
+// um arquivo binário: os parâmetros, as demandas das corridas em andamento e
+// dos grupos que ainda não começaram, os eventos pendentes copiados da fila
+// (ver FilaEventos::copiarPendentes), o relógio, os contadores da fila e
+// quantos bytes de saída já foram escritos. As corridas não são gravadas:
+// cada uma é montada de novo, igual, a partir das suas demandas (ver
+// montarCorrida). Devolvidos à fila na mesma ordem, os eventos refazem os
+// mesmos desempates, e a saída retomada é igual à de uma execução direta.
+//
+// Formato (versão 2, na ordem de bytes da máquina que gravou):
+//   - cabeçalho (CabecalhoPontoControle, em pontocontrole.cpp);
+//   - colunas das n demandas: ids (int32), tempos, origem x, origem y,
+//     destino x, destino y e, no modo viário, os dois trechos (double);
+//   - limites dos grupos (int32, qtdGrupos + 1): primeiro o de cada evento
+//     pendente, na ordem da cópia da fila (a corrida em andamento, ou o
+//     grupo cujo início está agendado), depois os grupos que a fonte ainda
+//     não entregou, na ordem em que começam;
+//   - tempo (double) e parada (int32) de cada evento pendente; parada -1 é
+//     o início do grupo, ainda sem corrida.
+
+// Streambuf que repassa tudo a outro e conta os bytes escritos, para que o
+// ponto de controle saiba até onde a saída já foi.
+class SaidaContada : public std::streambuf {
+private:
+    std::streambuf* destino;
+    char* buffer;
+    int capacidade;
+    long long entregues;   // bytes já repassados ao destino
+
+    bool esvaziar();
+
+protected:
+    int overflow(int c) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+    int sync() override;
+
+public:
+    static const int CAPACIDADE_PADRAO = 64 * 1024;
+
+    // `inicial` é o total de bytes já escritos antes (ao retomar)
+    SaidaContada(std::streambuf* destino_, long long inicial);
+    ~SaidaContada() override;
+
+    SaidaContada(const SaidaContada&) = delete;
+    SaidaContada& operator=(const SaidaContada&) = delete;
+
+    long long getEscritos() const;   // inclui o que ainda está no buffer
+};
+
+// Gravação periódica, chamada pelo Escalonador (ver setPontoControle).
+// O arquivo é escrito em "<caminho>.tmp" e renomeado, então uma falha no
+// meio da gravação deixa o ponto de controle anterior intacto.
+class PontoControle {
+private:
+    const char* caminho;
+    Parametros params;
+    const FonteGrupos& fonte;
+    SaidaContada& saida;
+
+public:
+    PontoControle(const char* caminho_, const Parametros& params_,
+                  const FonteGrupos& fonte_, SaidaContada& saida_);
+
+    // Esvazia std::cout e grava o estado. Retorna false (após escrever o erro
+    // em std::cerr) se o arquivo não puder ser escrito; a simulação segue.
+    bool gravar(const Evento* eventos, int qtd, double relogio,
+                const ContadoresFila& contadores);
+};
+
+// Estado lido de um ponto de controle, pronto para continuar a simulação.
+// A tabela tem só as demandas que faltavam; todos os grupos vão para uma
+// FonteGrupos (getLimites), com os dos eventos pendentes já entregues, e os
+// eventos voltam à fila do Escalonador (restaurar).
+class RetomadaSimulacao {
+private:
+    Parametros params;
+    TabelaDemandas* tabela;
+    double* trechos;            // embarque e desembarque (nullptr se euclidiano)
+    int* limites;
+    int qtdPendentes;            // eventos na fila (os primeiros grupos)
+    int qtdRestantes;
+    double* temposEventos;
+    int* paradasEventos;
+    double relogio;
+    ContadoresFila contadores;
+    long long deslocamentoSaida;
+
+    void liberar();
+
+public:
+    RetomadaSimulacao();
+    ~RetomadaSimulacao();
+
+    RetomadaSimulacao(const RetomadaSimulacao&) = delete;
+    RetomadaSimulacao& operator=(const RetomadaSimulacao&) = delete;
+
+    // Lê e confere o arquivo. Retorna false (após escrever o erro em
+    // std::cerr) se ele não existir ou não estiver no formato.
+    bool ler(const char* caminho);
+
+    const Parametros& getParametros() const;
+    TabelaDemandas& getTabela();
+    const int* getLimites() const;
+    int getQtdGrupos() const;
+    int getQtdPendentes() const;   // grupos já entregues à fila
+    long long getDeslocamentoSaida() const;
+
+    // Monta as corridas em andamento e devolve todos os eventos à fila
+    void restaurar(Escalonador& escalonador);
+};
+
+// Deixa std::cout pronto para continuar a partir de `deslocamento` bytes:
+// se a saída for um arquivo comum (aberto com >> ou 1<>), ele é cortado
+// nesse ponto; se for um pipe ou terminal, só o restante é escrito.
+// Retorna false se o arquivo tiver menos bytes que o deslocamento.
+bool posicionarSaida(long long deslocamento);
+
+#endif // PONTOCONTROLE_HPP
@@ -0,0 +1,45 @@
+#ifndef POOLTHREADS_HPP
+#define POOLTHREADS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Função executada para cada tarefa: recebe o índice da tarefa e um contexto
+typedef void (*FuncaoTarefa)(int indice, void* contexto);
+
+// Conjunto fixo de threads que executa lotes de tarefas indexadas.
+// Cada chamada a executar() distribui os índices [0, numTarefas) sob demanda
+// entre as threads (incluindo a que chamou) e só retorna quando todas terminam.
+class PoolThreads {
+private:
+    std::thread* threads;     // threads auxiliares (numThreads - 1)
+    int numThreads;
+
+    std::mutex mtx;
+    std::condition_variable cvTrabalho;  // novo lote ou encerramento
+    std::condition_variable cvFim;       // auxiliares terminaram o lote
+
+    FuncaoTarefa funcao;      // lote atual
+    void* contexto;
+    int numTarefas;
+    std::atomic<int> proxima; // próximo índice a ser distribuído
+
+    long geracao;             // incrementada a cada lote
+    int ativos;               // auxiliares ainda trabalhando no lote atual
+    bool encerrar;
+
+    void executarTarefas();   // consome índices do lote atual
+    void laco();              // corpo das threads auxiliares
+
+public:
+    explicit PoolThreads(int numThreads_);
+    ~PoolThreads();
+
+    int getNumThreads() const;
+
+    void executar(int numTarefas_, FuncaoTarefa funcao_, void* contexto_);
+};
+
+#endif // POOLTHREADS_HPP
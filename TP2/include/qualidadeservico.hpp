@@ -0,0 +1,62 @@
+#ifndef QUALIDADESERVICO_HPP
+#define QUALIDADESERVICO_HPP
+
+#include <iosfwd>
+
+#include "histogramalog.hpp"
+#include "colunasdemandas.hpp"
+#include "corrida.hpp"
+
+// Qualidade do serviço (--qualidade): distribuições calculadas à medida que
+// as corridas terminam, sem reler a saída. Ao fim, uma linha por medida com
+// média e percentis é escrita em std::cerr.
+//
+// Na rota básica, a demanda i do grupo de q demandas embarca na parada i e
+// desembarca na parada q + i. Com as distâncias acumuladas dos trechos:
+//   espera     embarque menos a solicitação, por demanda. O embarque é o fim
+//              da corrida menos o resto da rota dividido por γ (vale também
+//              com frota, em que a primeira parada atrasa). Como a corrida
+//              começa na solicitação da primeira demanda, as seguintes podem
+//              embarcar antes de pedir, e a espera fica negativa;
+//   desvio     distância a bordo dividida pela reta da origem ao destino, por
+//              demanda (a reta também no modo viário; sem reta, não conta);
+//   ocupacao   passageiros a bordo em média por distância da rota (soma das
+//              distâncias a bordo dividida pela distância total), por corrida;
+//   duracao    fim menos início da corrida, por corrida.
+//
+// Cada medida é um HistogramaLog, de memória fixa. Cada thread usa a sua
+// QualidadeServico, e somar junta duas.
+class QualidadeServico {
+private:
+    HistogramaLog espera;
+    HistogramaLog desvio;
+    HistogramaLog ocupacao;
+    HistogramaLog duracao;
+
+    double gama;
+    double* acumuladas;     // distância da primeira parada até cada parada
+    int capacidade;
+
+    template <typename Rota>
+    void registrarRota(const Rota& rota, double tempoInicio, double tempoFim);
+
+public:
+    explicit QualidadeServico(double gama_);
+    ~QualidadeServico();
+
+    QualidadeServico(const QualidadeServico&) = delete;
+    QualidadeServico& operator=(const QualidadeServico&) = delete;
+
+    // Corrida finalizada pelo Escalonador (tempo final já definido)
+    void registrarCorrida(const Corrida& c);
+
+    // Grupo demandas[inicio, fim) da simulação analítica, que termina em tempoFim
+    void registrarGrupo(const ColunasDemandas& demandas, int inicio, int fim, double tempoFim);
+
+    void somar(const QualidadeServico& outra);
+
+    // Quatro linhas: espera, desvio, ocupacao e duracao
+    void imprimirResumo(std::ostream& out) const;
+};
+
+#endif // QUALIDADESERVICO_HPP
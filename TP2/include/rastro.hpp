@@ -0,0 +1,72 @@
+#ifndef RASTRO_HPP
+#define RASTRO_HPP
+
+#include "metricas.hpp"
+
+class Corrida;
+
+// Rastro de eventos (--rastro ARQ), para ver o agrupamento e o Escalonador
+// em um visualizador de traços (chrome://tracing ou Perfetto).
+//
+// Só existe se o simulador for compilado com TP2_RASTRO (make re RASTRO=1).
+// Sem isso, as sondas RASTRO(...) e RASTRO_TRECHO(...) somem no
+// pré-processador e não custam nada; com ele, custam um teste de
+// rastroAtivo enquanto --rastro não for dado.
+//
+// Cada thread grava registros binários de tamanho fixo em um anel próprio,
+// sem trava; quando o anel enche, os registros mais antigos são
+// sobrescritos (os trechos das fases têm um anel à parte, para não serem
+// tirados pelas paradas). Ao fim do programa (atexit), os anéis são
+// escritos em ARQ no formato JSON de traços do Chrome, em dois processos:
+//   "tempo de parede"  trechos das fases (leitura, agrupamento de cada bloco,
+//                      simulação, ...), uma linha por thread, em µs desde
+//                      o início do rastro;
+//   "tempo simulado"   uma unidade de tempo da simulação vale um segundo do
+//                      traço. Cada recusa que encerra um grupo é uma marca
+//                      (ids da semente e da candidata recusada, tamanho e
+//                      motivo), e cada corrida é um evento assíncrono do
+//                      início ao fim, com uma marca por parada. Grupos e
+//                      corridas usam os ids das demandas da entrada, então a
+//                      semente de um grupo é o id da sua corrida.
+// Na simulação analítica não há Escalonador, então só há trechos e grupos.
+
+// Abre o rastro que será escrito em caminho ao fim do programa. Chamar uma
+// vez, antes de criar threads. Sem TP2_RASTRO, escreve o erro em std::cerr
+// e retorna false.
+bool iniciarRastro(const char* caminho);
+
+#ifdef TP2_RASTRO
+
+extern bool rastroAtivo;
+
+void rastrearTrecho(const char* nome, double inicio, double fim);
+void rastrearGrupo(double tempo, int semente, int tamanho, int recusada, MotivoRecusa motivo);
+void rastrearCorrida(const Corrida* c);
+void rastrearParada(const Corrida* c, int parada, double tempo);
+void rastrearFim(const Corrida* c);
+
+// Trecho de tempo de parede do escopo em que é declarado (nome deve ser literal)
+class TrechoRastro {
+private:
+    const char* nome;
+    double inicio;
+
+public:
+    explicit TrechoRastro(const char* nome_);
+    ~TrechoRastro();
+
+    TrechoRastro(const TrechoRastro&) = delete;
+    TrechoRastro& operator=(const TrechoRastro&) = delete;
+};
+
+#define RASTRO(sonda) do { if (rastroAtivo) { sonda; } } while (0)
+#define RASTRO_TRECHO(nome) TrechoRastro trechoRastro(nome)
+
+#else
+
+#define RASTRO(sonda) do { } while (0)
+#define RASTRO_TRECHO(nome) do { } while (0)
+
+#endif // TP2_RASTRO
+
+#endif // RASTRO_HPP
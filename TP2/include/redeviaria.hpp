@@ -0,0 +1,140 @@
+#ifndef REDEVIARIA_HPP
+#define REDEVIARIA_HPP
+
+#include <iosfwd>
+#include <mutex>
+
+#include "colunasdemandas.hpp"
+#include "grafoviario.hpp"
+#include "buscabidirecional.hpp"
+
+// Modo viário (--grafo): as distâncias entre origens e destinos passam a ser
+// as da malha (ver GrafoViario) em vez da reta.
+//
+// Cada origem e destino é levado ao nó mais próximo uma vez, no início. O
+// agrupamento pergunta distâncias entre esses nós a uma ConsultaViaria (uma
+// por thread), que guarda as respostas por janela de tempo; ao fechar cada
+// grupo, o Agrupador grava na RedeViaria a distância do trecho que chega a
+// cada parada da rota, e Corrida e simularAnalitico usam esses trechos sem
+// buscar de novo (ver ColunasDemandas::trechosEmbarque).
+
+// Contadores das consultas, somados de todas as threads ao fim do agrupamento
+struct EstatisticasViarias {
+    long long consultas;        // distâncias pedidas entre nós diferentes
+    long long acertos;          // respondidas pelo cache das janelas
+    long long descartesPorReta; // limites decididos pela reta, sem consulta
+    long long buscas;           // buscas bidirecionais feitas
+    long long nosFixados;       // nós fixados somando todas as buscas
+    double tempoBuscas;         // segundos
+    double maiorBusca;
+
+    void zerar();
+    void somar(const EstatisticasViarias& outras);
+
+    // Uma linha com consultas, taxa de acerto e latência das buscas (em µs)
+    void imprimirResumo(std::ostream& out) const;
+};
+
+// Distâncias já calculadas entre pares de nós, em hash aberto.
+// Limpar só troca a geração, sem percorrer o vetor.
+class CacheDistancias {
+private:
+    unsigned long long* chaves;  // (origem << 32) | destino
+    double* valores;
+    unsigned* geracoes;          // entrada válida se igual à geração atual
+    int capacidade;              // potência de 2
+    int quantidade;
+    unsigned geracao;
+
+    void crescer();
+
+public:
+    CacheDistancias();
+    ~CacheDistancias();
+
+    CacheDistancias(const CacheDistancias&) = delete;
+    CacheDistancias& operator=(const CacheDistancias&) = delete;
+
+    bool buscar(unsigned long long chave, double& valor) const;
+    void inserir(unsigned long long chave, double valor);
+    void limpar();
+};
+
+class RedeViaria;
+
+// Consultas de distância de uma thread, com busca e cache próprios.
+//
+// O tempo é dividido em janelas da duração da RedeViaria (δ): um grupo só
+// reúne demandas a menos de δ da semente, então os pares que ele consulta
+// envolvem a janela da semente ou a anterior. O cache guarda só essas duas
+// janelas; ao passar para a seguinte, a mais antiga é descartada.
+class ConsultaViaria {
+private:
+    const RedeViaria& rede;
+    BuscaBidirecional busca;
+    CacheDistancias caches[2];
+    int atual;                   // cache da janela atual; o outro é da anterior
+    double janelaAtual;          // índice da janela atual (NaN antes da primeira)
+
+    EstatisticasViarias estatisticas;
+
+    bool procurar(unsigned long long chave, double& d);
+    double buscar(int u, int v, double limite);
+
+public:
+    explicit ConsultaViaria(const RedeViaria& rede_);
+
+    // Passa para a janela do instante `tempo` (uma semente do agrupamento)
+    void avancarJanela(double tempo);
+
+    // Distância pela malha do nó u ao nó v
+    double distancia(int u, int v);
+
+    // Verdadeiro se a distância de u a v passa de limite. A reta entre os
+    // nós, vezes o fatorReta da malha, decide sem consulta quando já passa,
+    // e a busca para no limite em vez de ir até o destino.
+    bool excede(int u, int v, double limite);
+
+    const EstatisticasViarias& getEstatisticas() const;
+};
+
+// Dados viários compartilhados de um conjunto de demandas: nós de cada origem
+// e destino e os trechos das rotas, indexados como as colunas.
+class RedeViaria {
+private:
+    const GrafoViario& grafo;
+    int numDemandas;
+    int* nosOrigem;
+    int* nosDestino;
+    double* trechosEmbarque;    // trecho que chega à origem (0 para a semente)
+    double* trechosDesembarque; // trecho que chega ao destino
+    double janela;              // duração das janelas do cache
+
+    std::mutex mtx;
+    EstatisticasViarias estatisticas;
+
+public:
+    RedeViaria(const GrafoViario& grafo_, const ColunasDemandas& demandas, double janela_);
+    ~RedeViaria();
+
+    RedeViaria(const RedeViaria&) = delete;
+    RedeViaria& operator=(const RedeViaria&) = delete;
+
+    const GrafoViario& getGrafo() const;
+    double getJanela() const;
+    int getNoOrigem(int i) const;
+    int getNoDestino(int i) const;
+
+    // Trechos que chegam às paradas da demanda i na rota do seu grupo.
+    // Grupos diferentes escrevem demandas diferentes, então threads podem
+    // gravar ao mesmo tempo.
+    void definirTrechos(int i, double embarque, double desembarque);
+    void definirTrechoDesembarque(int i, double desembarque);
+    const double* getTrechosEmbarque() const;
+    const double* getTrechosDesembarque() const;
+
+    void somarEstatisticas(const EstatisticasViarias& outras);  // thread-safe
+    const EstatisticasViarias& getEstatisticas() const;
+};
+
+#endif // REDEVIARIA_HPP
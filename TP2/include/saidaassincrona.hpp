@@ -0,0 +1,76 @@
+#ifndef SAIDAASSINCRONA_HPP
+#define SAIDAASSINCRONA_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+
+// Saída em uma thread escritora dedicada.
+//
+// O produtor (a thread da simulação) escreve em blocos de bytes de um anel
+// de numBlocos blocos; cada bloco cheio é publicado e a thread escritora o
+// copia para o streambuf de destino. A passagem dos blocos é um anel de
+// produtor único e consumidor único: os dois lados só trocam os contadores
+// atômicos de blocos publicados e consumidos. A trava e a variável de
+// condição servem apenas para um lado dormir quando o anel está cheio
+// (produtor) ou vazio (escritora).
+//
+// É um std::streambuf, então pode substituir o de std::cout: tudo que for
+// escrito por operator<< passa pelo anel. Para evitar a formatação do
+// ostream, reservar()/confirmar() dão acesso direto ao bloco atual.
+// flush() (pubsync) publica o bloco parcial sem esperar a escrita.
+class SaidaAssincrona : public std::streambuf {
+private:
+    std::streambuf* destino;
+
+    char* memoria;          // numBlocos blocos de tamBloco bytes
+    int* tamanhos;          // bytes válidos de cada bloco publicado
+    int numBlocos;
+    int tamBloco;
+
+    std::atomic<unsigned> publicados;   // escrito só pelo produtor
+    std::atomic<unsigned> consumidos;   // escrito só pela escritora
+    std::atomic<bool> encerrar;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::atomic<bool> produtorEsperando;
+    std::atomic<bool> escritoraEsperando;
+
+    std::thread escritora;
+
+    char* bloco(unsigned indice) const;
+    void publicar();                 // entrega o bloco atual e abre o próximo
+    void acordar(std::atomic<bool>& esperando);
+    void laco();                     // corpo da thread escritora
+
+protected:
+    int overflow(int c) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+    int sync() override;
+
+public:
+    static const int NUM_BLOCOS_PADRAO = 16;
+    static const int TAM_BLOCO_PADRAO = 64 * 1024;
+
+    explicit SaidaAssincrona(std::streambuf* destino_,
+                             int numBlocos_ = NUM_BLOCOS_PADRAO,
+                             int tamBloco_ = TAM_BLOCO_PADRAO);
+    ~SaidaAssincrona() override;
+
+    SaidaAssincrona(const SaidaAssincrona&) = delete;
+    SaidaAssincrona& operator=(const SaidaAssincrona&) = delete;
+
+    // Ponteiro para pelo menos n bytes livres no bloco atual, ou nullptr se
+    // n não cabe em um bloco. Depois de escrever, chamar confirmar(fim).
+    char* reservar(int n);
+    void confirmar(char* fim);
+
+    // Publica o que falta, espera a escritora terminar e descarrega o destino.
+    // Chamado pelo destrutor se ainda não tiver sido.
+    void fechar();
+};
+
+#endif // SAIDAASSINCRONA_HPP
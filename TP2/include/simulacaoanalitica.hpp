@@ -0,0 +1,56 @@
+#ifndef SIMULACAOANALITICA_HPP
+#define SIMULACAOANALITICA_HPP
+
+#include <iosfwd>
+
+#include "colunasdemandas.hpp"
+#include "poolthreads.hpp"
+#include "metricas.hpp"
+
+class QualidadeServico;
+
+// Simulação sem fila de eventos.
+//
+// As corridas não interagem: o tempo de cada parada é o da anterior mais a
+// distância do trecho dividida por γ, exatamente como o Escalonador calcula
+// ao agendar o próximo evento. Então:
+//  1) o tempo de cada parada de cada corrida é calculado em paralelo;
+//  2) as corridas são ordenadas pela ordem em que o Escalonador com a fila
+//     calendário as finalizaria (merge sort paralelo);
+//  3) as linhas são formatadas em paralelo, em lotes, e escritas em ordem.
+//
+// Empates no tempo final seguem a ordem de chegada, como a fila calendário
+// e o modo contínuo (ver FilaEventos): o evento inserido antes sai antes, e
+// ele é inserido ao processar a parada anterior. Comparam-se então as
+// paradas anteriores, uma a uma para trás; um início de corrida vem antes
+// de um evento da fila no mesmo instante, e dois inícios seguem a ordem dos
+// grupos. A saída é a do Escalonador com --fila calendario, e não a da
+// simulação padrão: a ordem dos empates do heap depende do formato dele e
+// não tem forma fechada, então linhas com o mesmo tempo final podem sair
+// em outra ordem.
+//
+// As rotas são calculadas direto das demandas, sem montar Corridas, então as
+// demandas só são lidas e podem ser compartilhadas entre simulações.
+//
+// Os grupos são demandas[limites[g], limites[g + 1]), como em agruparDemandas.
+// Sem pool (nullptr), tudo roda na thread que chama. Com métricas, os passos
+// 1, 2 e 3 somam seus tempos às fases de montagem, simulação e impressão.
+// Com qualidade, cada tarefa do passo 1 mede seus grupos em uma
+// QualidadeServico própria, somada a ela no fim da tarefa.
+void simularAnalitico(const ColunasDemandas& demandas, const int* limites, int qtdGrupos,
+                      double gama, PoolThreads* pool, std::ostream& out, Metricas* metricas = nullptr,
+                      QualidadeServico* qualidade = nullptr);
+
+// Indicadores agregados de uma simulação
+struct ResumoSimulacao {
+    int qtdCorridas;
+    double distanciaTotal;      // soma das distâncias das rotas
+    double duracaoMedia;        // média de tempoFim - tempoInicio
+    double tempoFimMaximo;      // fim da última corrida
+};
+
+// Calcula o resumo sem ordenar nem imprimir as corridas (sequencial)
+ResumoSimulacao resumirAnalitico(const ColunasDemandas& demandas, const int* limites,
+                                 int qtdGrupos, double gama);
+
+#endif // SIMULACAOANALITICA_HPP
@@ -0,0 +1,69 @@
+#ifndef SIMULACAOREGIOES_HPP
+#define SIMULACAOREGIOES_HPP
+
+#include <iosfwd>
+
+#include "tabelademandas.hpp"
+#include "particaoregioes.hpp"
+#include "parametros.hpp"
+#include "filaeventos.hpp"
+#include "poolthreads.hpp"
+
+class QualidadeServico;
+class RegistroRegiao;
+
+// Simulação dividida por regiões (--regioes).
+//
+// Cada demanda com origem e destino na mesma região vai para a simulação
+// dessa região; as demais (entre regiões ou fora de todas) vão para uma
+// simulação de reserva, a última. Cada simulação tem a sua tabela, o seu
+// agrupamento e o seu Escalonador, e roda em uma tarefa do pool, das
+// maiores para as menores. Demandas de simulações diferentes nunca são
+// agrupadas juntas; numa partição com uma região só que cubra todas as
+// demandas, a saída é a de sempre.
+//
+// Os Escalonadores não imprimem: as linhas de cada um são formatadas em um
+// registro próprio, com o tempo final de cada corrida. No fim, os registros
+// são mesclados pelo tempo final (empates pela ordem das regiões, e dentro
+// de uma região pela ordem em que terminaram) e escritos em um só fluxo.
+class SimulacaoRegioes {
+private:
+    int qtdSimulacoes;            // regiões da partição mais a reserva
+    TabelaDemandas** tabelas;     // demandas de cada simulação (nullptr se nenhuma)
+    RegistroRegiao** registros;   // linhas de cada simulação
+    int* tarefas;                 // simulações com demandas, das maiores para as menores
+    int qtdTarefas;
+
+    long long internas;           // demandas dentro de uma região
+    long long cruzadas;           // demandas da reserva
+
+    void liberarMemoria();
+
+public:
+    SimulacaoRegioes();
+    ~SimulacaoRegioes();
+
+    SimulacaoRegioes(const SimulacaoRegioes&) = delete;
+    SimulacaoRegioes& operator=(const SimulacaoRegioes&) = delete;
+
+    // Copia cada demanda da tabela para a simulação da sua região,
+    // mantendo a ordem da entrada
+    void dividir(const TabelaDemandas& tabela, const ParticaoRegioes& particao);
+
+    // Simulações com ao menos uma demanda (tarefas do pool em simular)
+    int getQtdTarefas() const;
+
+    // Agrupa e simula cada região (sem pool, uma depois da outra). Com
+    // qualidade, cada simulação mede as suas corridas à parte, e as medidas
+    // são somadas a ela no fim.
+    void simular(const Parametros& params, TipoFila fila, bool corrotinas, PoolThreads* pool,
+                 QualidadeServico* qualidade);
+
+    // Escreve as linhas de todas as simulações, mescladas pelo tempo final
+    void escrever(std::ostream& out) const;
+
+    // Uma linha com regiões, demandas internas e cruzadas e a maior simulação
+    void imprimirResumo(std::ostream& out) const;
+};
+
+#endif // SIMULACAOREGIOES_HPP
@@ -0,0 +1,66 @@
+#ifndef TABELADEMANDAS_HPP
+#define TABELADEMANDAS_HPP
+
+#include "colunasdemandas.hpp"
+
+class Corrida;
+
+// Demandas de uma simulação, referenciadas por índice.
+//
+// O que o laço do agrupamento lê (tempo, origem e destino) fica nas colunas
+// quentes (ver ColunasDemandas), sem nenhum outro campo entre os valores.
+// Id, estado e corrida associada ficam em uma tabela fria à parte, usada só
+// quando as corridas são montadas e finalizadas. Corrida e Escalonador
+// guardam o índice da demanda nesta tabela em vez de um objeto Demanda.
+//
+// A tabela pode ser dona de tudo (um único bloco alocado com new[] e
+// preenchido com definir) ou usar colunas e ids de fora, como os do arquivo
+// mapeado (ver ArquivoColunar); nesse caso só estado e corrida são alocados.
+class TabelaDemandas {
+private:
+    int numDemandas;
+    char* bloco;              // tudo o que a tabela aloca
+
+    double* valores;          // colunas quentes próprias (nullptr se externas)
+    int* idsProprios;         // ids próprios (nullptr se externos)
+
+    ColunasDemandas colunas;
+    const int* ids;
+    Corrida** corridas;
+    unsigned char* estados;   // EstadoDemanda, um byte por demanda
+
+    void alocar(bool comDados);
+
+public:
+    explicit TabelaDemandas(int numDemandas_);
+    TabelaDemandas(const ColunasDemandas& colunas_, const int* ids_);
+    ~TabelaDemandas();
+
+    TabelaDemandas(const TabelaDemandas&) = delete;
+    TabelaDemandas& operator=(const TabelaDemandas&) = delete;
+
+    int getNumDemandas() const;
+    const ColunasDemandas& getColunas() const;
+    const int* getIds() const;
+
+    // Preenchimento (só para tabelas donas das colunas)
+    void definir(int i, int id, double tempo, const Ponto& origem, const Ponto& destino);
+    void definir(int i, const Demanda& d);
+    void copiar(int destino, int origem);
+
+    // Nova tabela, dona das suas colunas, com uma cópia das demandas [inicio, fim)
+    TabelaDemandas* copiarTrecho(int inicio, int fim) const;
+
+    // Usa os trechos pela malha nas colunas (ver RedeViaria); os vetores
+    // devem durar mais que a tabela
+    void definirTrechos(const double* embarque, const double* desembarque);
+
+    // Tabela fria
+    int getId(int i) const;
+    EstadoDemanda getEstado(int i) const;
+    void setEstado(int i, EstadoDemanda estado);
+    Corrida* getCorrida(int i) const;
+    void setCorrida(int i, Corrida* corrida);
+};
+
+#endif // TABELADEMANDAS_HPP
@@ -0,0 +1,33 @@
+#ifndef VARREDURA_HPP
+#define VARREDURA_HPP
+
+#include <iosfwd>
+
+#include "colunasdemandas.hpp"
+#include "parametros.hpp"
+#include "poolthreads.hpp"
+
+// Varredura de parâmetros: as mesmas demandas, lidas uma vez, são agrupadas
+// e simuladas para cada conjunto (η, γ, δ, α, β, λ), com um conjunto por
+// tarefa do pool. As demandas são só lidas, então todas as tarefas as
+// compartilham. A simulação é a analítica (ver simularAnalitico): linhas
+// com o mesmo tempo final saem por ordem de chegada, como com --fila
+// calendario, e podem vir em outra ordem que na simulação padrão.
+
+// Lê os conjuntos de parâmetros, um por linha: "η γ δ α β λ". Cada campo
+// pode ser uma lista separada por vírgulas ("0.5,1,2"), e a linha gera todas
+// as combinações (grade). Linhas vazias e as iniciadas por '#' são ignoradas.
+// Retorna um vetor alocado com new[], ou nullptr (após escrever o erro em
+// std::cerr) se alguma linha for inválida ou não houver nenhum conjunto.
+Parametros* lerConfiguracoes(std::istream& in, int& qtdConfiguracoes);
+
+// Executa a varredura e escreve em out uma linha por conjunto, separada por
+// tabulações, com os parâmetros, a quantidade de corridas, a distância total,
+// a duração média e o fim da última corrida. Se prefixoSaida não for nullptr,
+// a saída completa do conjunto k vai para o arquivo "<prefixoSaida><k>.txt".
+// ids são os das demandas, para o rastro do agrupamento.
+void executarVarredura(const ColunasDemandas& demandas, const int* ids,
+                       const Parametros* configuracoes, int qtdConfiguracoes,
+                       PoolThreads* pool, const char* prefixoSaida, std::ostream& out);
+
+#endif // VARREDURA_HPP
@@ -0,0 +1,475 @@
+#include "agrupador.hpp"
+#include "rastro.hpp"
+#include <cmath>
+
+/*
+ * Calcula a distância euclidiana entre dois pontos do plano.
+ * Essa função é usada tanto para distâncias individuais das demandas
+ * quanto para a rota compartilhada construída para um grupo.
+ */
+double distPontos(const Ponto& a, const Ponto& b) {
+    double dx = a.x - b.x;
+    double dy = a.y - b.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+/*
+ * Calcula a distância total percorrida por uma rota compartilhada de um grupo.
+ * O modelo adotado é:
+ *  - visitar todas as origens na ordem em que aparecem no grupo
+ *  - depois visitar os destinos na mesma ordem
+ *
+ * Esse padrão corresponde exatamente ao modelo de rota usado na classe Corrida.
+ */
+double distanciaRota(const ColunasDemandas& demandas, const int* grupo, int tamGrupo) {
+    if (tamGrupo == 0) return 0.0;
+
+    double d = 0.0;
+    Ponto anterior = demandas.origem(grupo[0]);
+
+    // sequência de origens
+    for (int i = 1; i < tamGrupo; ++i) {
+        Ponto atual = demandas.origem(grupo[i]);
+        d += distPontos(anterior, atual);
+        anterior = atual;
+    }
+
+    // última origem -> primeiro destino
+    Ponto primeiroDestino = demandas.destino(grupo[0]);
+    d += distPontos(anterior, primeiroDestino);
+    anterior = primeiroDestino;
+
+    // sequência de destinos
+    for (int i = 1; i < tamGrupo; ++i) {
+        Ponto atual = demandas.destino(grupo[i]);
+        d += distPontos(anterior, atual);
+        anterior = atual;
+    }
+
+    return d;
+}
+
+/*
+ * Soma das distâncias individuais das demandas:
+ * É a distância que os passageiros gastariam se fossem transportados sozinhos.
+ * Usado para calcular a eficiência λ do compartilhamento.
+ */
+double distanciaIndividualTotal(const ColunasDemandas& demandas, const int* grupo, int tamGrupo) {
+    double soma = 0.0;
+    for (int i = 0; i < tamGrupo; ++i) {
+        soma += distPontos(demandas.origem(grupo[i]), demandas.destino(grupo[i]));
+    }
+    return soma;
+}
+
+/*
+ * Faixa com um único ponto.
+ */
+void Faixa::iniciar(const Ponto& p) {
+    minX = maxX = p.x;
+    minY = maxY = p.y;
+}
+
+/*
+ * Inclui um novo ponto na faixa.
+ */
+void Faixa::expandir(const Ponto& p) {
+    if (p.x < minX) minX = p.x;
+    if (p.x > maxX) maxX = p.x;
+    if (p.y < minY) minY = p.y;
+    if (p.y > maxY) maxY = p.y;
+}
+
+/*
+ * Verdadeiro se p está a mais de `limite` de algum ponto da faixa em um dos eixos.
+ * As subtrações são as mesmas feitas em distPontos(p, extremo), então a recusa
+ * coincide exatamente com a que o teste completo daria contra aquele membro.
+ */
+bool Faixa::excede(const Ponto& p, double limite) const {
+    return p.x - minX > limite || maxX - p.x > limite ||
+           p.y - minY > limite || maxY - p.y > limite;
+}
+
+/*
+ * Construtor: guarda as demandas e parâmetros e aloca o vetor do grupo
+ * (e, no modo viário, a consulta de distâncias).
+ */
+Agrupador::Agrupador(const ColunasDemandas& demandas_, const Parametros& params_,
+                     RedeViaria* rede_, int deslocamento_, const int* ids_)
+    : demandas(demandas_),
+      ids(ids_),
+      params(params_),
+      grupo(nullptr),
+      tamGrupo(0),
+      membros(params_.eta),
+      rede(rede_),
+      deslocamento(deslocamento_),
+      consulta(nullptr),
+      cadeiaOrigens(0.0),
+      ligacao(0.0),
+      cadeiaDestinos(0.0),
+      somaIndividual(0.0) {
+    grupo = new int[params.eta > 0 ? params.eta : 1];
+    limiteAlfa.definir(params.alfa);
+    limiteBeta.definir(params.beta);
+    contadores.zerar();
+    if (rede) consulta = new ConsultaViaria(*rede);
+}
+
+/*
+ * Destrutor: libera o vetor temporário do grupo.
+ */
+Agrupador::~Agrupador() {
+    delete[] grupo;
+    delete consulta;
+}
+
+int Agrupador::noOrigem(int i) const {
+    return rede->getNoOrigem(deslocamento + i);
+}
+
+int Agrupador::noDestino(int i) const {
+    return rede->getNoDestino(deslocamento + i);
+}
+
+/*
+ * Restrições espaciais α e β.
+ * As faixas do grupo descartam candidatos que estão longe de algum membro
+ * em um dos eixos; os demais são comparados com todos os membros pelas
+ * distâncias ao quadrado (ver verificarMembros). Nenhum dos dois testes
+ * calcula raízes, exceto bem perto de α ou β.
+ */
+MotivoRecusa Agrupador::verificarDistancias(const Ponto& origem, const Ponto& destino) {
+    if (faixaOrigens.excede(origem, params.alfa)) return RECUSA_ALFA;
+    if (faixaDestinos.excede(destino, params.beta)) return RECUSA_BETA;
+
+    return verificarMembros(membros, tamGrupo, origem, destino, limiteAlfa, limiteBeta,
+                            contadores.raizes);
+}
+
+inline bool Agrupador::recusar(MotivoRecusa motivo, [[maybe_unused]] int j) {
+    ++contadores.recusas[motivo];
+    RASTRO(rastrearGrupo(demandas.tempo(grupo[0]),
+                         ids ? ids[grupo[0]] : deslocamento + grupo[0], tamGrupo,
+                         ids ? ids[j] : deslocamento + j, motivo));
+    return false;
+}
+
+/*
+ * Começa um grupo só com a semente c0 = demandas[i].
+ */
+void Agrupador::iniciarGrupo(int i) {
+    tamGrupo = 0;
+    grupo[tamGrupo++] = i;
+
+    if (rede) {
+        consulta->avancarJanela(demandas.tempo(i));
+        cadeiaOrigens = 0.0;
+        cadeiaDestinos = 0.0;
+        ligacao = consulta->distancia(noOrigem(i), noDestino(i));
+        somaIndividual = ligacao;
+        rede->definirTrechos(deslocamento + i, 0.0, ligacao);
+        return;
+    }
+
+    Ponto origem = demandas.origem(i);
+    Ponto destino = demandas.destino(i);
+    faixaOrigens.iniciar(origem);
+    faixaDestinos.iniciar(destino);
+    membros.definir(0, origem, destino);
+    custo.iniciar(origem, destino);
+    contadores.raizes += 1;
+}
+
+/*
+ * Tenta incluir cj = demandas[j] no grupo atual, verificando a janela δ,
+ * a capacidade η, as distâncias α e β e a eficiência mínima λ.
+ * Retorna false se cj for recusada, o que encerra o grupo.
+ */
+bool Agrupador::tentarAdicionar(int j) {
+    ++contadores.candidatos;
+
+    // restrição da janela temporal δ
+    if (demandas.tempo(j) - demandas.tempo(grupo[0]) >= params.delta) {
+        return recusar(RECUSA_DELTA, j);
+    }
+
+    if (tamGrupo >= params.eta) { // capacidade cheia
+        return recusar(RECUSA_ETA, j);
+    }
+
+    if (rede) return tentarAdicionarViario(j);
+
+    // restrições espaciais α e β
+    Ponto origem = demandas.origem(j);
+    Ponto destino = demandas.destino(j);
+    MotivoRecusa motivo = verificarDistancias(origem, destino);
+    if (motivo != RECUSA_NENHUMA) {
+        return recusar(motivo, j);
+    }
+
+    // verifica eficiência λ com cj incluída: primeiro o limite sem raízes,
+    // depois o custo incremental da rota
+    if (custo.descartaPorLimite(origem, destino, params.lambda)) {
+        ++contadores.recusasLambdaSemRaiz;
+        return recusar(RECUSA_LAMBDA, j);
+    }
+
+    double eficiencia = custo.avaliar(origem, destino);
+    contadores.raizes += 4;
+
+    grupo[tamGrupo] = j;
+    int novoTam = tamGrupo + 1;
+
+    if (CustoRota::ambigua(eficiencia, params.lambda)) {
+        double distRota = distanciaRota(demandas, grupo, novoTam);
+        double distInd = distanciaIndividualTotal(demandas, grupo, novoTam);
+        eficiencia = (distRota > 0.0) ? (distInd / distRota) : 1.0;
+        ++contadores.reavaliacoesCompletas;
+        contadores.raizes += 3 * novoTam - 1;
+    }
+
+    if (eficiencia <= params.lambda) {
+        return recusar(RECUSA_LAMBDA, j);
+    }
+
+    // adiciona a nova demanda ao grupo
+    membros.definir(tamGrupo, origem, destino);
+    tamGrupo = novoTam;
+    custo.confirmar();
+    faixaOrigens.expandir(origem);
+    faixaDestinos.expandir(destino);
+    return true;
+}
+
+/*
+ * Modo viário: α e β contra cada membro (origens e destinos, no sentido do
+ * membro para cj) e a eficiência λ com a rota pela malha, incremental.
+ * Aceita, cj grava os trechos que chegam às suas paradas, e a ligação nova
+ * passa a ser o trecho do primeiro destino.
+ */
+bool Agrupador::tentarAdicionarViario(int j) {
+    int origem = noOrigem(j);
+    int destino = noDestino(j);
+
+    for (int k = 0; k < tamGrupo; ++k) {
+        if (consulta->excede(noOrigem(grupo[k]), origem, params.alfa)) {
+            return recusar(RECUSA_ALFA, j);
+        }
+        if (consulta->excede(noDestino(grupo[k]), destino, params.beta)) {
+            return recusar(RECUSA_BETA, j);
+        }
+    }
+
+    int ultimo = grupo[tamGrupo - 1];
+    double embarque = consulta->distancia(noOrigem(ultimo), origem);
+    double desembarque = consulta->distancia(noDestino(ultimo), destino);
+    double novaLigacao = consulta->distancia(origem, noDestino(grupo[0]));
+    double individual = consulta->distancia(origem, destino);
+
+    double distRota = (cadeiaOrigens + embarque) + novaLigacao + (cadeiaDestinos + desembarque);
+    double distInd = somaIndividual + individual;
+    double eficiencia = (distRota > 0.0) ? (distInd / distRota) : 1.0;
+
+    // um trecho sem caminho na malha deixa a rota infinita
+    if (!std::isfinite(distRota) || eficiencia <= params.lambda) {
+        return recusar(RECUSA_LAMBDA, j);
+    }
+
+    grupo[tamGrupo++] = j;
+    cadeiaOrigens += embarque;
+    cadeiaDestinos += desembarque;
+    ligacao = novaLigacao;
+    somaIndividual = distInd;
+    rede->definirTrechos(deslocamento + j, embarque, desembarque);
+    rede->definirTrechoDesembarque(deslocamento + grupo[0], ligacao);
+    return true;
+}
+
+/*
+ * Forma o grupo guloso de c0 = demandas[i]: as demandas seguintes entram
+ * enquanto forem aceitas, e a primeira recusada será a próxima semente.
+ */
+int Agrupador::formarGrupo(int i) {
+    iniciarGrupo(i);
+    for (int j = i + 1; j < demandas.numDemandas; ++j) {
+        if (!tentarAdicionar(j)) break;
+    }
+    return i + tamGrupo;
+}
+
+int Agrupador::getTamGrupo() const {
+    return tamGrupo;
+}
+
+const int* Agrupador::getGrupo() const {
+    return grupo;
+}
+
+const ContadoresAgrupamento& Agrupador::getContadores() const {
+    return contadores;
+}
+
+const ConsultaViaria* Agrupador::getConsulta() const {
+    return consulta;
+}
+
+/*
+ * Monta a Corrida correspondente a um grupo,
+ * construindo a rota básica e os trechos.
+ */
+Corrida* montarCorrida(TabelaDemandas& demandas, int inicio, int fim) {
+    Corrida* corrida = new Corrida(&demandas, fim - inicio);
+    for (int k = inicio; k < fim; ++k) {
+        corrida->adicionarDemanda(k);
+    }
+
+    corrida->construirRotaBasica();
+    corrida->calcularTrechosEDistancia();
+    return corrida;
+}
+
+// Trecho contíguo de demandas agrupado de forma independente
+struct BlocoAgrupamento {
+    int inicio;
+    int fim;
+    int* inicios;         // primeira demanda de cada grupo do bloco, em ordem
+    int qtdGrupos;
+};
+
+// Dados compartilhados pelas tarefas de agrupamento (somente leitura)
+struct ContextoAgrupamento {
+    ColunasDemandas demandas;
+    const Parametros* params;
+    BlocoAgrupamento* blocos;
+    ContadoresAgrupamento* contadores;  // um por bloco (nullptr se não coletados)
+    RedeViaria* rede;                   // modo viário (nullptr no euclidiano)
+    const int* ids;                     // ids das demandas (nullptr se não dados)
+};
+
+/*
+ * Tarefa do pool: agrupa um bloco com seu próprio Agrupador e anota
+ * onde começa cada grupo (em índices globais).
+ * O Agrupador enxerga só o bloco, então o laço termina no fim dele em vez
+ * de parar na janela δ, o que dá o mesmo resultado pelo corte escolhido.
+ */
+static void agruparBloco(int indice, void* contexto) {
+    RASTRO_TRECHO("bloco de agrupamento");
+    ContextoAgrupamento* ctx = static_cast<ContextoAgrupamento*>(contexto);
+    BlocoAgrupamento& bloco = ctx->blocos[indice];
+
+    int n = bloco.fim - bloco.inicio;
+    Agrupador agrupador(ctx->demandas.trecho(bloco.inicio, n), *ctx->params,
+                        ctx->rede, bloco.inicio, ctx->ids ? ctx->ids + bloco.inicio : nullptr);
+
+    bloco.inicios = new int[n > 0 ? n : 1];
+    bloco.qtdGrupos = 0;
+    for (int i = 0; i < n; ) {
+        bloco.inicios[bloco.qtdGrupos++] = bloco.inicio + i;
+        i = agrupador.formarGrupo(i);
+    }
+
+    if (ctx->contadores) {
+        ctx->contadores[indice] = agrupador.getContadores();
+    }
+    if (ctx->rede) {
+        ctx->rede->somarEstatisticas(agrupador.getConsulta()->getEstatisticas());
+    }
+}
+
+/*
+ * Divide a sequência em blocos cortados apenas onde nenhum grupo pode passar:
+ * a demanda k inicia um bloco se t[k] está a pelo menos δ de todas as
+ * solicitações anteriores (usa o máximo, sem supor ordenação). Os blocos têm
+ * ao menos `alvo` demandas para que o número de tarefas fique proporcional
+ * ao número de threads.
+ */
+static int dividirEmBlocos(const ColunasDemandas& demandas, double delta,
+                           int alvo, BlocoAgrupamento* blocos) {
+    int numDemandas = demandas.numDemandas;
+    int qtdBlocos = 0;
+    int inicio = 0;
+    double maiorTempo = demandas.tempo(0);
+
+    for (int k = 1; k < numDemandas; ++k) {
+        double t = demandas.tempo(k);
+        if (t - maiorTempo >= delta && k - inicio >= alvo) {
+            blocos[qtdBlocos].inicio = inicio;
+            blocos[qtdBlocos].fim = k;
+            ++qtdBlocos;
+            inicio = k;
+        }
+        if (t > maiorTempo) maiorTempo = t;
+    }
+
+    blocos[qtdBlocos].inicio = inicio;
+    blocos[qtdBlocos].fim = numDemandas;
+    return qtdBlocos + 1;
+}
+
+/*
+ * Agrupamento completo, sequencial ou em paralelo por blocos.
+ */
+int* agruparDemandas(const ColunasDemandas& demandas, const Parametros& params,
+                     PoolThreads* pool, int& qtdGrupos, ContadoresAgrupamento* contadores,
+                     RedeViaria* rede, const int* ids) {
+    RASTRO_TRECHO("agrupamento");
+    int numDemandas = demandas.numDemandas;
+    qtdGrupos = 0;
+    if (numDemandas <= 0) return nullptr;
+
+    // vários blocos por thread equilibram blocos de tamanhos diferentes
+    int numThreads = pool ? pool->getNumThreads() : 1;
+    int alvo = numDemandas;
+    if (numThreads > 1) {
+        alvo = numDemandas / (8 * numThreads);
+        if (alvo < 1) alvo = 1;
+    }
+
+    BlocoAgrupamento* blocos = new BlocoAgrupamento[numDemandas];
+    int qtdBlocos = dividirEmBlocos(demandas, params.delta, alvo, blocos);
+
+    ContextoAgrupamento ctx;
+    ctx.demandas = demandas;
+    ctx.params = &params;
+    ctx.blocos = blocos;
+    ctx.contadores = contadores ? new ContadoresAgrupamento[qtdBlocos] : nullptr;
+    ctx.rede = rede;
+    ctx.ids = ids;
+
+    if (pool && qtdBlocos > 1) {
+        pool->executar(qtdBlocos, agruparBloco, &ctx);
+    } else {
+        for (int b = 0; b < qtdBlocos; ++b) {
+            agruparBloco(b, &ctx);
+        }
+    }
+
+    // concatena os grupos dos blocos na ordem original
+    int total = 0;
+    for (int b = 0; b < qtdBlocos; ++b) {
+        total += blocos[b].qtdGrupos;
+    }
+
+    int* limites = new int[total + 1];
+    for (int b = 0; b < qtdBlocos; ++b) {
+        for (int g = 0; g < blocos[b].qtdGrupos; ++g) {
+            limites[qtdGrupos++] = blocos[b].inicios[g];
+        }
+        delete[] blocos[b].inicios;
+    }
+    limites[qtdGrupos] = numDemandas;
+    delete[] blocos;
+
+    if (contadores) {
+        for (int b = 0; b < qtdBlocos; ++b) {
+            contadores->somar(ctx.contadores[b]);
+        }
+        for (int g = 0; g < qtdGrupos; ++g) {
+            contadores->registrarGrupo(limites[g + 1] - limites[g]);
+        }
+        delete[] ctx.contadores;
+    }
+
+    return limites;
+}
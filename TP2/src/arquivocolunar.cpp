@@ -0,0 +1,200 @@
+#include "arquivocolunar.hpp"
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char ASSINATURA[8] = {'T', 'P', '2', 'C', 'O', 'L', 'S', '\0'};
+static const std::uint32_t VERSAO = 1;
+static const std::int64_t ALINHAMENTO = 64;
+
+// Colunas na ordem em que são gravadas
+enum Coluna {
+    COLUNA_IDS,
+    COLUNA_TEMPOS,
+    COLUNA_ORIGEM_X,
+    COLUNA_ORIGEM_Y,
+    COLUNA_DESTINO_X,
+    COLUNA_DESTINO_Y,
+    NUM_COLUNAS
+};
+
+struct CabecalhoColunar {
+    char assinatura[8];
+    std::uint32_t versao;
+    std::int32_t eta;
+    double gama;
+    double delta;
+    double alfa;
+    double beta;
+    double lambda;
+    std::int64_t numDemandas;
+    std::int64_t deslocamentos[NUM_COLUNAS];
+    char reservado[16];
+};
+
+static_assert(sizeof(CabecalhoColunar) == 128, "cabecalho do arquivo colunar mudou de tamanho");
+
+/*
+ * Bytes de cada valor da coluna.
+ */
+static std::int64_t larguraColuna(int c) {
+    return (c == COLUNA_IDS) ? static_cast<std::int64_t>(sizeof(std::int32_t))
+                             : static_cast<std::int64_t>(sizeof(double));
+}
+
+static std::int64_t alinhar(std::int64_t posicao) {
+    return (posicao + ALINHAMENTO - 1) / ALINHAMENTO * ALINHAMENTO;
+}
+
+ArquivoColunar::ArquivoColunar()
+    : mapa(nullptr),
+      tamanho(0),
+      ids(nullptr) {
+    std::memset(&params, 0, sizeof(params));
+    std::memset(&colunas, 0, sizeof(colunas));
+}
+
+ArquivoColunar::~ArquivoColunar() {
+    if (mapa) munmap(mapa, tamanho);
+}
+
+/*
+ * Mapeia o arquivo somente para leitura e aponta as colunas para dentro dele,
+ * depois de conferir que o cabeçalho e todas as colunas cabem no arquivo.
+ */
+bool ArquivoColunar::abrir(const char* caminho) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "nao foi possivel abrir " << caminho << "\n";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(CabecalhoColunar))) {
+        std::cerr << caminho << " nao e um arquivo de demandas em colunas\n";
+        close(fd);
+        return false;
+    }
+
+    tamanho = static_cast<std::size_t>(info.st_size);
+    mapa = mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // o mapeamento continua válido
+    if (mapa == MAP_FAILED) {
+        mapa = nullptr;
+        std::cerr << "nao foi possivel mapear " << caminho << "\n";
+        return false;
+    }
+    // agrupamento e simulação percorrem as colunas do início ao fim
+    madvise(mapa, tamanho, MADV_SEQUENTIAL);
+
+    const char* base = static_cast<const char*>(mapa);
+    CabecalhoColunar cab;
+    std::memcpy(&cab, base, sizeof(cab));
+
+    bool valido = std::memcmp(cab.assinatura, ASSINATURA, sizeof(ASSINATURA)) == 0 &&
+                  cab.versao == VERSAO &&
+                  cab.numDemandas >= 0 && cab.numDemandas <= INT_MAX;
+    for (int c = 0; c < NUM_COLUNAS && valido; ++c) {
+        std::int64_t inicio = cab.deslocamentos[c];
+        valido = inicio >= static_cast<std::int64_t>(sizeof(cab)) &&
+                 inicio % ALINHAMENTO == 0 &&
+                 inicio + cab.numDemandas * larguraColuna(c) <=
+                     static_cast<std::int64_t>(tamanho);
+    }
+    if (!valido) {
+        std::cerr << caminho << " nao e um arquivo de demandas em colunas (versao "
+                  << VERSAO << ")\n";
+        munmap(mapa, tamanho);
+        mapa = nullptr;
+        return false;
+    }
+
+    params.eta = cab.eta;
+    params.gama = cab.gama;
+    params.delta = cab.delta;
+    params.alfa = cab.alfa;
+    params.beta = cab.beta;
+    params.lambda = cab.lambda;
+
+    colunas.numDemandas = static_cast<int>(cab.numDemandas);
+    colunas.tempos = reinterpret_cast<const double*>(base + cab.deslocamentos[COLUNA_TEMPOS]);
+    colunas.origemX = reinterpret_cast<const double*>(base + cab.deslocamentos[COLUNA_ORIGEM_X]);
+    colunas.origemY = reinterpret_cast<const double*>(base + cab.deslocamentos[COLUNA_ORIGEM_Y]);
+    colunas.destinoX = reinterpret_cast<const double*>(base + cab.deslocamentos[COLUNA_DESTINO_X]);
+    colunas.destinoY = reinterpret_cast<const double*>(base + cab.deslocamentos[COLUNA_DESTINO_Y]);
+    ids = reinterpret_cast<const int*>(base + cab.deslocamentos[COLUNA_IDS]);
+    return true;
+}
+
+const Parametros& ArquivoColunar::getParametros() const {
+    return params;
+}
+
+const ColunasDemandas& ArquivoColunar::getColunas() const {
+    return colunas;
+}
+
+const int* ArquivoColunar::getIds() const {
+    return ids;
+}
+
+/*
+ * Grava o cabeçalho e, em seguida, cada coluna no próximo múltiplo de 64
+ * bytes (o intervalo é preenchido com zeros).
+ */
+bool gravarArquivoColunar(const char* caminho, const Parametros& params,
+                          const TabelaDemandas& demandas) {
+    std::ofstream arquivo(caminho, std::ios::binary | std::ios::trunc);
+    if (!arquivo) {
+        std::cerr << "nao foi possivel criar " << caminho << "\n";
+        return false;
+    }
+
+    const ColunasDemandas& colunas = demandas.getColunas();
+    const void* dados[NUM_COLUNAS] = {demandas.getIds(), colunas.tempos,
+                                      colunas.origemX, colunas.origemY,
+                                      colunas.destinoX, colunas.destinoY};
+
+    CabecalhoColunar cab;
+    std::memset(&cab, 0, sizeof(cab));
+    std::memcpy(cab.assinatura, ASSINATURA, sizeof(ASSINATURA));
+    cab.versao = VERSAO;
+    cab.eta = params.eta;
+    cab.gama = params.gama;
+    cab.delta = params.delta;
+    cab.alfa = params.alfa;
+    cab.beta = params.beta;
+    cab.lambda = params.lambda;
+    cab.numDemandas = colunas.numDemandas;
+
+    std::int64_t posicao = sizeof(cab);
+    for (int c = 0; c < NUM_COLUNAS; ++c) {
+        cab.deslocamentos[c] = alinhar(posicao);
+        posicao = cab.deslocamentos[c] + cab.numDemandas * larguraColuna(c);
+    }
+
+    arquivo.write(reinterpret_cast<const char*>(&cab), sizeof(cab));
+    posicao = sizeof(cab);
+
+    static const char ZEROS[ALINHAMENTO] = {};
+    for (int c = 0; c < NUM_COLUNAS; ++c) {
+        arquivo.write(ZEROS, cab.deslocamentos[c] - posicao);
+        std::int64_t bytes = cab.numDemandas * larguraColuna(c);
+        arquivo.write(static_cast<const char*>(dados[c]), bytes);
+        posicao = cab.deslocamentos[c] + bytes;
+    }
+
+    arquivo.flush();
+    if (!arquivo) {
+        std::cerr << "erro ao gravar " << caminho << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,128 @@
+#include "buscabidirecional.hpp"
+#include <cmath>
+
+static const double INFINITO = INFINITO_BUSCA;
+
+BuscaBidirecional::BuscaBidirecional(const GrafoViario& grafo_)
+    : grafo(grafo_),
+      distIda(nullptr),
+      distVolta(nullptr),
+      tocadosIda(nullptr),
+      tocadosVolta(nullptr),
+      qtdTocadosIda(0),
+      qtdTocadosVolta(0),
+      filaIda(64),
+      filaVolta(64),
+      nosFixados(0),
+      fatorReta(grafo_.getFatorReta()),
+      pontoOrigem{0.0, 0.0},
+      pontoDestino{0.0, 0.0} {
+    int n = grafo.getNumNos();
+    distIda = new double[n];
+    distVolta = new double[n];
+    tocadosIda = new int[n];
+    tocadosVolta = new int[n];
+    for (int i = 0; i < n; ++i) {
+        distIda[i] = INFINITO;
+        distVolta[i] = INFINITO;
+    }
+}
+
+BuscaBidirecional::~BuscaBidirecional() {
+    delete[] distIda;
+    delete[] distVolta;
+    delete[] tocadosIda;
+    delete[] tocadosVolta;
+}
+
+/*
+ * Devolve ao infinito só o que a consulta anterior tocou.
+ */
+void BuscaBidirecional::reiniciar() {
+    for (int k = 0; k < qtdTocadosIda; ++k) distIda[tocadosIda[k]] = INFINITO;
+    for (int k = 0; k < qtdTocadosVolta; ++k) distVolta[tocadosVolta[k]] = INFINITO;
+    qtdTocadosIda = 0;
+    qtdTocadosVolta = 0;
+    filaIda.limpar();
+    filaVolta.limpar();
+}
+
+/*
+ * Potencial de ida do nó v: metade do quanto v está mais perto (pela reta,
+ * vezes o fatorReta) do destino do que da origem. A volta usa o oposto.
+ */
+double BuscaBidirecional::potencial(int v) const {
+    Ponto p = grafo.getPonto(v);
+    double ox = p.x - pontoOrigem.x, oy = p.y - pontoOrigem.y;
+    double dx = p.x - pontoDestino.x, dy = p.y - pontoDestino.y;
+    return 0.5 * fatorReta * (std::sqrt(dx * dx + dy * dy) - std::sqrt(ox * ox + oy * oy));
+}
+
+/*
+ * Cada lado fixa o nó de menor chave da sua fila e relaxa os arcos dele;
+ * um arco que chega a um nó já alcançado pelo outro lado fecha um caminho
+ * candidato. Quando uma fila esvazia, todos os nós alcançáveis daquele lado
+ * já foram fixados e o melhor candidato é o menor caminho.
+ *
+ * A chave de v é a distância desde a ponta mais o potencial do lado (A*):
+ * com o mesmo potencial, de sinais opostos, nos dois lados, um caminho que
+ * passa por v tem a soma das chaves igual ao seu comprimento, então todo
+ * caminho ainda não visto mede pelo menos a soma das menores chaves. A busca
+ * para quando essa soma alcança o melhor caminho ou passa do limite.
+ */
+double BuscaBidirecional::distancia(int origem, int destino, double limite) {
+    if (origem == destino) return 0.0;
+    reiniciar();
+    pontoOrigem = grafo.getPonto(origem);
+    pontoDestino = grafo.getPonto(destino);
+
+    distIda[origem] = 0.0;
+    tocadosIda[qtdTocadosIda++] = origem;
+    filaIda.inserir(potencial(origem), origem);
+    distVolta[destino] = 0.0;
+    tocadosVolta[qtdTocadosVolta++] = destino;
+    filaVolta.inserir(-potencial(destino), destino);
+
+    double melhor = INFINITO;
+    while (!filaIda.vazio() && !filaVolta.vazio()) {
+        double topoIda, topoVolta;
+        int no;
+        filaIda.obterMinimo(topoIda, no);
+        filaVolta.obterMinimo(topoVolta, no);
+        if (topoIda + topoVolta >= melhor || topoIda + topoVolta > limite) break;
+
+        bool ida = topoIda <= topoVolta;
+        MinHeap& fila = ida ? filaIda : filaVolta;
+        double* dist = ida ? distIda : distVolta;
+        const double* distOutro = ida ? distVolta : distIda;
+        int* tocados = ida ? tocadosIda : tocadosVolta;
+        int& qtdTocados = ida ? qtdTocadosIda : qtdTocadosVolta;
+        const int* inicio = ida ? grafo.getInicioSaidas() : grafo.getInicioEntradas();
+        const int* vizinhos = ida ? grafo.getDestinosSaidas() : grafo.getOrigensEntradas();
+        const double* pesos = ida ? grafo.getPesosSaidas() : grafo.getPesosEntradas();
+
+        double sinal = ida ? 1.0 : -1.0;
+
+        double chave;
+        fila.removerMinimo(chave, no);
+        double d = dist[no];
+        if (chave > d + sinal * potencial(no)) continue;  // entrada antiga
+        ++nosFixados;
+
+        for (int a = inicio[no]; a < inicio[no + 1]; ++a) {
+            int v = vizinhos[a];
+            double nd = d + pesos[a];
+            if (nd < dist[v]) {
+                if (dist[v] == INFINITO) tocados[qtdTocados++] = v;
+                dist[v] = nd;
+                fila.inserir(nd + sinal * potencial(v), v);
+                if (nd + distOutro[v] < melhor) melhor = nd + distOutro[v];
+            }
+        }
+    }
+    return melhor;
+}
+
+long long BuscaBidirecional::getNosFixados() const {
+    return nosFixados;
+}
@@ -0,0 +1,14 @@
+#include "colunasdemandas.hpp"
+
+ColunasDemandas ColunasDemandas::trecho(int inicio, int qtd) const {
+    ColunasDemandas t;
+    t.numDemandas = qtd;
+    t.tempos = tempos + inicio;
+    t.origemX = origemX + inicio;
+    t.origemY = origemY + inicio;
+    t.destinoX = destinoX + inicio;
+    t.destinoY = destinoY + inicio;
+    t.trechosEmbarque = trechosEmbarque ? trechosEmbarque + inicio : nullptr;
+    t.trechosDesembarque = trechosDesembarque ? trechosDesembarque + inicio : nullptr;
+    return t;
+}
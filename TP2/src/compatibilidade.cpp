@@ -0,0 +1,174 @@
+#include "compatibilidade.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COMPATIBILIDADE_AVX2 1
+#endif
+
+// Largura relativa da faixa duvidosa em torno de limite²; muito maior que o
+// erro de arredondamento de limite² e de d², e estreita o bastante para que
+// quase nenhum candidato caia nela
+static const double FOLGA_RELATIVA = 0x1p-40;
+
+// Abaixo disso limite² pode ser subnormal e perder precisão relativa
+static const double MENOR_QUADRADO_CONFIAVEL = 0x1p-1000;
+
+/*
+ * Calcula os dois valores de decisão. Limites negativos recusam qualquer
+ * distância; limites cujo quadrado não é confiável (enormes, minúsculos ou
+ * NaN) deixam tudo na faixa duvidosa, decidido pela raiz.
+ */
+void LimiteQuadrado::definir(double limite_) {
+    limite = limite_;
+    double quadrado = limite * limite;
+
+    if (limite < 0.0) {
+        aceita = -1.0;
+        recusa = -1.0;
+    } else if (limite == 0.0) {
+        aceita = 0.0;
+        recusa = 0.0;
+    } else if (quadrado >= MENOR_QUADRADO_CONFIAVEL && std::isfinite(quadrado)) {
+        aceita = quadrado * (1.0 - FOLGA_RELATIVA);
+        recusa = quadrado * (1.0 + FOLGA_RELATIVA);
+    } else {
+        aceita = NAN;
+        recusa = NAN;
+    }
+}
+
+bool LimiteQuadrado::excede(double d2, long long& raizes) const {
+    if (d2 <= aceita) return false;
+    if (d2 >= recusa) return true;
+    ++raizes;
+    return std::sqrt(d2) > limite;
+}
+
+/*
+ * Construtor: um bloco zerado para as quatro colunas.
+ */
+MembrosGrupo::MembrosGrupo(int capacidadeMinima)
+    : memoria(nullptr),
+      capacidade(0) {
+    if (capacidadeMinima < 1) capacidadeMinima = 1;
+    capacidade = (capacidadeMinima + 3) / 4 * 4;
+
+    memoria = new double[4 * capacidade]();
+    origemX = memoria;
+    origemY = memoria + capacidade;
+    destinoX = memoria + 2 * capacidade;
+    destinoY = memoria + 3 * capacidade;
+}
+
+MembrosGrupo::~MembrosGrupo() {
+    delete[] memoria;
+}
+
+void MembrosGrupo::definir(int k, const Ponto& origem, const Ponto& destino) {
+    origemX[k] = origem.x;
+    origemY[k] = origem.y;
+    destinoX[k] = destino.x;
+    destinoY[k] = destino.y;
+}
+
+/*
+ * Membros [inicio, fim), um a um. As contas de d² são as de distPontos.
+ */
+static MotivoRecusa verificarTrecho(const MembrosGrupo& membros, int inicio, int fim,
+                                    const Ponto& origem, const Ponto& destino,
+                                    const LimiteQuadrado& alfa, const LimiteQuadrado& beta,
+                                    long long& raizes) {
+    for (int k = inicio; k < fim; ++k) {
+        double ox = origem.x - membros.origemX[k];
+        double oy = origem.y - membros.origemY[k];
+        double dx = destino.x - membros.destinoX[k];
+        double dy = destino.y - membros.destinoY[k];
+        if (alfa.excede(ox * ox + oy * oy, raizes)) return RECUSA_ALFA;
+        if (beta.excede(dx * dx + dy * dy, raizes)) return RECUSA_BETA;
+    }
+    return RECUSA_NENHUMA;
+}
+
+MotivoRecusa verificarMembrosEscalar(const MembrosGrupo& membros, int qtdMembros,
+                                     const Ponto& origem, const Ponto& destino,
+                                     const LimiteQuadrado& alfa, const LimiteQuadrado& beta,
+                                     long long& raizes) {
+    return verificarTrecho(membros, 0, qtdMembros, origem, destino, alfa, beta, raizes);
+}
+
+#ifdef COMPATIBILIDADE_AVX2
+/*
+ * Quatro membros por vez: se todos estão certamente dentro de α e β, segue;
+ * senão os quatro são refeitos um a um, o que dá o primeiro membro recusado
+ * e o motivo na ordem da versão escalar. Multiplicações e somas são feitas
+ * separadas (sem FMA), então d² é o mesmo da versão escalar.
+ */
+__attribute__((target("avx2")))
+static MotivoRecusa verificarMembrosAvx2(const MembrosGrupo& membros, int qtdMembros,
+                                         const Ponto& origem, const Ponto& destino,
+                                         const LimiteQuadrado& alfa, const LimiteQuadrado& beta,
+                                         long long& raizes) {
+    const __m256d cox = _mm256_set1_pd(origem.x);
+    const __m256d coy = _mm256_set1_pd(origem.y);
+    const __m256d cdx = _mm256_set1_pd(destino.x);
+    const __m256d cdy = _mm256_set1_pd(destino.y);
+    const __m256d aceitaAlfa = _mm256_set1_pd(alfa.aceita);
+    const __m256d aceitaBeta = _mm256_set1_pd(beta.aceita);
+
+    for (int k = 0; k < qtdMembros; k += 4) {
+        __m256d ox = _mm256_sub_pd(cox, _mm256_loadu_pd(membros.origemX + k));
+        __m256d oy = _mm256_sub_pd(coy, _mm256_loadu_pd(membros.origemY + k));
+        __m256d dx = _mm256_sub_pd(cdx, _mm256_loadu_pd(membros.destinoX + k));
+        __m256d dy = _mm256_sub_pd(cdy, _mm256_loadu_pd(membros.destinoY + k));
+
+        __m256d quadOrigem = _mm256_add_pd(_mm256_mul_pd(ox, ox), _mm256_mul_pd(oy, oy));
+        __m256d quadDestino = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+
+        __m256d dentro = _mm256_and_pd(_mm256_cmp_pd(quadOrigem, aceitaAlfa, _CMP_LE_OQ),
+                                       _mm256_cmp_pd(quadDestino, aceitaBeta, _CMP_LE_OQ));
+
+        int fim = (k + 4 < qtdMembros) ? k + 4 : qtdMembros;
+        int validos = (1 << (fim - k)) - 1;   // posições além do grupo não contam
+        if ((_mm256_movemask_pd(dentro) & validos) != validos) {
+            MotivoRecusa motivo = verificarTrecho(membros, k, fim, origem, destino,
+                                                  alfa, beta, raizes);
+            if (motivo != RECUSA_NENHUMA) return motivo;
+        }
+    }
+    return RECUSA_NENHUMA;
+}
+#endif
+
+typedef MotivoRecusa (*FuncaoVerificacao)(const MembrosGrupo&, int, const Ponto&, const Ponto&,
+                                          const LimiteQuadrado&, const LimiteQuadrado&,
+                                          long long&);
+
+/*
+ * Escolhe a versão uma vez, na primeira chamada, pelo processador em uso.
+ */
+static FuncaoVerificacao escolherVerificacao() {
+#ifdef COMPATIBILIDADE_AVX2
+    if (__builtin_cpu_supports("avx2")) return verificarMembrosAvx2;
+#endif
+    return verificarMembrosEscalar;
+}
+
+static FuncaoVerificacao verificacaoEscolhida() {
+    static const FuncaoVerificacao funcao = escolherVerificacao();
+    return funcao;
+}
+
+MotivoRecusa verificarMembros(const MembrosGrupo& membros, int qtdMembros,
+                              const Ponto& origem, const Ponto& destino,
+                              const LimiteQuadrado& alfa, const LimiteQuadrado& beta,
+                              long long& raizes) {
+    return verificacaoEscolhida()(membros, qtdMembros, origem, destino, alfa, beta, raizes);
+}
+
+const char* implementacaoCompatibilidade() {
+#ifdef COMPATIBILIDADE_AVX2
+    if (verificacaoEscolhida() == verificarMembrosAvx2) return "avx2";
+#endif
+    return "escalar";
+}
@@ -1,67 +1,90 @@
 #include "corrida.hpp"
+#include "formatacao.hpp"
 #include <iostream>
+#include <new>
 
-// Construtor: inicializa vetores dinâmicos de demandas, paradas e trechos.
-// Cada capacidade inicial é derivada do número de demandas previsto.
-Corrida::Corrida(int capacidadeInicialDemandas)
-    : demandas(nullptr),
+// Construtor: usa os vetores internos se a capacidade inicial couber neles;
+// caso contrário, aloca um único bloco externo para demandas, paradas e trechos.
+Corrida::Corrida(TabelaDemandas* tabela_, int capacidadeInicialDemandas)
+    : tabela(tabela_),
+      demandas(demandasInternas),
       qtdDemandas(0),
-      capacidadeDemandas(capacidadeInicialDemandas),
-      paradas(nullptr),
+      capacidadeDemandas(CAPACIDADE_INTERNA),
+      paradas(paradasInternas),
       qtdParadas(0),
-      capacidadeParadas(2 * capacidadeInicialDemandas),
-      trechos(nullptr),
+      trechos(trechosInternos),
       qtdTrechos(0),
-      capacidadeTrechos(2 * capacidadeInicialDemandas),
       distanciaTotal(0.0),
       tempoInicio(0.0),
-      tempoFim(0.0) {
-
-    if (capacidadeDemandas > 0) {
-        demandas = new Demanda*[capacidadeDemandas];
-    }
-    if (capacidadeParadas > 0) {
-        paradas = new Parada*[capacidadeParadas];
-    }
-    if (capacidadeTrechos > 0) {
-        trechos = new Trecho*[capacidadeTrechos];
+      tempoFim(0.0),
+      blocoExterno(nullptr),
+      donaDaTabela(false),
+      instanteEntrada(0.0),
+      veiculo(-1) {
+
+    if (capacidadeInicialDemandas > CAPACIDADE_INTERNA) {
+        alocarBloco(capacidadeInicialDemandas);
     }
 }
 
-// Destrutor: libera todas as estruturas alocadas dinamicamente
+// Destrutor: paradas e trechos não têm recursos próprios,
+// então basta liberar o bloco externo e a tabela, se for dona dela
 Corrida::~Corrida() {
-    if (paradas) {
-        for (int i = 0; i < qtdParadas; ++i) {
-            delete paradas[i];
-        }
+    delete[] blocoExterno;
+    if (donaDaTabela) delete tabela;
+}
+
+// Reserva um bloco com espaço para `capacidade` demandas e o dobro de paradas
+// e trechos, e aponta os três vetores para ele. As demandas já adicionadas são
+// copiadas; paradas e trechos antigos são descartados, pois a rota deixa de
+// valer quando o grupo muda (construirRotaBasica deve ser chamada de novo).
+void Corrida::alocarBloco(int capacidade) {
+    size_t bytesParadas = sizeof(Parada) * 2 * capacidade;
+    size_t bytesTrechos = sizeof(Trecho) * 2 * capacidade;
+    size_t bytesDemandas = sizeof(int) * capacidade;
+    char* bloco = new char[bytesParadas + bytesTrechos + bytesDemandas];
+
+    Parada* novasParadas = reinterpret_cast<Parada*>(bloco);
+    Trecho* novosTrechos = reinterpret_cast<Trecho*>(bloco + bytesParadas);
+    int* novasDemandas = reinterpret_cast<int*>(bloco + bytesParadas + bytesTrechos);
+
+    for (int i = 0; i < 2 * capacidade; ++i) {
+        new (&novasParadas[i]) Parada();
+        new (&novosTrechos[i]) Trecho();
     }
-    if (trechos) {
-        for (int i = 0; i < qtdTrechos; ++i) {
-            delete trechos[i];
-        }
+    for (int i = 0; i < qtdDemandas; ++i) {
+        novasDemandas[i] = demandas[i];
     }
-    delete[] demandas;
-    delete[] paradas;
-    delete[] trechos;
+
+    delete[] blocoExterno;
+    blocoExterno = bloco;
+    demandas = novasDemandas;
+    paradas = novasParadas;
+    trechos = novosTrechos;
+    capacidadeDemandas = capacidade;
+
+    qtdParadas = 0;
+    qtdTrechos = 0;
+    distanciaTotal = 0.0;
 }
 
 // Adiciona uma nova demanda ao vetor, expandindo a capacidade se necessário
-void Corrida::adicionarDemanda(Demanda* d) {
+void Corrida::adicionarDemanda(int indice) {
     if (qtdDemandas == capacidadeDemandas) {
-        int novaCap = (capacidadeDemandas == 0 ? 1 : capacidadeDemandas * 2);
-        Demanda** novoVet = new Demanda*[novaCap];
+        alocarBloco(capacidadeDemandas * 2);
+    }
 
-        for (int i = 0; i < qtdDemandas; ++i) {
-            novoVet[i] = demandas[i];
-        }
+    demandas[qtdDemandas++] = indice;
+    tabela->setCorrida(indice, this); // associa a demanda a esta corrida
+}
 
-        delete[] demandas;
-        demandas = novoVet;
-        capacidadeDemandas = novaCap;
-    }
+// Assume a posse da tabela de demandas referenciada pela corrida
+void Corrida::assumirTabela() {
+    donaDaTabela = true;
+}
 
-    demandas[qtdDemandas++] = d;
-    d->setCorrida(this); // associa a demanda a esta corrida
+TabelaDemandas* Corrida::getTabela() const {
+    return tabela;
 }
 
 // Retorna a quantidade de demandas da corrida
@@ -69,51 +92,54 @@ int Corrida::getQtdDemandas() const {
     return qtdDemandas;
 }
 
-// Retorna uma demanda pelo índice
-Demanda* Corrida::getDemanda(int idx) const {
-    if (idx < 0 || idx >= qtdDemandas) return nullptr;
+// Retorna o índice na tabela da demanda idx da corrida
+int Corrida::getDemanda(int idx) const {
+    if (idx < 0 || idx >= qtdDemandas) return -1;
     return demandas[idx];
 }
 
 // Constrói a rota básica: primeiro embarques, depois desembarques
 void Corrida::construirRotaBasica() {
-    // limpa paradas antigas
-    for (int i = 0; i < qtdParadas; ++i) {
-        delete paradas[i];
-    }
+    // as paradas antigas são sobrescritas
     qtdParadas = 0;
 
+    const ColunasDemandas& colunas = tabela->getColunas();
+
     // inserção das paradas de embarque
     for (int i = 0; i < qtdDemandas; ++i) {
-        Demanda* d = demandas[i];
-        Parada* p = new Parada(d->getOrigem(), PARADA_EMBARQUE, d);
-        paradas[qtdParadas++] = p;
+        int d = demandas[i];
+        paradas[qtdParadas++] = Parada(colunas.origem(d), PARADA_EMBARQUE, d);
     }
 
     // inserção das paradas de desembarque
     for (int i = 0; i < qtdDemandas; ++i) {
-        Demanda* d = demandas[i];
-        Parada* p = new Parada(d->getDestino(), PARADA_DESEMBARQUE, d);
-        paradas[qtdParadas++] = p;
+        int d = demandas[i];
+        paradas[qtdParadas++] = Parada(colunas.destino(d), PARADA_DESEMBARQUE, d);
     }
 }
 
 // Cria os trechos consecutivos da rota e calcula a distância total
 void Corrida::calcularTrechosEDistancia() {
-    // limpa trechos antigos
-    for (int i = 0; i < qtdTrechos; ++i) {
-        delete trechos[i];
-    }
+    // os trechos antigos são sobrescritos
     qtdTrechos = 0;
     distanciaTotal = 0.0;
 
     if (qtdParadas <= 1) return;
 
+    // no modo viário, a distância de cada trecho já veio do agrupamento
+    const ColunasDemandas& colunas = tabela->getColunas();
+
     // cria trechos entre cada par de paradas consecutivas
     for (int i = 0; i < qtdParadas - 1; ++i) {
-        Trecho* t = new Trecho(paradas[i], paradas[i + 1], TRECHO_DESLOCAMENTO);
-        trechos[qtdTrechos++] = t;
-        distanciaTotal += t->getDistancia();
+        trechos[qtdTrechos] = Trecho(&paradas[i], &paradas[i + 1], TRECHO_DESLOCAMENTO);
+        if (colunas.trechosEmbarque) {
+            const Parada& chegada = paradas[i + 1];
+            trechos[qtdTrechos].setDistancia(chegada.getTipo() == PARADA_EMBARQUE
+                                                 ? colunas.trechosEmbarque[chegada.getDemanda()]
+                                                 : colunas.trechosDesembarque[chegada.getDemanda()]);
+        }
+        distanciaTotal += trechos[qtdTrechos].getDistancia();
+        ++qtdTrechos;
     }
 }
 
@@ -135,6 +161,22 @@ double Corrida::getTempoFim() const {
     return tempoFim;
 }
 
+void Corrida::setInstanteEntrada(double t) {
+    instanteEntrada = t;
+}
+
+double Corrida::getInstanteEntrada() const {
+    return instanteEntrada;
+}
+
+void Corrida::setVeiculo(int v) {
+    veiculo = v;
+}
+
+int Corrida::getVeiculo() const {
+    return veiculo;
+}
+
 double Corrida::getDistanciaTotal() const {
     return distanciaTotal;
 }
@@ -146,12 +188,12 @@ int Corrida::getNumeroParadas() const {
 // Acesso a paradas e trechos
 Parada* Corrida::getParada(int idx) const {
     if (idx < 0 || idx >= qtdParadas) return nullptr;
-    return paradas[idx];
+    return &paradas[idx];
 }
 
 Trecho* Corrida::getTrecho(int idx) const {
     if (idx < 0 || idx >= qtdTrechos) return nullptr;
-    return trechos[idx];
+    return &trechos[idx];
 }
 
 // Imprime a saída final da corrida no formato especificado pelo enunciado
@@ -159,8 +201,31 @@ void Corrida::imprimirSaida(std::ostream& out) const {
     out << tempoFim << " " << distanciaTotal << " " << qtdParadas;
 
     for (int i = 0; i < qtdParadas; ++i) {
-        Ponto p = paradas[i]->getPonto();
+        Ponto p = paradas[i].getPonto();
         out << " " << p.x << " " << p.y;
     }
     out << "\n";
 }
+
+int Corrida::tamanhoMaximoSaida() const {
+    // tempo, distância, quantidade, dois valores por parada, espaços e '\n'
+    return TAM_MAX_FIXO2 * (2 + 2 * qtdParadas) + TAM_MAX_INTEIRO + 2 * qtdParadas + 4;
+}
+
+char* Corrida::formatarSaida(char* p) const {
+    if (!(p = escreverFixo2(p, tempoFim))) return nullptr;
+    *p++ = ' ';
+    if (!(p = escreverFixo2(p, distanciaTotal))) return nullptr;
+    *p++ = ' ';
+    p = escreverInteiro(p, qtdParadas);
+
+    for (int i = 0; i < qtdParadas; ++i) {
+        Ponto pt = paradas[i].getPonto();
+        *p++ = ' ';
+        if (!(p = escreverFixo2(p, pt.x))) return nullptr;
+        *p++ = ' ';
+        if (!(p = escreverFixo2(p, pt.y))) return nullptr;
+    }
+    *p++ = '\n';
+    return p;
+}
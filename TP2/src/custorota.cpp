@@ -0,0 +1,104 @@
+#include "custorota.hpp"
+#include "agrupador.hpp"
+#include <cmath>
+
+/*
+ * Folga relativa usada nas comparações com λ. Cobre com sobra o erro de
+ * arredondamento de somar os mesmos trechos em ordens diferentes.
+ */
+static const double FOLGA_LAMBDA = 1e-9;
+
+/*
+ * Piso e teto da distância euclidiana sem raiz:
+ * max(|dx|, |dy|) <= dist <= |dx| + |dy|.
+ */
+static double pisoDistancia(const Ponto& a, const Ponto& b) {
+    double dx = std::fabs(a.x - b.x);
+    double dy = std::fabs(a.y - b.y);
+    return dx > dy ? dx : dy;
+}
+
+static double tetoDistancia(const Ponto& a, const Ponto& b) {
+    return std::fabs(a.x - b.x) + std::fabs(a.y - b.y);
+}
+
+/*
+ * Construtor: custo de um grupo vazio.
+ */
+CustoRota::CustoRota()
+    : ultimaOrigem{0.0, 0.0},
+      primeiroDestino{0.0, 0.0},
+      ultimoDestino{0.0, 0.0},
+      cadeiaOrigens(0.0),
+      cadeiaDestinos(0.0),
+      somaIndividual(0.0),
+      candOrigem{0.0, 0.0},
+      candDestino{0.0, 0.0},
+      candCadeiaOrigens(0.0),
+      candCadeiaDestinos(0.0),
+      candIndividual(0.0) {}
+
+/*
+ * Grupo só com a semente: as cadeias estão vazias e a rota é o0 -> d0.
+ */
+void CustoRota::iniciar(const Ponto& origem, const Ponto& destino) {
+    ultimaOrigem = origem;
+    primeiroDestino = destino;
+    ultimoDestino = destino;
+    cadeiaOrigens = 0.0;
+    cadeiaDestinos = 0.0;
+    somaIndividual = distPontos(origem, destino);
+}
+
+/*
+ * Compara um teto da eficiência com λ sem calcular nenhuma raiz.
+ * Só descarta quando a eficiência real fica abaixo de λ com folga.
+ */
+bool CustoRota::descartaPorLimite(const Ponto& origem, const Ponto& destino,
+                                  double lambda) const {
+    double individualMax = somaIndividual + tetoDistancia(origem, destino);
+    double rotaMin = cadeiaOrigens + pisoDistancia(ultimaOrigem, origem)
+                   + pisoDistancia(origem, primeiroDestino)
+                   + cadeiaDestinos + pisoDistancia(ultimoDestino, destino);
+
+    if (rotaMin <= 0.0) return false;
+    return individualMax <= lambda * rotaMin * (1.0 - FOLGA_LAMBDA);
+}
+
+/*
+ * Rota de "grupo + cj":
+ *   cadeia de origens + (ok -> oj) + (oj -> d0) + cadeia de destinos + (dk -> dj)
+ * O trecho ok -> d0 da rota atual deixa de existir.
+ */
+double CustoRota::avaliar(const Ponto& origem, const Ponto& destino) {
+    candOrigem = origem;
+    candDestino = destino;
+    candCadeiaOrigens = cadeiaOrigens + distPontos(ultimaOrigem, origem);
+    candCadeiaDestinos = cadeiaDestinos + distPontos(ultimoDestino, destino);
+    candIndividual = somaIndividual + distPontos(origem, destino);
+
+    double distRota = candCadeiaOrigens + distPontos(origem, primeiroDestino)
+                    + candCadeiaDestinos;
+
+    return (distRota > 0.0) ? (candIndividual / distRota) : 1.0;
+}
+
+void CustoRota::confirmar() {
+    ultimaOrigem = candOrigem;
+    ultimoDestino = candDestino;
+    cadeiaOrigens = candCadeiaOrigens;
+    cadeiaDestinos = candCadeiaDestinos;
+    somaIndividual = candIndividual;
+}
+
+bool CustoRota::ambigua(double eficiencia, double lambda) {
+    return std::fabs(eficiencia - lambda) <= FOLGA_LAMBDA * std::fabs(lambda);
+}
+
+double CustoRota::getDistanciaRota() const {
+    return cadeiaOrigens + distPontos(ultimaOrigem, primeiroDestino) + cadeiaDestinos;
+}
+
+double CustoRota::getDistanciaIndividual() const {
+    return somaIndividual;
+}
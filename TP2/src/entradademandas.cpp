@@ -0,0 +1,24 @@
+#include "entradademandas.hpp"
+#include <istream>
+
+EntradaTexto::EntradaTexto(std::istream& entrada_, int numDemandas)
+    : entrada(entrada_),
+      restantes(numDemandas) {}
+
+/*
+ * Lê a próxima linha. Uma linha que não pode ser lida encerra a entrada,
+ * mesmo antes do número anunciado.
+ */
+bool EntradaTexto::ler(int& id, double& tempo, Ponto& origem, Ponto& destino) {
+    if (restantes <= 0) return false;
+
+    if (!(entrada >> id >> tempo
+                  >> origem.x >> origem.y
+                  >> destino.x >> destino.y)) {
+        restantes = 0;
+        return false;
+    }
+
+    --restantes;
+    return true;
+}
@@ -1,156 +1,405 @@
 #include "escalonador.hpp"
+#include "cronometro.hpp"
+#include "pontocontrole.hpp"
+#include "frota.hpp"
+#include "qualidadeservico.hpp"
+#include "rastro.hpp"
+#include <cmath>
 #include <iostream>
 
 /*
  * Construtor do Escalonador.
- * - Inicializa o MinHeap usado para ordenar eventos por tempo.
- * - Aloca o vetor dinâmico de eventos.
- * - Aloca o vetor de corridas (somente para liberar no destrutor).
+ * - Cria a fila de eventos do tipo escolhido (heap binário por padrão).
  * - Define valor inicial do relógio e parâmetro gama (velocidade).
  */
-Escalonador::Escalonador(int capacidadeInicialCorridas, double gama_)
-    : heap(capacidadeInicialCorridas),
-      eventos(nullptr),
-      qtdEventos(0),
-      capacidadeEventos(capacidadeInicialCorridas * 2),
-      corridas(nullptr),
-      qtdCorridas(0),
-      capacidadeCorridas(capacidadeInicialCorridas),
+Escalonador::Escalonador(int capacidadeInicialEventos, double gama_, TipoFila tipoFila)
+    : fila(nullptr),
       relogio(0.0),
-      gama(gama_) {
-
-    if (capacidadeEventos > 0) {
-        eventos = new Evento[capacidadeEventos];
-    }
-    if (capacidadeCorridas > 0) {
-        corridas = new Corrida*[capacidadeCorridas];
-    }
+      gama(gama_),
+      observador(nullptr),
+      saida(nullptr),
+      destino(&std::cout),
+      pendentes(0),
+      metricas(nullptr),
+      pontoControle(nullptr),
+      intervaloControle(0),
+      corridasFinalizadas(0),
+      proximoControle(0),
+      frota(nullptr),
+      qualidade(nullptr) {
+    fila = criarFilaEventos(tipoFila, capacidadeInicialEventos);
+    contadoresFila.zerar();
 }
 
 /*
  * Destrutor:
- * Libera todas as corridas armazenadas e os vetores dinâmicos internos.
+ * Libera as corridas que ainda não terminaram (uma por evento pendente,
+ * mais as que esperam veículo) e a fila.
  */
 Escalonador::~Escalonador() {
-    if (corridas) {
-        for (int i = 0; i < qtdCorridas; ++i) {
-            delete corridas[i];
-        }
+    Evento ev;
+    while (fila->removerMinimo(ev)) {
+        delete ev.corrida;
     }
-    delete[] corridas;
-    delete[] eventos;
+    if (frota) {
+        while (Corrida* c = frota->retirarEspera()) delete c;
+    }
+    delete fila;
 }
 
 /*
- * Adiciona um evento ao escalonador:
- * - Realoca vetor se necessário.
- * - Coloca o evento no vetor e insere sua chave (tempo) no MinHeap.
- * - Retorna o índice onde o evento foi armazenado.
+ * Define quem será avisado a cada corrida finalizada.
  */
-int Escalonador::adicionarEvento(const Evento& e) {
-    if (qtdEventos == capacidadeEventos) {
-        int novaCap = (capacidadeEventos == 0 ? 1 : capacidadeEventos * 2);
-        Evento* novoVet = new Evento[novaCap];
-        for (int i = 0; i < qtdEventos; ++i) {
-            novoVet[i] = eventos[i];
-        }
-        delete[] eventos;
-        eventos = novoVet;
-        capacidadeEventos = novaCap;
-    }
+void Escalonador::setObservador(ObservadorCorridas* obs) {
+    observador = obs;
+}
+
+void Escalonador::setSaida(SaidaAssincrona* saida_) {
+    saida = saida_;
+}
 
-    int idx = qtdEventos;
-    eventos[qtdEventos++] = e;
-    heap.inserir(e.tempo, idx);
-    return idx;
+void Escalonador::setDestino(std::ostream* destino_) {
+    destino = destino_;
+}
+
+void Escalonador::setMetricas(Metricas* metricas_) {
+    metricas = metricas_;
+}
+
+void Escalonador::setFrota(Frota* frota_) {
+    frota = frota_;
+}
+
+void Escalonador::setQualidade(QualidadeServico* qualidade_) {
+    qualidade = qualidade_;
+}
+
+void Escalonador::setPontoControle(PontoControle* pontoControle_, long long intervalo) {
+    pontoControle = pontoControle_;
+    intervaloControle = intervalo;
+    proximoControle = corridasFinalizadas + intervalo;
+}
+
+void Escalonador::restaurar(const Evento* eventos, int qtd, double relogio_,
+                            const ContadoresFila& contadores) {
+    fila->restaurar(eventos, qtd);
+    pendentes += qtd;
+    relogio = relogio_;
+    contadoresFila = contadores;
 }
 
 /*
- * Registra uma corrida no escalonador e agenda seu primeiro evento.
- * - Armazena a corrida apenas para fins de desalocação posterior.
- * - Define o tempo de início como o tempo da primeira demanda.
- * - Agenda o primeiro evento de parada (primeiro embarque).
+ * Copia os eventos pendentes, na ordem que a fila devolve ao mesmo estado
+ * (empates continuam resolvidos como antes), e passa a cópia ao ponto de
+ * controle. A cópia não entra nos contadores.
  */
-void Escalonador::adicionarCorrida(Corrida* corrida) {
-    // Armazena corrida
-    if (qtdCorridas == capacidadeCorridas) {
-        int novaCap = (capacidadeCorridas == 0 ? 1 : capacidadeCorridas * 2);
-        Corrida** novoVet = new Corrida*[novaCap];
-        for (int i = 0; i < qtdCorridas; ++i) {
-            novoVet[i] = corridas[i];
-        }
-        delete[] corridas;
-        corridas = novoVet;
-        capacidadeCorridas = novaCap;
-    }
-    corridas[qtdCorridas++] = corrida;
+void Escalonador::gravarPontoControle() {
+    int qtd = static_cast<int>(pendentes);
+    Evento* eventos = new Evento[qtd > 0 ? qtd : 1];
+    fila->copiarPendentes(eventos);
+
+    pontoControle->gravar(eventos, qtd, relogio, contadoresFila);
+    delete[] eventos;
+    proximoControle = corridasFinalizadas + intervaloControle;
+}
 
-    // Primeira parada ocorre no tempo da solicitação da demanda 0
-    Demanda* d0 = corrida->getDemanda(0);
-    double t0 = d0->getTempoSolicitacao();
+/*
+ * Adiciona um evento ao escalonador, inserindo-o na fila de eventos.
+ */
+void Escalonador::adicionarEvento(const Evento& e) {
+    fila->inserir(e);
+    ++contadoresFila.insercoes;
+    if (++pendentes > contadoresFila.tamanhoMaximo) contadoresFila.tamanhoMaximo = pendentes;
+}
+
+/*
+ * Primeiro evento de uma corrida: a parada 0 (primeiro embarque),
+ * no tempo da solicitação da demanda 0, que também é o início da corrida.
+ * Com frota, é o pedido de veículo nesse mesmo tempo.
+ */
+Evento Escalonador::eventoInicial(Corrida* corrida) const {
+    double t0 = corrida->getTabela()->getColunas().tempo(corrida->getDemanda(0));
     corrida->setTempoInicio(t0);
+    RASTRO(rastrearCorrida(corrida));
 
-    // Agenda evento para a parada 0
     Evento e;
     e.tempo = t0;
-    e.tipo = EVENTO_PARADA;
+    e.tipo = frota ? EVENTO_PEDIDO : EVENTO_PARADA;
     e.corrida = corrida;
     e.indiceParada = 0;
+    return e;
+}
 
-    adicionarEvento(e);
+/*
+ * Recebe uma corrida e agenda seu primeiro evento.
+ */
+void Escalonador::adicionarCorrida(Corrida* corrida) {
+    adicionarEvento(eventoInicial(corrida));
 }
 
 /*
- * Executa a simulação:
- * - Remove sempre o próximo evento do MinHeap (menor tempo).
- * - Atualiza o relógio.
- * - Para eventos de parada:
- *      - Se houver próxima parada, agenda deslocamento até ela.
- *      - Caso contrário, fecha a corrida, define tempo final
- *        e marca todas as demandas como concluídas.
- * - Ao finalizar a corrida, imprime a saída no formato solicitado.
- */
-void Escalonador::simularEImprimir() {
-    double tempo;
-    int idxEvento;
+ * Recebe várias corridas e agenda seus primeiros eventos em lote
+ * (ver FilaEventos::inserirLote).
+ */
+void Escalonador::adicionarCorridas(Corrida** novas, int qtd) {
+    if (qtd <= 0) return;
 
-    // Processa eventos em ordem temporal crescente
-    while (heap.removerMinimo(tempo, idxEvento)) {
-        relogio = tempo;
+    Evento* iniciais = new Evento[qtd];
+    for (int c = 0; c < qtd; ++c) {
+        iniciais[c] = eventoInicial(novas[c]);
+    }
+    fila->inserirLote(iniciais, qtd);
+    delete[] iniciais;
 
-        Evento& ev = eventos[idxEvento];
-        Corrida* c = ev.corrida;
+    contadoresFila.insercoes += qtd;
+    pendentes += qtd;
+    if (pendentes > contadoresFila.tamanhoMaximo) contadoresFila.tamanhoMaximo = pendentes;
+}
 
-        if (ev.tipo == EVENTO_PARADA) {
-            int idxP = ev.indiceParada;
-            int numParadas = c->getNumeroParadas();
+/*
+ * Agenda o início de cada grupo que a fonte ainda não entregou, na ordem
+ * dos grupos, como o simulador original agendava as corridas antes de
+ * simular; a corrida só é montada quando o início sai da fila. Retorna
+ * false se a fonte não conhece os grupos de antemão e continua
+ * entregando-os um a um.
+ */
+bool Escalonador::agendarInicios(FonteCorridas* fonte) {
+    int primeiro;
+    int qtd = fonte->entregarGrupos(primeiro);
+    if (qtd < 0) return false;
+    for (int g = primeiro; g < primeiro + qtd; ++g) {
+        Evento e;
+        e.tempo = fonte->tempoGrupo(g);
+        e.tipo = EVENTO_INICIO;
+        e.corrida = nullptr;
+        e.indiceParada = g;
+        adicionarEvento(e);
+    }
+    return true;
+}
 
-            // Se existe próxima parada, agenda deslocamento até ela
-            if (idxP + 1 < numParadas) {
-                Trecho* trecho = c->getTrecho(idxP);
-                double dist = trecho->getDistancia();
-                double deltaT = (gama > 0.0) ? (dist / gama) : 0.0;
+/*
+ * Monta a corrida do grupo g da fonte (ou a próxima, se g < 0),
+ * medindo o tempo de montagem se houver métricas.
+ */
+Corrida* Escalonador::criarCorrida(FonteCorridas* fonte, int g) {
+    double t0 = metricas ? instanteAtual() : 0.0;
+    Corrida* corrida = (g < 0) ? fonte->criarProxima() : fonte->criarGrupo(g);
+    if (metricas) metricas->tempoFase[FASE_MONTAGEM] += instanteAtual() - t0;
+    return corrida;
+}
 
-                Evento prox;
-                prox.tempo = tempo + deltaT;
-                prox.tipo = EVENTO_PARADA;
-                prox.corrida = c;
-                prox.indiceParada = idxP + 1;
+/*
+ * Escreve a linha de saída da corrida: com a saída assíncrona, formata
+ * direto no bloco atual; se a linha não couber em um bloco ou algum valor
+ * precisar do formatador geral, usa o destino (std::cout) como antes.
+ */
+void Escalonador::imprimirCorrida(const Corrida* c) {
+    if (!destino) return;
+    if (saida) {
+        char* p = saida->reservar(c->tamanhoMaximoSaida());
+        char* fim = p ? c->formatarSaida(p) : nullptr;
+        if (fim) {
+            saida->confirmar(fim);
+            return;
+        }
+    }
+    c->imprimirSaida(*destino);
+}
+
+/*
+ * Fecha a corrida: define o tempo final, marca todas as demandas como
+ * concluídas, imprime a saída, avisa o observador (e a qualidade do
+ * serviço) e libera a corrida.
+ */
+void Escalonador::finalizarCorrida(Corrida* c) {
+    c->setTempoFim(relogio);
+    RASTRO(rastrearFim(c));
+
+    TabelaDemandas* tabela = c->getTabela();
+    int qd = c->getQtdDemandas();
+    for (int i = 0; i < qd; ++i) {
+        int d = c->getDemanda(i);
+        tabela->setEstado(d, DEMANDA_CONCLUIDA);
+        tabela->setCorrida(d, nullptr);
+    }
+
+    if (metricas) {
+        double inicio = instanteAtual();
+        imprimirCorrida(c);
+        metricas->tempoFase[FASE_IMPRESSAO] += instanteAtual() - inicio;
+    } else {
+        imprimirCorrida(c);
+    }
+    if (observador) {
+        observador->corridaFinalizada(*c);
+    }
+    if (qualidade) {
+        qualidade->registrarCorrida(*c);
+    }
+
+    // o veículo fica na última parada e é liberado por um evento neste instante
+    if (frota) {
+        int v = c->getVeiculo();
+        frota->estacionar(v, c->getParada(c->getNumeroParadas() - 1)->getPonto());
+
+        Evento livre;
+        livre.tempo = relogio;
+        livre.tipo = EVENTO_VEICULO_LIVRE;
+        livre.corrida = nullptr;
+        livre.indiceParada = v;
+        adicionarEvento(livre);
+    }
+    delete c;
+    ++corridasFinalizadas;
+}
+
+/*
+ * O veículo v sai de onde está até o primeiro embarque de c; a parada 0
+ * é agendada para a chegada.
+ */
+void Escalonador::atribuirVeiculo(Corrida* c, int v) {
+    Ponto de = frota->getPosicao(v);
+    Ponto ate = c->getParada(0)->getPonto();
+    double dx = ate.x - de.x;
+    double dy = ate.y - de.y;
+    double aproximacao = std::sqrt(dx * dx + dy * dy);
+    frota->registrarAtribuicao(c->getTempoInicio(), relogio, aproximacao);
+    c->setVeiculo(v);
+
+    Evento chegada;
+    chegada.tempo = relogio + ((gama > 0.0) ? (aproximacao / gama) : 0.0);
+    chegada.tipo = EVENTO_PARADA;
+    chegada.corrida = c;
+    chegada.indiceParada = 0;
+    adicionarEvento(chegada);
+}
+
+/*
+ * Pedido de veículo: o livre mais próximo do embarque ou, sem nenhum livre,
+ * a fila de espera.
+ */
+void Escalonador::atenderPedido(Corrida* c) {
+    int v = frota->ocuparMaisProximo(c->getParada(0)->getPonto());
+    if (v < 0) {
+        frota->esperar(c);
+    } else {
+        atribuirVeiculo(c, v);
+    }
+}
+
+/*
+ * Veículo liberado: atende a corrida que espera há mais tempo ou volta
+ * aos livres.
+ */
+void Escalonador::liberarVeiculo(int v) {
+    Corrida* c = frota->retirarEspera();
+    if (c) {
+        atribuirVeiculo(c, v);
+    } else {
+        frota->liberar(v);
+    }
+}
+
+/*
+ * Trata um evento:
+ * - Parada: se houver próxima parada, agenda deslocamento até ela;
+ *   caso contrário, a corrida terminou.
+ * - Pedido e veículo livre (modo frota): ver atenderPedido e liberarVeiculo.
+ */
+void Escalonador::processarEvento(const Evento& ev) {
+    relogio = ev.tempo;
+    Corrida* c = ev.corrida;
+
+    if (ev.tipo == EVENTO_PARADA) {
+        int idxP = ev.indiceParada;
+        int numParadas = c->getNumeroParadas();
+        RASTRO(rastrearParada(c, idxP, relogio));
+
+        // Se existe próxima parada, agenda deslocamento até ela
+        if (idxP + 1 < numParadas) {
+            Trecho* trecho = c->getTrecho(idxP);
+            double dist = trecho->getDistancia();
+            double deltaT = (gama > 0.0) ? (dist / gama) : 0.0;
+
+            Evento prox;
+            prox.tempo = ev.tempo + deltaT;
+            prox.tipo = EVENTO_PARADA;
+            prox.corrida = c;
+            prox.indiceParada = idxP + 1;
+
+            adicionarEvento(prox);
+        } else {
+            // Última parada: fim da corrida
+            finalizarCorrida(c);
+        }
+    } else if (ev.tipo == EVENTO_PEDIDO) {
+        atenderPedido(c);
+    } else if (ev.tipo == EVENTO_VEICULO_LIVRE) {
+        liberarVeiculo(ev.indiceParada);
+    }
+}
 
-                adicionarEvento(prox);
+/*
+ * Executa a simulação:
+ * - Se a fila desempata pelo que contém (heap), os inícios dos grupos da
+ *   fonte são agendados antes (ver agendarInicios); a corrida de um início
+ *   é montada quando ele sai da fila. Se não der, ou com frota, empates
+ *   saem por ordem de chegada.
+ * - A cada passo, o próximo evento é o menor da fila ou, se a fonte tiver
+ *   uma corrida começando até esse instante, o evento inicial dela, que é
+ *   processado direto, sem passar pela fila.
+ * - Atualiza o relógio e processa o evento.
+ * - Ao finalizar cada corrida, imprime a saída no formato solicitado.
+ * - Com ponto de controle, o estado é gravado antes do passo seguinte a
+ *   cada intervalo de corridas finalizadas.
+ */
+void Escalonador::simularEImprimir(FonteCorridas* fonte) {
+    RASTRO_TRECHO("simulacao");
+    Evento ev;
+
+    double inicio = metricas ? instanteAtual() : 0.0;
+    double montagemAntes = metricas ? metricas->tempoFase[FASE_MONTAGEM] : 0.0;
+    double impressaoAntes = metricas ? metricas->tempoFase[FASE_IMPRESSAO] : 0.0;
+
+    // com frota, pedidos no mesmo instante são atendidos na ordem em que
+    // foram feitos, qualquer que seja a fila
+    if (fonte && (frota || !(fila->agendaInicios() && agendarInicios(fonte)))) {
+        fila->desempatarPorChegada();
+    }
+
+    // Processa eventos em ordem temporal crescente
+    while (true) {
+        if (pontoControle && corridasFinalizadas >= proximoControle) {
+            gravarPontoControle();
+        }
+
+        bool temEvento = fila->obterMinimo(ev);
+
+        if (fonte && fonte->temProxima() &&
+            (!temEvento || fonte->tempoProxima() <= ev.tempo)) {
+            ++contadoresFila.iniciosDiretos;
+            processarEvento(eventoInicial(criarCorrida(fonte, -1)));
+        } else if (temEvento) {
+            fila->removerMinimo(ev);
+            ++contadoresFila.remocoes;
+            --pendentes;
+            if (ev.tipo == EVENTO_INICIO) {
+                processarEvento(eventoInicial(criarCorrida(fonte, ev.indiceParada)));
             } else {
-                // Última parada: fim da corrida
-                c->setTempoFim(tempo);
-
-                // Marca todas as demandas da corrida como concluídas
-                int qd = c->getQtdDemandas();
-                for (int i = 0; i < qd; ++i) {
-                    Demanda* d = c->getDemanda(i);
-                    d->setEstado(DEMANDA_CONCLUIDA);
-                }
-                
-                c->imprimirSaida(std::cout);
+                processarEvento(ev);
             }
+        } else {
+            break;
         }
     }
+
+    if (metricas) {
+        // a simulação é o tempo do laço menos a montagem e a impressão
+        double total = instanteAtual() - inicio;
+        double montagem = metricas->tempoFase[FASE_MONTAGEM] - montagemAntes;
+        double impressao = metricas->tempoFase[FASE_IMPRESSAO] - impressaoAntes;
+        metricas->tempoFase[FASE_SIMULACAO] += total - montagem - impressao;
+        metricas->fila = contadoresFila;
+    }
 }
@@ -0,0 +1,268 @@
+#include "filacalendario.hpp"
+#include <cmath>
+
+// Menor número de baldes; abaixo disso não compensa encolher
+static const int MIN_BALDES = 2;
+
+// Maior dia representado. Tempos além dele (inclusive infinitos, como o fim
+// de uma corrida sem caminho na malha viária) ficam todos nesse dia, que a
+// varredura dos dias nunca alcança antes de esgotar os demais eventos.
+static const double DIA_MAXIMO = 4611686018427387904.0;  // 2^62
+
+/*
+ * Construtor: calendário mínimo com dias de largura 1.
+ * A largura é reajustada a cada redimensionamento.
+ */
+FilaCalendario::FilaCalendario()
+    : nos(nullptr),
+      capacidadeNos(0),
+      livre(-1),
+      baldes(nullptr),
+      numBaldes(MIN_BALDES),
+      largura(1.0),
+      diaAtual(0),
+      tamanho(0),
+      proximaSeq(0) {
+    baldes = new int[numBaldes];
+    for (int b = 0; b < numBaldes; ++b) {
+        baldes[b] = -1;
+    }
+}
+
+FilaCalendario::~FilaCalendario() {
+    delete[] nos;
+    delete[] baldes;
+}
+
+long long FilaCalendario::diaDe(double tempo) const {
+    double dia = std::floor(tempo / largura);
+    if (!(dia < DIA_MAXIMO)) return static_cast<long long>(DIA_MAXIMO);
+    if (dia < -DIA_MAXIMO) return -static_cast<long long>(DIA_MAXIMO);
+    return static_cast<long long>(dia);
+}
+
+bool FilaCalendario::precede(int a, int b) const {
+    if (nos[a].evento.tempo != nos[b].evento.tempo) {
+        return nos[a].evento.tempo < nos[b].evento.tempo;
+    }
+    return nos[a].seq < nos[b].seq;
+}
+
+/*
+ * Retira um nó da lista de livres, dobrando o vetor de nós se necessário.
+ */
+int FilaCalendario::alocarNo() {
+    if (livre == -1) {
+        int novaCap = (capacidadeNos == 0 ? 16 : capacidadeNos * 2);
+        No* novoVet = new No[novaCap];
+        for (int i = 0; i < capacidadeNos; ++i) {
+            novoVet[i] = nos[i];
+        }
+        // os nós novos entram na lista de livres
+        for (int i = capacidadeNos; i < novaCap; ++i) {
+            novoVet[i].prox = (i + 1 < novaCap) ? i + 1 : -1;
+        }
+        delete[] nos;
+        nos = novoVet;
+        livre = capacidadeNos;
+        capacidadeNos = novaCap;
+    }
+
+    int idx = livre;
+    livre = nos[idx].prox;
+    return idx;
+}
+
+/*
+ * Insere o nó na lista do balde do seu dia, mantendo a ordem (tempo, seq).
+ */
+void FilaCalendario::encadear(int idx) {
+    nos[idx].dia = diaDe(nos[idx].evento.tempo);
+    int b = static_cast<int>(nos[idx].dia & (numBaldes - 1));
+
+    int ant = -1;
+    int atual = baldes[b];
+    while (atual != -1 && precede(atual, idx)) {
+        ant = atual;
+        atual = nos[atual].prox;
+    }
+
+    nos[idx].prox = atual;
+    if (ant == -1) {
+        baldes[b] = idx;
+    } else {
+        nos[ant].prox = idx;
+    }
+}
+
+/*
+ * Estima a separação típica entre eventos consecutivos a partir de uma
+ * amostra espaçada dos tempos pendentes: a mediana das distâncias entre
+ * amostras vizinhas, dividida pelo número de eventos entre elas. A mediana
+ * segue a região onde está a maioria dos eventos e ignora eventos isolados
+ * muito à frente, que distorceriam uma média sobre o intervalo todo.
+ */
+static double separacaoTipica(const double* tempos, int qtd) {
+    const int MAX_AMOSTRAS = 257;
+    if (qtd < 2) return 0.0;
+
+    int passo = (qtd + MAX_AMOSTRAS - 1) / MAX_AMOSTRAS;
+    double amostra[MAX_AMOSTRAS];
+    int m = 0;
+    for (int i = 0; i < qtd && m < MAX_AMOSTRAS; i += passo) {
+        amostra[m++] = tempos[i];
+    }
+    if (m < 2) return 0.0;
+
+    // ordenação por inserção: a amostra é pequena
+    for (int i = 1; i < m; ++i) {
+        double v = amostra[i];
+        int j = i - 1;
+        while (j >= 0 && amostra[j] > v) {
+            amostra[j + 1] = amostra[j];
+            --j;
+        }
+        amostra[j + 1] = v;
+    }
+
+    double difs[MAX_AMOSTRAS];
+    for (int i = 0; i + 1 < m; ++i) {
+        difs[i] = amostra[i + 1] - amostra[i];
+    }
+    for (int i = 1; i < m - 1; ++i) {
+        double v = difs[i];
+        int j = i - 1;
+        while (j >= 0 && difs[j] > v) {
+            difs[j + 1] = difs[j];
+            --j;
+        }
+        difs[j + 1] = v;
+    }
+
+    double eventosPorAmostra = static_cast<double>(qtd) / m;
+    return difs[(m - 1) / 2] / eventosPorAmostra;
+}
+
+/*
+ * Troca o número de baldes e recalcula a largura do dia para uns três
+ * eventos por dia na região mais povoada (ver separacaoTipica).
+ * Todos os nós são redistribuídos: O(n), amortizado pelas duplicações.
+ */
+void FilaCalendario::redimensionar(int novoNumBaldes) {
+    int* pendentes = new int[tamanho > 0 ? tamanho : 1];
+    double* tempos = new double[tamanho > 0 ? tamanho : 1];
+    int qtd = 0;
+    double menor = 0.0;
+
+    for (int b = 0; b < numBaldes; ++b) {
+        for (int i = baldes[b]; i != -1; i = nos[i].prox) {
+            double t = nos[i].evento.tempo;
+            if (qtd == 0 || t < menor) menor = t;
+            tempos[qtd] = t;
+            pendentes[qtd++] = i;
+        }
+    }
+
+    double novaLargura = 3.0 * separacaoTipica(tempos, qtd);
+    if (novaLargura > 0.0 && std::isfinite(novaLargura)) {
+        largura = novaLargura;
+    }
+
+    delete[] baldes;
+    numBaldes = novoNumBaldes;
+    baldes = new int[numBaldes];
+    for (int b = 0; b < numBaldes; ++b) {
+        baldes[b] = -1;
+    }
+
+    for (int k = 0; k < qtd; ++k) {
+        encadear(pendentes[k]);
+    }
+    diaAtual = (qtd > 0) ? diaDe(menor) : 0;
+
+    delete[] tempos;
+    delete[] pendentes;
+}
+
+/*
+ * Insere um evento no balde do seu dia.
+ * Um evento anterior ao dia atual faz o calendário voltar até ele.
+ */
+void FilaCalendario::inserir(const Evento& e) {
+    int idx = alocarNo();
+    nos[idx].evento = e;
+    nos[idx].seq = proximaSeq++;
+    encadear(idx);
+
+    if (tamanho == 0 || nos[idx].dia < diaAtual) {
+        diaAtual = nos[idx].dia;
+    }
+    ++tamanho;
+
+    if (tamanho > 2 * numBaldes) {
+        redimensionar(2 * numBaldes);
+    }
+}
+
+/*
+ * Percorre os dias a partir do atual. O primeiro balde cujo primeiro nó é
+ * do próprio dia contém o menor evento. Se um ano inteiro passar sem
+ * encontrar nenhum (eventos esparsos), procura diretamente o menor entre os
+ * primeiros nós de todos os baldes. Os dias percorridos sem eventos ficam
+ * para trás, então consultas seguidas não repetem a busca.
+ */
+int FilaCalendario::localizarMinimo() {
+    for (int k = 0; k < numBaldes; ++k) {
+        int cand = static_cast<int>(diaAtual & (numBaldes - 1));
+        int cab = baldes[cand];
+        if (cab != -1 && nos[cab].dia == diaAtual) {
+            return cand;
+        }
+        ++diaAtual;
+    }
+
+    int melhor = -1;
+    for (int k = 0; k < numBaldes; ++k) {
+        int cab = baldes[k];
+        if (cab != -1 && (melhor == -1 || precede(cab, baldes[melhor]))) {
+            melhor = k;
+        }
+    }
+    diaAtual = nos[baldes[melhor]].dia;
+    return melhor;
+}
+
+bool FilaCalendario::obterMinimo(Evento& e) {
+    if (tamanho == 0) return false;
+    e = nos[baldes[localizarMinimo()]].evento;
+    return true;
+}
+
+/*
+ * Remove o primeiro nó do balde do menor evento e devolve o nó aos livres.
+ */
+bool FilaCalendario::removerMinimo(Evento& e) {
+    if (tamanho == 0) return false;
+
+    int b = localizarMinimo();
+    int idx = baldes[b];
+    baldes[b] = nos[idx].prox;
+    e = nos[idx].evento;
+
+    nos[idx].prox = livre;
+    livre = idx;
+    --tamanho;
+
+    if (tamanho < numBaldes / 2 && numBaldes > MIN_BALDES) {
+        redimensionar(numBaldes / 2);
+    }
+    return true;
+}
+
+bool FilaCalendario::vazia() const {
+    return tamanho == 0;
+}
+
+int FilaCalendario::getTamanho() const {
+    return tamanho;
+}
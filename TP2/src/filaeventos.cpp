@@ -0,0 +1,17 @@
+#include "filaeventos.hpp"
+#include "filaheap.hpp"
+#include "filacalendario.hpp"
+
+/*
+ * Fábrica das implementações da fila de eventos.
+ * A fila calendário ajusta seu tamanho sozinha e ignora a capacidade inicial.
+ */
+FilaEventos* criarFilaEventos(TipoFila tipo, int capacidadeInicial) {
+    switch (tipo) {
+        case FILA_CALENDARIO:
+            return new FilaCalendario();
+        case FILA_HEAP:
+        default:
+            return new FilaHeap(capacidadeInicial);
+    }
+}
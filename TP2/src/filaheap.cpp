@@ -0,0 +1,172 @@
+#include "filaheap.hpp"
+
+/*
+ * Construtor: reserva espaço para os primeiros eventos no heap e nas
+ * cargas. O heap por chegada só é alocado se for usado.
+ */
+FilaHeap::FilaHeap(int capacidadeInicial)
+    : heap(capacidadeInicial),
+      porChegada(false),
+      proximaSeq(0),
+      cargas(nullptr),
+      livres(nullptr),
+      qtdLivres(0),
+      qtdCargas(0),
+      capacidadeCargas(capacidadeInicial > 0 ? capacidadeInicial : 16) {
+    cargas = new CargaEvento[capacidadeCargas];
+    livres = new int[capacidadeCargas];
+}
+
+FilaHeap::~FilaHeap() {
+    delete[] cargas;
+    delete[] livres;
+}
+
+/*
+ * Guarda o restante do evento numa posição liberada ou, se não houver,
+ * numa nova, dobrando os vetores quando enchem.
+ */
+int FilaHeap::guardar(const Evento& e) {
+    int p;
+    if (qtdLivres > 0) {
+        p = livres[--qtdLivres];
+    } else {
+        if (qtdCargas == capacidadeCargas) {
+            int novaCap = capacidadeCargas * 2;
+            CargaEvento* novoVet = new CargaEvento[novaCap];
+            for (int i = 0; i < qtdCargas; ++i) {
+                novoVet[i] = cargas[i];
+            }
+            delete[] cargas;
+            delete[] livres;   // vazio: só cresce sem posições livres
+            cargas = novoVet;
+            livres = new int[novaCap];
+            capacidadeCargas = novaCap;
+        }
+        p = qtdCargas++;
+    }
+    cargas[p].corrida = e.corrida;
+    cargas[p].indiceParada = e.indiceParada;
+    cargas[p].tipo = e.tipo;
+    return p;
+}
+
+void FilaHeap::montarEvento(double tempo, int posicao, Evento& e) const {
+    e.tempo = tempo;
+    e.tipo = cargas[posicao].tipo;
+    e.corrida = cargas[posicao].corrida;
+    e.indiceParada = cargas[posicao].indiceParada;
+}
+
+void FilaHeap::inserir(const Evento& e) {
+    int p = guardar(e);
+    if (porChegada) {
+        ChaveEvento chave = {e.tempo, proximaSeq++};
+        heapChegada.inserir(chave, p);
+    } else {
+        heap.inserir(e.tempo, p);
+    }
+}
+
+/*
+ * Inserções seguidas, que é o que define a ordem dos empates (montar o heap
+ * de uma vez daria outro formato). Com os eventos em ordem de tempo, como os
+ * inícios das corridas, cada inserção para na primeira comparação e o lote
+ * custa O(n) do mesmo jeito.
+ */
+void FilaHeap::inserirLote(const Evento* eventos, int qtd) {
+    if (porChegada) {
+        heapChegada.reservar(heapChegada.getTamanho() + qtd);
+    } else {
+        heap.reservar(heap.getTamanho() + qtd);
+    }
+    for (int i = 0; i < qtd; ++i) {
+        inserir(eventos[i]);
+    }
+}
+
+bool FilaHeap::obterMinimo(Evento& e) {
+    int p;
+    if (porChegada) {
+        ChaveEvento chave;
+        if (!heapChegada.obterMinimo(chave, p)) return false;
+        montarEvento(chave.tempo, p, e);
+    } else {
+        double tempo;
+        if (!heap.obterMinimo(tempo, p)) return false;
+        montarEvento(tempo, p, e);
+    }
+    return true;
+}
+
+/*
+ * Remove o evento de menor tempo e libera a posição da sua carga.
+ */
+bool FilaHeap::removerMinimo(Evento& e) {
+    int p;
+    if (porChegada) {
+        ChaveEvento chave;
+        if (!heapChegada.removerMinimo(chave, p)) return false;
+        montarEvento(chave.tempo, p, e);
+    } else {
+        double tempo;
+        if (!heap.removerMinimo(tempo, p)) return false;
+        montarEvento(tempo, p, e);
+    }
+    livres[qtdLivres++] = p;
+    return true;
+}
+
+bool FilaHeap::agendaInicios() const {
+    return true;
+}
+
+/*
+ * Passa ao heap por chegada. Os eventos que já estavam na fila entram nele
+ * na ordem em que sairiam, e continuam saindo nessa ordem.
+ */
+void FilaHeap::desempatarPorChegada() {
+    if (porChegada) return;
+    heapChegada.reservar(heap.getCapacidade());
+    double tempo;
+    int p;
+    while (heap.removerMinimo(tempo, p)) {
+        ChaveEvento chave = {tempo, proximaSeq++};
+        heapChegada.inserir(chave, p);
+    }
+    porChegada = true;
+}
+
+/*
+ * O vetor do heap como está: devolvido na mesma ordem, já é um heap, com o
+ * mesmo formato (e os mesmos empates pela frente). Por chegada, a ordem de
+ * chegada não é copiada, e vale o padrão da FilaEventos.
+ */
+void FilaHeap::copiarPendentes(Evento* destino) {
+    if (porChegada) {
+        FilaEventos::copiarPendentes(destino);
+        return;
+    }
+    for (int i = 0; i < heap.getTamanho(); ++i) {
+        montarEvento(heap.getChave(i), heap.getValor(i), destino[i]);
+    }
+}
+
+void FilaHeap::restaurar(const Evento* eventos, int qtd) {
+    if (porChegada) {
+        FilaEventos::restaurar(eventos, qtd);
+        return;
+    }
+    heap.reservar(heap.getTamanho() + qtd);
+    for (int i = 0; i < qtd; ++i) {
+        heap.acrescentar(eventos[i].tempo, guardar(eventos[i]));
+    }
+}
+
+bool FilaHeap::vazia() const {
+    return getTamanho() == 0;
+}
+
+int FilaHeap::getTamanho() const {
+    return porChegada ? heapChegada.getTamanho() : heap.getTamanho();
+}
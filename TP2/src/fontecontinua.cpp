@@ -0,0 +1,103 @@
+#include "fontecontinua.hpp"
+#include "cronometro.hpp"
+
+/*
+ * Capacidade da janela: o grupo tem no máximo η demandas,
+ * mais uma posição para a demanda que o encerra.
+ */
+static int capacidadeJanela(const Parametros& params) {
+    return (params.eta > 0 ? params.eta : 1) + 1;
+}
+
+FonteContinua::FonteContinua(EntradaDemandas& entrada_, const Parametros& params)
+    : entrada(entrada_),
+      janela(capacidadeJanela(params)),
+      qtdJanela(0),
+      agrupador(janela.getColunas(), params, nullptr, 0, janela.getIds()),
+      ultimoTempo(0.0),
+      foraDeOrdem(false),
+      idForaDeOrdem(0) {
+    histograma.zerar();
+}
+
+FonteContinua::~FonteContinua() {}
+
+/*
+ * Lê a próxima demanda da entrada para a janela. Retorna false no fim da
+ * entrada ou, daí em diante, numa demanda anterior à última lida.
+ */
+bool FonteContinua::lerDemanda(int posicao) {
+    if (foraDeOrdem) return false;
+
+    int id;
+    double tempo;
+    Ponto origem, destino;
+    if (!entrada.ler(id, tempo, origem, destino)) return false;
+
+    if (tempo < ultimoTempo) {
+        foraDeOrdem = true;
+        idForaDeOrdem = id;
+        return false;
+    }
+    ultimoTempo = tempo;
+
+    janela.definir(posicao, id, tempo, origem, destino);
+    return true;
+}
+
+/*
+ * Há próxima corrida se já existe uma semente ou se ainda dá para ler uma.
+ */
+bool FonteContinua::temProxima() {
+    if (qtdJanela == 0 && lerDemanda(0)) {
+        qtdJanela = 1;
+    }
+    return qtdJanela > 0;
+}
+
+double FonteContinua::tempoProxima() {
+    return janela.getColunas().tempo(0);
+}
+
+/*
+ * Completa o grupo da semente lendo demandas até uma ser recusada ou a
+ * entrada acabar, e monta a corrida sobre uma cópia das demandas do grupo.
+ */
+Corrida* FonteContinua::criarProxima() {
+    agrupador.iniciarGrupo(0);
+
+    int k = 1;                  // posição do próximo candidato na janela
+    bool recusada = false;
+    while (lerDemanda(k)) {
+        if (!agrupador.tentarAdicionar(k)) {
+            recusada = true;
+            break;
+        }
+        ++k;
+    }
+
+    histograma.registrarGrupo(k);
+
+    Corrida* corrida = montarCorrida(*janela.copiarTrecho(0, k), 0, k);
+    corrida->assumirTabela();
+    corrida->setInstanteEntrada(instanteAtual());
+
+    // a demanda recusada é a semente do próximo grupo
+    if (recusada) {
+        janela.copiar(0, k);
+        qtdJanela = 1;
+    } else {
+        qtdJanela = 0;
+    }
+    return corrida;
+}
+
+bool FonteContinua::getForaDeOrdem(int& id) const {
+    id = idForaDeOrdem;
+    return foraDeOrdem;
+}
+
+void FonteContinua::coletarContadores(ContadoresAgrupamento& destino) const {
+    destino.somar(agrupador.getContadores());
+    destino.somar(histograma);
+}
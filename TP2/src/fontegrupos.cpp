@@ -0,0 +1,124 @@
+#include "fontegrupos.hpp"
+#include "agrupador.hpp"
+
+/*
+ * Ordena índices de grupos por tempo de início, de forma estável
+ * (merge sort), para entradas que não vêm ordenadas por tempo.
+ */
+static void ordenarPorInicio(const ColunasDemandas& demandas, const int* limites,
+                             int* ordem, int* aux, int ini, int fim) {
+    if (fim - ini < 2) return;
+
+    int meio = (ini + fim) / 2;
+    ordenarPorInicio(demandas, limites, ordem, aux, ini, meio);
+    ordenarPorInicio(demandas, limites, ordem, aux, meio, fim);
+
+    int i = ini, j = meio, k = ini;
+    while (i < meio && j < fim) {
+        double ti = demandas.tempo(limites[ordem[i]]);
+        double tj = demandas.tempo(limites[ordem[j]]);
+        aux[k++] = (tj < ti) ? ordem[j++] : ordem[i++];
+    }
+    while (i < meio) aux[k++] = ordem[i++];
+    while (j < fim) aux[k++] = ordem[j++];
+
+    for (k = ini; k < fim; ++k) {
+        ordem[k] = aux[k];
+    }
+}
+
+/*
+ * Construtor: verifica se os grupos que faltam sair já estão em ordem de
+ * início e, se não estiverem, calcula essa ordem.
+ */
+FonteGrupos::FonteGrupos(TabelaDemandas& demandas_, const int* limites_, int qtdGrupos_,
+                         int entregues)
+    : demandas(demandas_),
+      limites(limites_),
+      qtdGrupos(qtdGrupos_),
+      ordem(nullptr),
+      proximo(entregues) {
+
+    const ColunasDemandas& colunas = demandas.getColunas();
+    bool ordenados = true;
+    for (int g = entregues + 1; g < qtdGrupos && ordenados; ++g) {
+        if (colunas.tempo(limites[g]) < colunas.tempo(limites[g - 1])) {
+            ordenados = false;
+        }
+    }
+
+    if (!ordenados) {
+        ordem = new int[qtdGrupos];
+        int* aux = new int[qtdGrupos];
+        for (int g = 0; g < qtdGrupos; ++g) {
+            ordem[g] = g;
+        }
+        ordenarPorInicio(colunas, limites, ordem, aux, entregues, qtdGrupos);
+        delete[] aux;
+    }
+}
+
+FonteGrupos::~FonteGrupos() {
+    delete[] ordem;
+}
+
+int FonteGrupos::grupoProximo() const {
+    return ordem ? ordem[proximo] : proximo;
+}
+
+bool FonteGrupos::temProxima() {
+    return proximo < qtdGrupos;
+}
+
+double FonteGrupos::tempoProxima() {
+    return tempoGrupo(grupoProximo());
+}
+
+/*
+ * Constrói a corrida do próximo grupo (rota e trechos) e avança.
+ */
+Corrida* FonteGrupos::criarProxima() {
+    int g = grupoProximo();
+    ++proximo;
+    return criarGrupo(g);
+}
+
+/*
+ * Os grupos que faltam são as posições [proximo, qtdGrupos) da ordem de
+ * saída; antes da primeira corrida (proximo ainda no início), são também os
+ * grupos [proximo, qtdGrupos), que é o que entrega.
+ */
+int FonteGrupos::entregarGrupos(int& primeiro) {
+    primeiro = proximo;
+    int qtd = qtdGrupos - proximo;
+    proximo = qtdGrupos;
+    return qtd;
+}
+
+double FonteGrupos::tempoGrupo(int g) {
+    return demandas.getColunas().tempo(limites[g]);
+}
+
+Corrida* FonteGrupos::criarGrupo(int g) {
+    return montarCorrida(demandas, limites[g], limites[g + 1]);
+}
+
+void FonteGrupos::getGrupo(int g, int& inicio, int& fim) const {
+    inicio = limites[g];
+    fim = limites[g + 1];
+}
+
+int FonteGrupos::getQtdRestantes() const {
+    return qtdGrupos - proximo;
+}
+
+void FonteGrupos::getRestante(int k, int& inicio, int& fim) const {
+    int posicao = proximo + k;
+    int g = ordem ? ordem[posicao] : posicao;
+    inicio = limites[g];
+    fim = limites[g + 1];
+}
+
+const TabelaDemandas& FonteGrupos::getDemandas() const {
+    return demandas;
+}
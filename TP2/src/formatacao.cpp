@@ -0,0 +1,98 @@
+#include "formatacao.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Pares "00".."99", para escrever dois dígitos por divisão
+static const char PARES_DIGITOS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Acima disso v * 100 não tem mais parte fracionária representável
+static const double LIMITE_CENTESIMOS = 9007199254740992.0;   // 2^53
+
+// 2^27 + 1: separa um double em duas metades de 26 bits (Veltkamp)
+static const double DIVISOR_VELTKAMP = 134217729.0;
+
+/*
+ * Escreve n em base 10 (sem zeros à esquerda).
+ */
+static char* escreverNatural(char* p, std::uint64_t n) {
+    char tmp[20];
+    char* t = tmp + sizeof(tmp);
+
+    while (n >= 100) {
+        unsigned r = static_cast<unsigned>(n % 100);
+        n /= 100;
+        t -= 2;
+        std::memcpy(t, PARES_DIGITOS + 2 * r, 2);
+    }
+    if (n >= 10) {
+        t -= 2;
+        std::memcpy(t, PARES_DIGITOS + 2 * n, 2);
+    } else {
+        *--t = static_cast<char>('0' + n);
+    }
+
+    std::size_t len = tmp + sizeof(tmp) - t;
+    std::memcpy(p, t, len);
+    return p + len;
+}
+
+/*
+ * O produto v * 100 é calculado sem perda como c + e (c = fl(v * 100),
+ * e = erro exato pelo produto de Dekker: v é dividido em duas metades de
+ * 26 bits, e cada metade vezes 100 é exata). O arredondamento ao inteiro é decidido
+ * sobre essa soma exata: a parte fracionária f de c é exata, e comparar
+ * f - 0.5 com -e diz de que lado do meio o valor verdadeiro está.
+ */
+char* escreverFixo2(char* p, double v) {
+    if (!std::isfinite(v)) return nullptr;
+
+    if (std::signbit(v)) {
+        *p++ = '-';
+        v = -v;
+    }
+
+    double c = v * 100.0;
+    if (c >= LIMITE_CENTESIMOS) return nullptr;
+
+    double t = DIVISOR_VELTKAMP * v;
+    double alto = t - (t - v);
+    double baixo = v - alto;
+    double e = (alto * 100.0 - c) + baixo * 100.0;
+
+    double piso = std::floor(c);
+    double meio = (c - piso) - 0.5;
+
+    std::uint64_t centesimos = static_cast<std::uint64_t>(piso);
+    if (meio > -e) {
+        ++centesimos;
+    } else if (meio == -e && (centesimos & 1)) {
+        ++centesimos;
+    }
+
+    p = escreverNatural(p, centesimos / 100);
+    *p++ = '.';
+    std::memcpy(p, PARES_DIGITOS + 2 * (centesimos % 100), 2);
+    return p + 2;
+}
+
+char* escreverInteiro(char* p, int v) {
+    std::uint64_t n;
+    if (v < 0) {
+        *p++ = '-';
+        n = static_cast<std::uint64_t>(-static_cast<std::int64_t>(v));
+    } else {
+        n = static_cast<std::uint64_t>(v);
+    }
+    return escreverNatural(p, n);
+}
@@ -0,0 +1,203 @@
+#include "fragmentos.hpp"
+#include "rastro.hpp"
+#include <iostream>
+
+/*
+ * Ordena índices do fragmento por tempo de solicitação, de forma estável
+ * (merge sort), como ordenarPorInicio em FonteGrupos.
+ */
+static void ordenarPorTempo(const ColunasDemandas& demandas, int* ordem, int* aux,
+                            int ini, int fim) {
+    if (fim - ini < 2) return;
+
+    int meio = (ini + fim) / 2;
+    ordenarPorTempo(demandas, ordem, aux, ini, meio);
+    ordenarPorTempo(demandas, ordem, aux, meio, fim);
+
+    int i = ini, j = meio, k = ini;
+    while (i < meio && j < fim) {
+        double ti = demandas.tempo(ordem[i]);
+        double tj = demandas.tempo(ordem[j]);
+        aux[k++] = (tj < ti) ? ordem[j++] : ordem[i++];
+    }
+    while (i < meio) aux[k++] = ordem[i++];
+    while (j < fim) aux[k++] = ordem[j++];
+
+    for (k = ini; k < fim; ++k) {
+        ordem[k] = aux[k];
+    }
+}
+
+static bool emOrdem(const ColunasDemandas& demandas) {
+    for (int i = 1; i < demandas.numDemandas; ++i) {
+        if (demandas.tempo(i) < demandas.tempo(i - 1)) return false;
+    }
+    return true;
+}
+
+// Fragmentos a ordenar, uma tarefa do pool para cada
+struct ContextoOrdenacao {
+    const ArquivoColunar* arquivos;
+    int** ordens;
+    const int* fragmentos;
+};
+
+static void ordenarFragmento(int indice, void* contexto) {
+    RASTRO_TRECHO("ordenacao de fragmento");
+    ContextoOrdenacao* ctx = static_cast<ContextoOrdenacao*>(contexto);
+    int f = ctx->fragmentos[indice];
+    const ColunasDemandas& demandas = ctx->arquivos[f].getColunas();
+    int n = demandas.numDemandas;
+
+    int* ordem = ctx->ordens[f];
+    int* aux = new int[n];
+    for (int i = 0; i < n; ++i) {
+        ordem[i] = i;
+    }
+    ordenarPorTempo(demandas, ordem, aux, 0, n);
+    delete[] aux;
+}
+
+static bool mesmosParametros(const Parametros& a, const Parametros& b) {
+    return a.eta == b.eta && a.gama == b.gama && a.delta == b.delta &&
+           a.alfa == b.alfa && a.beta == b.beta && a.lambda == b.lambda;
+}
+
+MesclaFragmentos::MesclaFragmentos()
+    : arquivos(nullptr),
+      qtdFragmentos(0),
+      ordens(nullptr),
+      posicoes(nullptr),
+      qtdOrdenados(0),
+      params(),
+      numDemandas(0) {}
+
+MesclaFragmentos::~MesclaFragmentos() {
+    liberarMemoria();
+}
+
+void MesclaFragmentos::liberarMemoria() {
+    if (ordens) {
+        for (int f = 0; f < qtdFragmentos; ++f) {
+            delete[] ordens[f];
+        }
+    }
+    delete[] ordens;
+    delete[] posicoes;
+    delete[] arquivos;
+    heap.limpar();
+    ordens = nullptr;
+    posicoes = nullptr;
+    arquivos = nullptr;
+    qtdFragmentos = qtdOrdenados = 0;
+    numDemandas = 0;
+}
+
+/*
+ * Mapeia todos os fragmentos antes de ordenar qualquer um, para falhar cedo.
+ */
+bool MesclaFragmentos::abrir(char** caminhos, int qtd, PoolThreads* pool) {
+    liberarMemoria();
+
+    qtdFragmentos = qtd;
+    arquivos = new ArquivoColunar[qtd];
+    heap.reservar(qtd);
+    ordens = new int*[qtd];
+    posicoes = new int[qtd];
+    for (int f = 0; f < qtd; ++f) {
+        ordens[f] = nullptr;
+        posicoes[f] = 0;
+    }
+
+    for (int f = 0; f < qtd; ++f) {
+        if (!arquivos[f].abrir(caminhos[f])) {
+            liberarMemoria();
+            return false;
+        }
+        if (f > 0 && !mesmosParametros(arquivos[f].getParametros(), arquivos[0].getParametros())) {
+            std::cerr << caminhos[f] << ": parametros diferentes dos de " << caminhos[0] << "\n";
+            liberarMemoria();
+            return false;
+        }
+        numDemandas += arquivos[f].getColunas().numDemandas;
+    }
+    params = arquivos[0].getParametros();
+
+    // só os fora de ordem recebem permutação
+    int* foraDeOrdem = new int[qtd];
+    for (int f = 0; f < qtd; ++f) {
+        const ColunasDemandas& demandas = arquivos[f].getColunas();
+        if (!emOrdem(demandas)) {
+            ordens[f] = new int[demandas.numDemandas];
+            foraDeOrdem[qtdOrdenados++] = f;
+        }
+    }
+
+    ContextoOrdenacao ctx;
+    ctx.arquivos = arquivos;
+    ctx.ordens = ordens;
+    ctx.fragmentos = foraDeOrdem;
+    if (pool && qtdOrdenados > 1) {
+        pool->executar(qtdOrdenados, ordenarFragmento, &ctx);
+    } else {
+        for (int k = 0; k < qtdOrdenados; ++k) {
+            ordenarFragmento(k, &ctx);
+        }
+    }
+    delete[] foraDeOrdem;
+
+    for (int f = 0; f < qtd; ++f) {
+        agendar(f);
+    }
+    return true;
+}
+
+/*
+ * A próxima demanda de f (pela permutação, se houver) entra no heap com o
+ * seu tempo.
+ */
+void MesclaFragmentos::agendar(int f) {
+    const ColunasDemandas& demandas = arquivos[f].getColunas();
+    int p = posicoes[f];
+    if (p >= demandas.numDemandas) return;
+
+    int i = ordens[f] ? ordens[f][p] : p;
+    ChaveFragmento chave = {demandas.tempo(i), f};
+    heap.inserir(chave, f);
+}
+
+const Parametros& MesclaFragmentos::getParametros() const {
+    return params;
+}
+
+long long MesclaFragmentos::getNumDemandas() const {
+    return numDemandas;
+}
+
+void MesclaFragmentos::imprimirResumo(std::ostream& out) const {
+    out << "fragmentos: arquivos " << qtdFragmentos
+        << " demandas " << numDemandas
+        << " ordenados " << qtdOrdenados << "\n";
+}
+
+/*
+ * Tira do heap o fragmento com a menor próxima demanda, entrega-a e põe a
+ * seguinte do mesmo fragmento no lugar.
+ */
+bool MesclaFragmentos::ler(int& id, double& tempo, Ponto& origem, Ponto& destino) {
+    ChaveFragmento chave = {0.0, 0};
+    int f = 0;
+    if (!heap.removerMinimo(chave, f)) return false;
+
+    const ColunasDemandas& demandas = arquivos[f].getColunas();
+    int p = posicoes[f]++;
+    int i = ordens[f] ? ordens[f][p] : p;
+
+    id = arquivos[f].getIds()[i];
+    tempo = demandas.tempo(i);
+    origem = demandas.origem(i);
+    destino = demandas.destino(i);
+
+    agendar(f);
+    return true;
+}
@@ -0,0 +1,336 @@
+#include "frota.hpp"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+// Veículos por célula da grade, em média
+static const double VEICULOS_POR_CELULA = 2.0;
+
+// Capacidade inicial da fila de espera; ela dobra quando enche
+static const int CAPACIDADE_INICIAL_ESPERA = 64;
+
+void EstatisticasFrota::zerar() {
+    atribuicoes = 0;
+    esperas = 0;
+    tempoEspera = 0.0;
+    maiorEspera = 0.0;
+    aproximacao = 0.0;
+    buscasGrade = 0;
+    buscasLista = 0;
+    celulasVisitadas = 0;
+}
+
+void EstatisticasFrota::imprimirResumo(std::ostream& out) const {
+    double esperaMedia = (atribuicoes > 0) ? tempoEspera / atribuicoes : 0.0;
+    double aproximacaoMedia = (atribuicoes > 0) ? aproximacao / atribuicoes : 0.0;
+    double celulasMedia = (buscasGrade > 0) ? static_cast<double>(celulasVisitadas) / buscasGrade : 0.0;
+    out << "frota: atribuicoes " << atribuicoes
+        << " esperas " << esperas
+        << " espera_media " << esperaMedia
+        << " espera_max " << maiorEspera
+        << " aproximacao_media " << aproximacaoMedia
+        << " buscas_grade " << buscasGrade
+        << " celulas_por_busca " << celulasMedia
+        << " buscas_lista " << buscasLista << "\n";
+}
+
+Frota::Frota()
+    : numVeiculos(0),
+      xs(nullptr),
+      ys(nullptr),
+      minX(0.0),
+      minY(0.0),
+      tamCelula(1.0),
+      colunasGrade(0),
+      linhasGrade(0),
+      primeiroCelula(nullptr),
+      proximoCelula(nullptr),
+      anteriorCelula(nullptr),
+      celulaVeiculo(nullptr),
+      livres(nullptr),
+      posicaoLivre(nullptr),
+      qtdLivres(0),
+      espera(nullptr),
+      capacidadeEspera(0),
+      inicioEspera(0),
+      qtdEspera(0) {
+    estatisticas.zerar();
+}
+
+Frota::~Frota() {
+    liberarMemoria();
+}
+
+void Frota::liberarMemoria() {
+    delete[] xs;
+    delete[] ys;
+    delete[] primeiroCelula;
+    delete[] proximoCelula;
+    delete[] anteriorCelula;
+    delete[] celulaVeiculo;
+    delete[] livres;
+    delete[] posicaoLivre;
+    delete[] espera;
+    xs = ys = nullptr;
+    primeiroCelula = proximoCelula = anteriorCelula = celulaVeiculo = nullptr;
+    livres = posicaoLivre = nullptr;
+    espera = nullptr;
+    numVeiculos = qtdLivres = 0;
+    capacidadeEspera = inicioEspera = qtdEspera = 0;
+}
+
+/*
+ * Lê as posições iniciais, monta a grade e deixa todos os veículos livres.
+ */
+bool Frota::carregar(const char* caminho) {
+    liberarMemoria();
+
+    std::ifstream arquivo(caminho);
+    if (!arquivo) {
+        std::cerr << "nao foi possivel abrir " << caminho << "\n";
+        return false;
+    }
+
+    int n = 0;
+    if (!(arquivo >> n) || n <= 0) {
+        std::cerr << caminho << ": cabecalho invalido (esperado: numVeiculos)\n";
+        return false;
+    }
+
+    numVeiculos = n;
+    xs = new double[n];
+    ys = new double[n];
+    for (int v = 0; v < n; ++v) {
+        if (!(arquivo >> xs[v] >> ys[v]) || !std::isfinite(xs[v]) || !std::isfinite(ys[v])) {
+            std::cerr << caminho << ": posicao invalida do veiculo " << v << "\n";
+            liberarMemoria();
+            return false;
+        }
+    }
+
+    montarGrade();
+
+    proximoCelula = new int[n];
+    anteriorCelula = new int[n];
+    celulaVeiculo = new int[n];
+    livres = new int[n];
+    posicaoLivre = new int[n];
+    for (int v = 0; v < n; ++v) {
+        posicaoLivre[v] = -1;
+        liberar(v);
+    }
+
+    capacidadeEspera = CAPACIDADE_INICIAL_ESPERA;
+    espera = new Corrida*[capacidadeEspera];
+    return true;
+}
+
+/*
+ * Grade com cerca de VEICULOS_POR_CELULA veículos por célula sobre o
+ * retângulo das posições iniciais, todas as células vazias.
+ */
+void Frota::montarGrade() {
+    int n = numVeiculos;
+    double maxX = xs[0], maxY = ys[0];
+    minX = xs[0];
+    minY = ys[0];
+    for (int v = 1; v < n; ++v) {
+        if (xs[v] < minX) minX = xs[v];
+        if (xs[v] > maxX) maxX = xs[v];
+        if (ys[v] < minY) minY = ys[v];
+        if (ys[v] > maxY) maxY = ys[v];
+    }
+
+    double largura = maxX - minX;
+    double altura = maxY - minY;
+    double maior = (largura > altura) ? largura : altura;
+    double celulasDesejadas = n / VEICULOS_POR_CELULA;
+    if (celulasDesejadas < 1.0) celulasDesejadas = 1.0;
+
+    // posições alinhadas (área zero) ficam em uma fileira de células
+    tamCelula = (largura > 0.0 && altura > 0.0)
+                    ? std::sqrt(largura * altura / celulasDesejadas)
+                    : maior / celulasDesejadas;
+    if (!(tamCelula > 0.0)) tamCelula = 1.0;
+
+    colunasGrade = static_cast<int>(largura / tamCelula) + 1;
+    linhasGrade = static_cast<int>(altura / tamCelula) + 1;
+
+    int numCelulas = colunasGrade * linhasGrade;
+    primeiroCelula = new int[numCelulas];
+    for (int c = 0; c < numCelulas; ++c) primeiroCelula[c] = -1;
+}
+
+/*
+ * Célula de p, levando pontos de fora do retângulo para a borda.
+ */
+int Frota::celulaDe(const Ponto& p, int& cx, int& cy) const {
+    double fx = std::floor((p.x - minX) / tamCelula);
+    double fy = std::floor((p.y - minY) / tamCelula);
+    cx = (fx < 0.0) ? 0 : (fx >= colunasGrade) ? colunasGrade - 1 : static_cast<int>(fx);
+    cy = (fy < 0.0) ? 0 : (fy >= linhasGrade) ? linhasGrade - 1 : static_cast<int>(fy);
+    return cy * colunasGrade + cx;
+}
+
+void Frota::inserirNaGrade(int v) {
+    int cx, cy;
+    int c = celulaDe(Ponto{xs[v], ys[v]}, cx, cy);
+    celulaVeiculo[v] = c;
+    anteriorCelula[v] = -1;
+    proximoCelula[v] = primeiroCelula[c];
+    if (primeiroCelula[c] >= 0) anteriorCelula[primeiroCelula[c]] = v;
+    primeiroCelula[c] = v;
+}
+
+void Frota::removerDaGrade(int v) {
+    int c = celulaVeiculo[v];
+    if (anteriorCelula[v] >= 0) {
+        proximoCelula[anteriorCelula[v]] = proximoCelula[v];
+    } else {
+        primeiroCelula[c] = proximoCelula[v];
+    }
+    if (proximoCelula[v] >= 0) anteriorCelula[proximoCelula[v]] = anteriorCelula[v];
+}
+
+/*
+ * Anéis de células em volta da célula de p, como em
+ * GrafoViario::noMaisProximo: um veículo do anel r + 1 está a pelo menos
+ * r células de p (também para os que a borda guarda de fora do retângulo),
+ * então a busca para quando isso passa do melhor já encontrado.
+ */
+int Frota::buscarNaGrade(const Ponto& p) {
+    int cx, cy;
+    celulaDe(p, cx, cy);
+
+    int melhor = -1;
+    double melhorD2 = 0.0;
+    int maxAnel = (colunasGrade > linhasGrade) ? colunasGrade : linhasGrade;
+
+    for (int r = 0; r <= maxAnel; ++r) {
+        for (int y = cy - r; y <= cy + r; ++y) {
+            if (y < 0 || y >= linhasGrade) continue;
+            bool bordaY = (y == cy - r || y == cy + r);
+            // fora das linhas de borda, só as duas colunas extremas são do anel
+            int passo = bordaY ? 1 : 2 * r;
+            for (int x = cx - r; x <= cx + r; x += (passo > 0 ? passo : 1)) {
+                if (x < 0 || x >= colunasGrade) continue;
+                ++estatisticas.celulasVisitadas;
+                for (int v = primeiroCelula[y * colunasGrade + x]; v >= 0; v = proximoCelula[v]) {
+                    double dx = xs[v] - p.x;
+                    double dy = ys[v] - p.y;
+                    double d2 = dx * dx + dy * dy;
+                    if (melhor < 0 || d2 < melhorD2 || (d2 == melhorD2 && v < melhor)) {
+                        melhor = v;
+                        melhorD2 = d2;
+                    }
+                }
+            }
+        }
+        double alcance = r * tamCelula;
+        if (melhor >= 0 && alcance * alcance > melhorD2) break;
+    }
+    return melhor;
+}
+
+int Frota::buscarNaLista(const Ponto& p) const {
+    int melhor = -1;
+    double melhorD2 = 0.0;
+    for (int k = 0; k < qtdLivres; ++k) {
+        int v = livres[k];
+        double dx = xs[v] - p.x;
+        double dy = ys[v] - p.y;
+        double d2 = dx * dx + dy * dy;
+        if (melhor < 0 || d2 < melhorD2 || (d2 == melhorD2 && v < melhor)) {
+            melhor = v;
+            melhorD2 = d2;
+        }
+    }
+    return melhor;
+}
+
+int Frota::getNumVeiculos() const {
+    return numVeiculos;
+}
+
+int Frota::getQtdLivres() const {
+    return qtdLivres;
+}
+
+Ponto Frota::getPosicao(int v) const {
+    return Ponto{xs[v], ys[v]};
+}
+
+/*
+ * Com k livres, os anéis vazios custam por volta de numVeiculos / k células;
+ * a lista custa k. A lista é usada quando k² < 2 numVeiculos.
+ */
+int Frota::ocuparMaisProximo(const Ponto& p) {
+    if (qtdLivres == 0) return -1;
+
+    int v;
+    if (static_cast<long long>(qtdLivres) * qtdLivres < 2LL * numVeiculos) {
+        ++estatisticas.buscasLista;
+        v = buscarNaLista(p);
+    } else {
+        ++estatisticas.buscasGrade;
+        v = buscarNaGrade(p);
+    }
+
+    removerDaGrade(v);
+    int pos = posicaoLivre[v];
+    int ultimo = livres[--qtdLivres];
+    livres[pos] = ultimo;
+    posicaoLivre[ultimo] = pos;
+    posicaoLivre[v] = -1;
+    return v;
+}
+
+void Frota::estacionar(int v, const Ponto& p) {
+    xs[v] = p.x;
+    ys[v] = p.y;
+}
+
+void Frota::liberar(int v) {
+    if (posicaoLivre[v] >= 0) return;
+    posicaoLivre[v] = qtdLivres;
+    livres[qtdLivres++] = v;
+    inserirNaGrade(v);
+}
+
+void Frota::esperar(Corrida* corrida) {
+    if (qtdEspera == capacidadeEspera) {
+        Corrida** novo = new Corrida*[2 * capacidadeEspera];
+        for (int k = 0; k < qtdEspera; ++k) {
+            novo[k] = espera[(inicioEspera + k) % capacidadeEspera];
+        }
+        delete[] espera;
+        espera = novo;
+        capacidadeEspera *= 2;
+        inicioEspera = 0;
+    }
+    espera[(inicioEspera + qtdEspera) % capacidadeEspera] = corrida;
+    ++qtdEspera;
+}
+
+Corrida* Frota::retirarEspera() {
+    if (qtdEspera == 0) return nullptr;
+    Corrida* corrida = espera[inicioEspera];
+    inicioEspera = (inicioEspera + 1) % capacidadeEspera;
+    --qtdEspera;
+    return corrida;
+}
+
+void Frota::registrarAtribuicao(double pedido, double agora, double aproximacao) {
+    double esperou = agora - pedido;
+    ++estatisticas.atribuicoes;
+    if (esperou > 0.0) {
+        ++estatisticas.esperas;
+        estatisticas.tempoEspera += esperou;
+        if (esperou > estatisticas.maiorEspera) estatisticas.maiorEspera = esperou;
+    }
+    estatisticas.aproximacao += aproximacao;
+}
+
+const EstatisticasFrota& Frota::getEstatisticas() const {
+    return estatisticas;
+}
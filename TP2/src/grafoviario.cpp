@@ -0,0 +1,316 @@
+#include "grafoviario.hpp"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+// Nós por célula da grade, em média
+static const double NOS_POR_CELULA = 2.0;
+
+/*
+ * Lê o próximo valor do arquivo, pulando comentários ('#' até o fim da linha).
+ */
+template <typename T>
+static bool lerValor(std::istream& entrada, T& valor) {
+    while (true) {
+        entrada >> std::ws;
+        if (entrada.peek() != '#') break;
+        entrada.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return static_cast<bool>(entrada >> valor);
+}
+
+GrafoViario::GrafoViario()
+    : numNos(0),
+      numArcos(0),
+      xs(nullptr),
+      ys(nullptr),
+      inicioSaidas(nullptr),
+      destinosSaidas(nullptr),
+      pesosSaidas(nullptr),
+      inicioEntradas(nullptr),
+      origensEntradas(nullptr),
+      pesosEntradas(nullptr),
+      fatorReta(0.0),
+      minX(0.0),
+      minY(0.0),
+      tamCelula(1.0),
+      colunasGrade(0),
+      linhasGrade(0),
+      inicioCelulas(nullptr),
+      nosCelulas(nullptr) {}
+
+GrafoViario::~GrafoViario() {
+    liberar();
+}
+
+void GrafoViario::liberar() {
+    delete[] xs;
+    delete[] ys;
+    delete[] inicioSaidas;
+    delete[] destinosSaidas;
+    delete[] pesosSaidas;
+    delete[] inicioEntradas;
+    delete[] origensEntradas;
+    delete[] pesosEntradas;
+    delete[] inicioCelulas;
+    delete[] nosCelulas;
+    xs = ys = nullptr;
+    inicioSaidas = destinosSaidas = inicioEntradas = origensEntradas = nullptr;
+    pesosSaidas = pesosEntradas = nullptr;
+    inicioCelulas = nosCelulas = nullptr;
+    numNos = numArcos = 0;
+}
+
+/*
+ * Lê nós e arcos e monta os vetores de saídas, de entradas e a grade.
+ */
+bool GrafoViario::carregar(const char* caminho) {
+    liberar();
+
+    std::ifstream arquivo(caminho);
+    if (!arquivo) {
+        std::cerr << "nao foi possivel abrir " << caminho << "\n";
+        return false;
+    }
+
+    int n = 0, m = 0;
+    if (!lerValor(arquivo, n) || !lerValor(arquivo, m) || n <= 0 || m < 0) {
+        std::cerr << caminho << ": cabecalho invalido (esperado: numNos numArcos)\n";
+        return false;
+    }
+
+    numNos = n;
+    xs = new double[n];
+    ys = new double[n];
+    for (int i = 0; i < n; ++i) {
+        if (!lerValor(arquivo, xs[i]) || !lerValor(arquivo, ys[i]) ||
+            !std::isfinite(xs[i]) || !std::isfinite(ys[i])) {
+            std::cerr << caminho << ": coordenadas invalidas no no " << i << "\n";
+            liberar();
+            return false;
+        }
+    }
+
+    int* origens = new int[m > 0 ? m : 1];
+    int* destinos = new int[m > 0 ? m : 1];
+    double* pesos = new double[m > 0 ? m : 1];
+    for (int a = 0; a < m; ++a) {
+        bool valido = lerValor(arquivo, origens[a]) && lerValor(arquivo, destinos[a]) &&
+                      lerValor(arquivo, pesos[a]) &&
+                      origens[a] >= 0 && origens[a] < n &&
+                      destinos[a] >= 0 && destinos[a] < n &&
+                      pesos[a] >= 0.0 && std::isfinite(pesos[a]);
+        if (!valido) {
+            std::cerr << caminho << ": arco " << a << " invalido\n";
+            delete[] origens;
+            delete[] destinos;
+            delete[] pesos;
+            liberar();
+            return false;
+        }
+    }
+
+    numArcos = m;
+    montarArcos(origens, destinos, pesos);
+    delete[] origens;
+    delete[] destinos;
+    delete[] pesos;
+
+    montarGrade();
+    return true;
+}
+
+/*
+ * Ordena os arcos por origem (saídas) e por destino (entradas) com uma
+ * contagem por nó, mantendo a ordem do arquivo entre arcos do mesmo nó.
+ * Calcula também o fatorReta.
+ */
+void GrafoViario::montarArcos(const int* origens, const int* destinos, const double* pesos) {
+    int n = numNos;
+    int m = numArcos;
+    inicioSaidas = new int[n + 1]();
+    inicioEntradas = new int[n + 1]();
+    destinosSaidas = new int[m > 0 ? m : 1];
+    pesosSaidas = new double[m > 0 ? m : 1];
+    origensEntradas = new int[m > 0 ? m : 1];
+    pesosEntradas = new double[m > 0 ? m : 1];
+
+    for (int a = 0; a < m; ++a) {
+        ++inicioSaidas[origens[a] + 1];
+        ++inicioEntradas[destinos[a] + 1];
+    }
+    for (int u = 0; u < n; ++u) {
+        inicioSaidas[u + 1] += inicioSaidas[u];
+        inicioEntradas[u + 1] += inicioEntradas[u];
+    }
+
+    int* proximaSaida = new int[n];
+    int* proximaEntrada = new int[n];
+    for (int u = 0; u < n; ++u) {
+        proximaSaida[u] = inicioSaidas[u];
+        proximaEntrada[u] = inicioEntradas[u];
+    }
+
+    fatorReta = 1.0;
+    for (int a = 0; a < m; ++a) {
+        int u = origens[a];
+        int v = destinos[a];
+        int s = proximaSaida[u]++;
+        destinosSaidas[s] = v;
+        pesosSaidas[s] = pesos[a];
+        int e = proximaEntrada[v]++;
+        origensEntradas[e] = u;
+        pesosEntradas[e] = pesos[a];
+
+        double dx = xs[u] - xs[v];
+        double dy = ys[u] - ys[v];
+        double reta = std::sqrt(dx * dx + dy * dy);
+        if (reta > 0.0 && pesos[a] < fatorReta * reta) {
+            fatorReta = pesos[a] / reta;
+        }
+    }
+
+    delete[] proximaSaida;
+    delete[] proximaEntrada;
+}
+
+/*
+ * Grade com cerca de NOS_POR_CELULA nós por célula sobre o retângulo dos nós.
+ */
+void GrafoViario::montarGrade() {
+    int n = numNos;
+    double maxX = xs[0], maxY = ys[0];
+    minX = xs[0];
+    minY = ys[0];
+    for (int i = 1; i < n; ++i) {
+        if (xs[i] < minX) minX = xs[i];
+        if (xs[i] > maxX) maxX = xs[i];
+        if (ys[i] < minY) minY = ys[i];
+        if (ys[i] > maxY) maxY = ys[i];
+    }
+
+    double largura = maxX - minX;
+    double altura = maxY - minY;
+    double maior = (largura > altura) ? largura : altura;
+    double celulasDesejadas = n / NOS_POR_CELULA;
+    if (celulasDesejadas < 1.0) celulasDesejadas = 1.0;
+
+    // nós alinhados (área zero) ficam em uma fileira de células
+    tamCelula = (largura > 0.0 && altura > 0.0)
+                    ? std::sqrt(largura * altura / celulasDesejadas)
+                    : maior / celulasDesejadas;
+    if (!(tamCelula > 0.0)) tamCelula = 1.0;
+
+    colunasGrade = static_cast<int>(largura / tamCelula) + 1;
+    linhasGrade = static_cast<int>(altura / tamCelula) + 1;
+
+    int numCelulas = colunasGrade * linhasGrade;
+    int* celulaDoNo = new int[n];
+    inicioCelulas = new int[numCelulas + 1]();
+    for (int i = 0; i < n; ++i) {
+        int cx = static_cast<int>((xs[i] - minX) / tamCelula);
+        int cy = static_cast<int>((ys[i] - minY) / tamCelula);
+        if (cx >= colunasGrade) cx = colunasGrade - 1;
+        if (cy >= linhasGrade) cy = linhasGrade - 1;
+        celulaDoNo[i] = cy * colunasGrade + cx;
+        ++inicioCelulas[celulaDoNo[i] + 1];
+    }
+    for (int c = 0; c < numCelulas; ++c) {
+        inicioCelulas[c + 1] += inicioCelulas[c];
+    }
+
+    nosCelulas = new int[n];
+    int* proxima = new int[numCelulas];
+    for (int c = 0; c < numCelulas; ++c) proxima[c] = inicioCelulas[c];
+    for (int i = 0; i < n; ++i) {
+        nosCelulas[proxima[celulaDoNo[i]]++] = i;
+    }
+
+    delete[] proxima;
+    delete[] celulaDoNo;
+}
+
+int GrafoViario::getNumNos() const {
+    return numNos;
+}
+
+int GrafoViario::getNumArcos() const {
+    return numArcos;
+}
+
+Ponto GrafoViario::getPonto(int no) const {
+    return Ponto{xs[no], ys[no]};
+}
+
+double GrafoViario::getFatorReta() const {
+    return fatorReta;
+}
+
+/*
+ * Percorre anéis de células em volta da célula de p (a mais próxima, se p
+ * estiver fora da grade). Um nó do anel r + 1 está a pelo menos r células
+ * de p, então a busca para quando isso passa do melhor nó já encontrado.
+ */
+int GrafoViario::noMaisProximo(const Ponto& p) const {
+    int cx = static_cast<int>(std::floor((p.x - minX) / tamCelula));
+    int cy = static_cast<int>(std::floor((p.y - minY) / tamCelula));
+    if (cx < 0) cx = 0;
+    if (cx >= colunasGrade) cx = colunasGrade - 1;
+    if (cy < 0) cy = 0;
+    if (cy >= linhasGrade) cy = linhasGrade - 1;
+
+    int melhor = -1;
+    double melhorD2 = 0.0;
+    int maxAnel = (colunasGrade > linhasGrade) ? colunasGrade : linhasGrade;
+
+    for (int r = 0; r <= maxAnel; ++r) {
+        for (int y = cy - r; y <= cy + r; ++y) {
+            if (y < 0 || y >= linhasGrade) continue;
+            bool bordaY = (y == cy - r || y == cy + r);
+            // fora das linhas de borda, só as duas colunas extremas são do anel
+            int passo = bordaY ? 1 : 2 * r;
+            for (int x = cx - r; x <= cx + r; x += (passo > 0 ? passo : 1)) {
+                if (x < 0 || x >= colunasGrade) continue;
+                int c = y * colunasGrade + x;
+                for (int k = inicioCelulas[c]; k < inicioCelulas[c + 1]; ++k) {
+                    int no = nosCelulas[k];
+                    double dx = xs[no] - p.x;
+                    double dy = ys[no] - p.y;
+                    double d2 = dx * dx + dy * dy;
+                    if (melhor < 0 || d2 < melhorD2 || (d2 == melhorD2 && no < melhor)) {
+                        melhor = no;
+                        melhorD2 = d2;
+                    }
+                }
+            }
+        }
+        double alcance = r * tamCelula;
+        if (melhor >= 0 && alcance * alcance > melhorD2) break;
+    }
+    return melhor;
+}
+
+const int* GrafoViario::getInicioSaidas() const {
+    return inicioSaidas;
+}
+
+const int* GrafoViario::getDestinosSaidas() const {
+    return destinosSaidas;
+}
+
+const double* GrafoViario::getPesosSaidas() const {
+    return pesosSaidas;
+}
+
+const int* GrafoViario::getInicioEntradas() const {
+    return inicioEntradas;
+}
+
+const int* GrafoViario::getOrigensEntradas() const {
+    return origensEntradas;
+}
+
+const double* GrafoViario::getPesosEntradas() const {
+    return pesosEntradas;
+}
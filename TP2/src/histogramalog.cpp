@@ -0,0 +1,111 @@
+#include "histogramalog.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+HistogramaLog::HistogramaLog() {
+    zerar();
+}
+
+void HistogramaLog::zerar() {
+    std::memset(contagens, 0, sizeof(contagens));
+    total = 0;
+    soma = 0.0;
+    minimo = 0.0;
+    maximo = 0.0;
+}
+
+/*
+ * Balde de uma magnitude positiva e normal: a oitava vem do expoente e o
+ * subbalde dos BITS_SUBBALDE primeiros bits da mantissa.
+ */
+int HistogramaLog::baldeMagnitude(double magnitude) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &magnitude, sizeof(bits));
+    int expoente = static_cast<int>((bits >> 52) & 0x7ff) - 1023;
+    int sub = static_cast<int>((bits >> (52 - BITS_SUBBALDE)) & (SUBBALDES - 1));
+
+    int oitava = expoente - EXPOENTE_MINIMO;
+    if (oitava >= NUM_OITAVAS) return BALDES_MAGNITUDE - 1;
+    return oitava * SUBBALDES + sub;
+}
+
+double HistogramaLog::centroMagnitude(int balde) {
+    int oitava = balde / SUBBALDES;
+    int sub = balde % SUBBALDES;
+    return std::ldexp(1.0 + (sub + 0.5) / SUBBALDES, oitava + EXPOENTE_MINIMO);
+}
+
+void HistogramaLog::registrar(double v) {
+    if (!(v == v)) return;   // NaN não entra
+
+    double magnitude = (v < 0.0) ? -v : v;
+    int balde = BALDES_MAGNITUDE;   // zero
+    if (magnitude >= std::ldexp(1.0, EXPOENTE_MINIMO)) {
+        int m = baldeMagnitude(magnitude);
+        balde = (v < 0.0) ? BALDES_MAGNITUDE - 1 - m : BALDES_MAGNITUDE + 1 + m;
+    }
+    ++contagens[balde];
+
+    if (total == 0 || v < minimo) minimo = v;
+    if (total == 0 || v > maximo) maximo = v;
+    soma += v;
+    ++total;
+}
+
+void HistogramaLog::somar(const HistogramaLog& outro) {
+    if (outro.total == 0) return;
+    for (int b = 0; b < NUM_BALDES; ++b) {
+        contagens[b] += outro.contagens[b];
+    }
+    if (total == 0 || outro.minimo < minimo) minimo = outro.minimo;
+    if (total == 0 || outro.maximo > maximo) maximo = outro.maximo;
+    soma += outro.soma;
+    total += outro.total;
+}
+
+long long HistogramaLog::getTotal() const {
+    return total;
+}
+
+double HistogramaLog::getMedia() const {
+    return (total > 0) ? soma / total : 0.0;
+}
+
+double HistogramaLog::getMinimo() const {
+    return minimo;
+}
+
+double HistogramaLog::getMaximo() const {
+    return maximo;
+}
+
+/*
+ * Percorre os baldes em ordem crescente de valor até acumular
+ * ceil(p * total) registros.
+ */
+double HistogramaLog::percentil(double p) const {
+    if (total == 0) return 0.0;
+
+    long long posicao = static_cast<long long>(std::ceil(p * total));
+    if (posicao < 1) posicao = 1;
+    if (posicao >= total) return maximo;
+
+    long long acumulado = 0;
+    int balde = 0;
+    for (; balde < NUM_BALDES; ++balde) {
+        acumulado += contagens[balde];
+        if (acumulado >= posicao) break;
+    }
+
+    double valor = 0.0;
+    if (balde > BALDES_MAGNITUDE) {
+        valor = centroMagnitude(balde - BALDES_MAGNITUDE - 1);
+    } else if (balde < BALDES_MAGNITUDE) {
+        valor = -centroMagnitude(BALDES_MAGNITUDE - 1 - balde);
+    }
+
+    if (valor < minimo) valor = minimo;
+    if (valor > maximo) valor = maximo;
+    return valor;
+}
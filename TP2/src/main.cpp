@@ -1,72 +1,175 @@
 #include <iostream>
 #include <iomanip>
-#include <cmath>
+#include <cstring>
+#include <fstream>
 
 #include "demanda.hpp"
 #include "corrida.hpp"
 #include "escalonador.hpp"
+#include "agrupador.hpp"
+#include "parametros.hpp"
+#include "opcoes.hpp"
+#include "poolthreads.hpp"
+#include "fontegrupos.hpp"
+#include "fontecontinua.hpp"
+#include "medidorlatencia.hpp"
+#include "saidaassincrona.hpp"
+#include "simulacaoanalitica.hpp"
+#include "varredura.hpp"
+#include "metricas.hpp"
+#include "tabelademandas.hpp"
+#include "arquivocolunar.hpp"
+#include "grafoviario.hpp"
+#include "redeviaria.hpp"
+#include "pontocontrole.hpp"
+#include "frota.hpp"
+#include "entradademandas.hpp"
+#include "fragmentos.hpp"
+#include "qualidadeservico.hpp"
+#include "particaoregioes.hpp"
+#include "simulacaoregioes.hpp"
+#include "rastro.hpp"
 
 using namespace std;
 
+// Capacidade inicial da fila de eventos; ela cresce com as corridas em andamento
+static const int CAPACIDADE_INICIAL_EVENTOS = 1024;
+
 /*
- * Calcula a distância euclidiana entre dois pontos do plano.
- * Essa função é usada tanto para distâncias individuais das demandas
- * quanto para a rota compartilhada construída para um grupo.
+ * Espera a thread escritora terminar e devolve o streambuf original ao cout.
  */
-double distPontos(const Ponto& a, const Ponto& b) {
-    double dx = a.x - b.x;
-    double dy = a.y - b.y;
-    return std::sqrt(dx * dx + dy * dy);
+static void encerrarSaida(SaidaAssincrona* saida, streambuf* original) {
+    if (!saida) return;
+    RASTRO_TRECHO("fim da saida");
+    cout.flush();
+    saida->fechar();
+    cout.rdbuf(original);
+    delete saida;
 }
 
 /*
- * Calcula a distância total percorrida por uma rota compartilhada de um grupo.
- * O modelo adotado é:
- *  - visitar todas as origens na ordem em que aparecem no grupo
- *  - depois visitar os destinos na mesma ordem
- *
- * Esse padrão corresponde exatamente ao modelo de rota usado na classe Corrida.
+ * Modo contínuo: as demandas são lidas uma a uma enquanto a simulação avança,
+ * e cada corrida é impressa assim que termina, sem esperar o fim da entrada.
+ * A memória usada depende só das corridas em andamento. Com métricas, escreve
+ * ao final em std::cerr a latência entre a leitura do grupo e a impressão da
+ * corrida. Retorna false se a entrada não estava ordenada por tempo: a leitura
+ * para na primeira demanda fora de ordem, e só as corridas já formadas saem.
  */
-double distanciaRota(const Demanda* demandas, const int* grupo, int tamGrupo) {
-    if (tamGrupo == 0) return 0.0;
+static bool simularContinuo(const Parametros& params, EntradaDemandas& entrada, TipoFila fila,
+                            bool corrotinas, SaidaAssincrona* saida, Metricas* metricas,
+                            Frota* frota, QualidadeServico* qualidade) {
+    // esvazia a saída antes de cada leitura que possa bloquear
+    cin.tie(&cout);
+
+    Escalonador escalonador(CAPACIDADE_INICIAL_EVENTOS, params.gama, fila);
+    MedidorLatencia medidor;
+    if (metricas) escalonador.setObservador(&medidor);
+    escalonador.setSaida(saida);
+    escalonador.setMetricas(metricas);
+    escalonador.setFrota(frota);
+    escalonador.setQualidade(qualidade);
+
+    cout << fixed << setprecision(2);
 
-    double d = 0.0;
-    Ponto anterior = demandas[grupo[0]].getOrigem();
+    FonteContinua fonte(entrada, params);
+    if (corrotinas) {
+        escalonador.simularCorrotinas(&fonte);
+    } else {
+        escalonador.simularEImprimir(&fonte);
+    }
+    cout.flush();
+
+    if (metricas) {
+        medidor.imprimirResumo(cerr);
+        fonte.coletarContadores(metricas->agrupamento);
+    }
 
-    // sequência de origens
-    for (int i = 1; i < tamGrupo; ++i) {
-        Ponto atual = demandas[grupo[i]].getOrigem();
-        d += distPontos(anterior, atual);
-        anterior = atual;
+    int id;
+    if (fonte.getForaDeOrdem(id)) {
+        cerr << "demanda " << id << " fora de ordem: --continuo precisa da entrada "
+                "ordenada por tempo de solicitacao\n";
+        return false;
     }
+    return true;
+}
+
+/*
+ * Lê as numDemandas linhas de demandas da entrada de texto para as colunas.
+ */
+static TabelaDemandas* lerDemandas(istream& entrada, int numDemandas) {
+    RASTRO_TRECHO("leitura");
+    TabelaDemandas* tabela = new TabelaDemandas(numDemandas);
+
+    for (int i = 0; i < numDemandas; ++i) {
+        int id;
+        double tempo;
+        Ponto origem, destino;
 
-    // última origem -> primeiro destino
-    Ponto primeiroDestino = demandas[grupo[0]].getDestino();
-    d += distPontos(anterior, primeiroDestino);
-    anterior = primeiroDestino;
+        entrada >> id >> tempo
+                >> origem.x >> origem.y
+                >> destino.x >> destino.y;
 
-    // sequência de destinos
-    for (int i = 1; i < tamGrupo; ++i) {
-        Ponto atual = demandas[grupo[i]].getDestino();
-        d += distPontos(anterior, atual);
-        anterior = atual;
+        tabela->definir(i, id, tempo, origem, destino);
     }
+    return tabela;
+}
 
-    return d;
+/*
+ * Escreve as métricas no destino de --metricas ("-" é std::cerr).
+ */
+static void escreverMetricas(const Metricas& metricas, const char* destino) {
+    if (strcmp(destino, "-") == 0) {
+        metricas.escreverJson(cerr);
+        return;
+    }
+    ofstream arquivo(destino);
+    if (!arquivo) {
+        cerr << "nao foi possivel escrever as metricas em " << destino << "\n";
+        return;
+    }
+    metricas.escreverJson(arquivo);
 }
 
 /*
- * Soma das distâncias individuais das demandas:
- * É a distância que os passageiros gastariam se fossem transportados sozinhos.
- * Usado para calcular a eficiência λ do compartilhamento.
+ * Continua a simulação por eventos de um ponto de controle (--retomar). A
+ * saída segue do byte em que o ponto de controle parou (ver posicionarSaida),
+ * então o arquivo completo fica igual ao de uma execução sem interrupção.
  */
-double distanciaIndividualTotal(const Demanda* demandas, const int* grupo, int tamGrupo) {
-    double soma = 0.0;
-    for (int i = 0; i < tamGrupo; ++i) {
-        const Demanda& d = demandas[grupo[i]];
-        soma += distPontos(d.getOrigem(), d.getDestino());
+static int retomarSimulacao(const Opcoes& opcoes, Metricas* metricas) {
+    double marca = iniciarFase(metricas);
+    RetomadaSimulacao retomada;
+    if (!retomada.ler(opcoes.retomar) || !posicionarSaida(retomada.getDeslocamentoSaida())) {
+        return 1;
+    }
+    marcarFase(metricas, FASE_LEITURA, marca);
+
+    streambuf* saidaOriginal = cout.rdbuf();
+    SaidaContada contada(saidaOriginal, retomada.getDeslocamentoSaida());
+    cout.rdbuf(&contada);
+    cout << fixed << setprecision(2);
+
+    const Parametros& params = retomada.getParametros();
+    Escalonador escalonador(CAPACIDADE_INICIAL_EVENTOS, params.gama, opcoes.fila);
+    escalonador.setMetricas(metricas);
+    QualidadeServico* qualidade = opcoes.qualidade ? new QualidadeServico(params.gama) : nullptr;
+    escalonador.setQualidade(qualidade);
+    retomada.restaurar(escalonador);
+
+    FonteGrupos fonte(retomada.getTabela(), retomada.getLimites(), retomada.getQtdGrupos(),
+                      retomada.getQtdPendentes());
+    PontoControle pontoControle(opcoes.pontoControle, params, fonte, contada);
+    if (opcoes.pontoControle) {
+        escalonador.setPontoControle(&pontoControle, opcoes.intervaloControle);
     }
-    return soma;
+    escalonador.simularEImprimir(&fonte);
+
+    marca = iniciarFase(metricas);
+    cout.flush();
+    cout.rdbuf(saidaOriginal);
+    marcarFase(metricas, FASE_IMPRESSAO, marca);
+    if (qualidade) qualidade->imprimirResumo(cerr);
+    delete qualidade;
+    return 0;
 }
 
 /*
@@ -79,130 +182,301 @@ double distanciaIndividualTotal(const Demanda* demandas, const int* grupo, int t
  *       - distância entre destinos β
  *       - eficiência mínima λ
  *       - capacidade η
- * 4) Para cada grupo encontrado, monta uma Corrida,
- *    constrói a rota e agenda no Escalonador.
- * 5) Executa a simulação e imprime o resultado no formato especificado.
+ * 4) Executa a simulação e imprime o resultado no formato especificado.
+ *    A Corrida de cada grupo é montada (rota e trechos) quando começa
+ *    e liberada assim que termina.
+ *
+ * Com --threads N, o agrupamento do passo 3 roda em paralelo (ver agruparDemandas);
+ * com --fila calendario, o Escalonador usa a fila calendário no lugar do heap,
+ * e com --motor corrotinas cada corrida do passo 4 é uma corrotina.
+ * Com --continuo, os passos 2 a 4 acontecem juntos (ver simularContinuo);
+ * com --saida assincrona, as linhas são escritas por uma thread à parte;
+ * com --analitico, o passo 4 dispensa a fila de eventos, com empates por
+ * ordem de chegada (ver simularAnalitico);
+ * com --varredura ARQ, os passos 3 e 4 são repetidos para cada conjunto de
+ * parâmetros de ARQ (os do cabeçalho da entrada são ignorados);
+ * com --metricas DESTINO, contadores e tempos por fase são escritos em JSON
+ * (no modo contínuo, leitura e agrupamento entram no tempo de montagem, e a
+ * latência de cada corrida é resumida em std::cerr; com --regioes, só há os
+ * tempos, e divisão, agrupamento e montagem entram no de simulação), e os
+ * resumos de --frota, --fragmentos e --regioes vão para std::cerr;
+ * com --binario ARQ, os passos 1 e 2 são só o mapeamento de ARQ, e o
+ * agrupamento lê as colunas direto do arquivo (ver ArquivoColunar);
+ * com --converter ARQ, as demandas lidas são gravadas em ARQ e nada é simulado;
+ * com --grafo ARQ, as distâncias do passo 3 em diante são as da malha viária
+ * de ARQ, e ao final o uso do cache de distâncias é escrito em std::cerr;
+ * com --ponto-controle ARQ, o passo 4 grava seu estado em ARQ a cada
+ * --intervalo-controle corridas, e --retomar ARQ continua dali sem os
+ * passos 1 a 3 (ver retomarSimulacao);
+ * com --frota ARQ, o passo 4 só tem os veículos de ARQ: cada corrida espera
+ * o livre mais próximo chegar ao primeiro embarque (ver Frota);
+ * com --fragmentos ARQ..., os passos 1 e 2 são o mapeamento dos arquivos
+ * binários, e o modo contínuo recebe as demandas deles intercaladas por
+ * tempo (ver MesclaFragmentos);
+ * com --qualidade, espera, desvio, ocupação e duração das corridas são
+ * medidas no passo 4, e média e percentis são escritos em std::cerr;
+ * com --regioes ARQ, os passos 3 e 4 rodam à parte para cada região de ARQ
+ * e para as demandas entre regiões, em paralelo, e as saídas são mescladas
+ * pelo tempo final (ver SimulacaoRegioes);
+ * com --rastro ARQ (compilado com make re RASTRO=1), agrupamento, corridas,
+ * paradas e fases são gravados e escritos em ARQ ao fim (ver rastro.hpp).
  */
-int main() {
+int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
-    int eta;            // capacidade do veículo
-    double gama;        // velocidade de deslocamento
-    double delta;       // janela máxima para combinar corridas
-    double alfa;        // limite de distância entre origens
-    double beta;        // limite de distância entre destinos
-    double lambda;      // eficiência mínima exigida
-    int numDemandas;    // número total de solicitações
-
-    // Caso entrada inesperada, encerra silenciosamente
-    if (!(cin >> eta)) {
-        return 0;
+    Opcoes opcoes;
+    if (!lerOpcoes(argc, argv, opcoes)) {
+        return 1;
+    }
+    if (opcoes.rastro && !iniciarRastro(opcoes.rastro)) {
+        return 1;
     }
 
-    cin >> gama >> delta >> alfa >> beta >> lambda >> numDemandas;
+    if (opcoes.retomar) {
+        Metricas coletadas;
+        coletadas.zerar();
+        int status = retomarSimulacao(opcoes, opcoes.metricas ? &coletadas : nullptr);
+        if (status == 0 && opcoes.metricas) escreverMetricas(coletadas, opcoes.metricas);
+        return status;
+    }
 
-    // Vetor de todas as demandas
-    Demanda* demandas = new Demanda[numDemandas];
+    // conjuntos da varredura, lidos antes das demandas para falhar cedo
+    Parametros* configuracoes = nullptr;
+    int qtdConfiguracoes = 0;
+    if (opcoes.varredura) {
+        ifstream arquivo(opcoes.varredura);
+        if (!arquivo) {
+            cerr << "nao foi possivel abrir " << opcoes.varredura << "\n";
+            return 1;
+        }
+        configuracoes = lerConfiguracoes(arquivo, qtdConfiguracoes);
+        if (!configuracoes) {
+            return 1;
+        }
+    }
 
-    // Leitura das demandas
-    for (int i = 0; i < numDemandas; ++i) {
-        int id;
-        double tempo;
-        Ponto origem, destino;
+    // malha viária, também lida antes das demandas
+    GrafoViario grafo;
+    if (opcoes.grafo && !grafo.carregar(opcoes.grafo)) {
+        delete[] configuracoes;
+        return 1;
+    }
 
-        cin >> id >> tempo
-            >> origem.x >> origem.y
-            >> destino.x >> destino.y;
+    // frota, também lida antes das demandas
+    Frota frotaCarregada;
+    Frota* frota = nullptr;
+    if (opcoes.frota) {
+        if (!frotaCarregada.carregar(opcoes.frota)) {
+            delete[] configuracoes;
+            return 1;
+        }
+        frota = &frotaCarregada;
+    }
 
-        demandas[i] = Demanda(id, tempo, origem, destino);
+    // partição em regiões, também lida antes das demandas
+    ParticaoRegioes particao;
+    if (opcoes.regioes && !particao.carregar(opcoes.regioes)) {
+        delete[] configuracoes;
+        return 1;
     }
 
-    // marcação de demandas já agrupadas
-    bool* usada = new bool[numDemandas];
-    for (int i = 0; i < numDemandas; ++i) {
-        usada[i] = false;
+    // métricas (ver metricas.hpp); sem --metricas nada é medido
+    Metricas coletadas;
+    coletadas.zerar();
+    Metricas* metricas = opcoes.metricas ? &coletadas : nullptr;
+    double marca = iniciarFase(metricas);
+
+    Parametros params;    // η, γ, δ, α, β, λ
+    int numDemandas = 0;  // número total de solicitações
+
+    // fragmentos: parâmetros dos arquivos mapeados, demandas mescladas
+    // durante a simulação (ordenados em paralelo com --threads)
+    MesclaFragmentos mescla;
+    // entrada binária: parâmetros e demandas já estão no arquivo mapeado
+    ArquivoColunar arquivoColunar;
+    if (opcoes.qtdFragmentos > 0) {
+        PoolThreads* poolOrdenacao = (opcoes.threads > 1) ? new PoolThreads(opcoes.threads) : nullptr;
+        bool aberta = mescla.abrir(opcoes.fragmentos, opcoes.qtdFragmentos, poolOrdenacao);
+        delete poolOrdenacao;
+        if (!aberta) {
+            delete[] configuracoes;
+            return 1;
+        }
+        params = mescla.getParametros();
+        marca = marcarFase(metricas, FASE_LEITURA, marca);
+    } else if (opcoes.binario) {
+        if (!arquivoColunar.abrir(opcoes.binario)) {
+            delete[] configuracoes;
+            return 1;
+        }
+        params = arquivoColunar.getParametros();
+    } else {
+        // Caso entrada inesperada, encerra silenciosamente
+        if (!(cin >> params.eta)) {
+            delete[] configuracoes;
+            return 0;
+        }
+
+        cin >> params.gama >> params.delta >> params.alfa
+            >> params.beta >> params.lambda >> numDemandas;
     }
 
-    // vetor temporário para montar cada grupo
-    int* grupo = new int[eta];
+    if (opcoes.converter) {
+        TabelaDemandas* tabela = lerDemandas(cin, numDemandas);
+        bool gravado = gravarArquivoColunar(opcoes.converter, params, *tabela);
+        delete tabela;
+        return gravado ? 0 : 1;
+    }
 
-    Escalonador escalonador(numDemandas, gama);
+    // distribuições da qualidade do serviço, medidas ao fim de cada corrida
+    QualidadeServico* qualidade = opcoes.qualidade ? new QualidadeServico(params.gama) : nullptr;
 
-    cout << fixed << setprecision(2);
+    // com a saída assíncrona, std::cout passa a escrever no anel de blocos
+    streambuf* saidaOriginal = cout.rdbuf();
+    SaidaAssincrona* saida = nullptr;
+    if (opcoes.saidaAssincrona) {
+        saida = new SaidaAssincrona(saidaOriginal);
+        cout.rdbuf(saida);
+    }
 
-    // algoritmo de agrupamento guloso baseado nas restrições (δ, α, β, λ, η)
-    for (int i = 0; i < numDemandas; ++i) {
-        if (usada[i]) continue;
-
-        Demanda& c0 = demandas[i];
-
-        int tamGrupo = 0;
-        grupo[tamGrupo++] = i;
-        usada[i] = true;
-
-        // tenta adicionar cj ao grupo de c0
-        for (int j = i + 1; j < numDemandas; ++j) {
-            Demanda& cj = demandas[j];
-
-            // restrição da janela temporal δ
-            if (cj.getTempoSolicitacao() - c0.getTempoSolicitacao() >= delta) {
-                break;
-            }
-
-            if (usada[j]) continue;
-            if (tamGrupo >= eta) break; // capacidade cheia
-
-            // restrições espaciais α e β
-            bool ok = true;
-            for (int g = 0; g < tamGrupo; ++g) {
-                const Demanda& dExistente = demandas[grupo[g]];
-                double distOrig = distPontos(cj.getOrigem(), dExistente.getOrigem());
-                double distDest = distPontos(cj.getDestino(), dExistente.getDestino());
-                if (distOrig > alfa || distDest > beta) {
-                    ok = false;
-                    break;
-                }
-            }
-            if (!ok) {
-                break;
-            }
-
-            // verifica eficiência λ com cj incluída
-            grupo[tamGrupo] = j;
-            int novoTam = tamGrupo + 1;
-
-            double distRota = distanciaRota(demandas, grupo, novoTam);
-            double distInd = distanciaIndividualTotal(demandas, grupo, novoTam);
-
-            double eficiencia = (distRota > 0.0) ? (distInd / distRota) : 1.0;
-
-            if (eficiencia <= lambda) {
-                break;
-            }
-
-            // adiciona a nova demanda ao grupo
-            tamGrupo = novoTam;
-            usada[j] = true;
+    if (opcoes.continuo || opcoes.qtdFragmentos > 0) {
+        EntradaTexto texto(cin, numDemandas);
+        EntradaDemandas& entrada = (opcoes.qtdFragmentos > 0)
+                                       ? static_cast<EntradaDemandas&>(mescla) : texto;
+        bool ordenada = simularContinuo(params, entrada, opcoes.fila, opcoes.corrotinas, saida,
+                                        metricas, frota, qualidade);
+        marca = iniciarFase(metricas);
+        encerrarSaida(saida, saidaOriginal);
+        cout.flush();
+        marcarFase(metricas, FASE_IMPRESSAO, marca);
+        if (metricas) {
+            escreverMetricas(coletadas, opcoes.metricas);
+            if (frota) frota->getEstatisticas().imprimirResumo(cerr);
+            if (opcoes.qtdFragmentos > 0) mescla.imprimirResumo(cerr);
         }
+        if (qualidade) qualidade->imprimirResumo(cerr);
+        delete qualidade;
+        return ordenada ? 0 : 1;
+    }
 
-        // monta a Corrida correspondente ao grupo encontrado
-        Corrida* corrida = new Corrida(tamGrupo);
-        for (int g = 0; g < tamGrupo; ++g) {
-            corrida->adicionarDemanda(&demandas[grupo[g]]);
+    // Tabela de demandas: lida do texto ou, com o arquivo mapeado, só a parte
+    // fria (as colunas quentes são usadas no lugar)
+    TabelaDemandas* tabela;
+    if (opcoes.binario) {
+        tabela = new TabelaDemandas(arquivoColunar.getColunas(), arquivoColunar.getIds());
+    } else {
+        tabela = lerDemandas(cin, numDemandas);
+    }
+    const ColunasDemandas& demandas = tabela->getColunas();
+    marca = marcarFase(metricas, FASE_LEITURA, marca);
+
+    if (opcoes.regioes) {
+        // uma tarefa por região; sem --threads, uma thread por região até o
+        // número de núcleos
+        SimulacaoRegioes simulacao;
+        simulacao.dividir(*tabela, particao);
+        int threads = opcoes.threads;
+        if (!opcoes.threadsDefinido) {
+            int nucleos = static_cast<int>(thread::hardware_concurrency());
+            threads = (simulacao.getQtdTarefas() < nucleos) ? simulacao.getQtdTarefas() : nucleos;
         }
+        PoolThreads* poolRegioes = (threads > 1) ? new PoolThreads(threads) : nullptr;
+        simulacao.simular(params, opcoes.fila, opcoes.corrotinas, poolRegioes, qualidade);
+        delete poolRegioes;
+        marca = marcarFase(metricas, FASE_SIMULACAO, marca);
+
+        simulacao.escrever(cout);
+        encerrarSaida(saida, saidaOriginal);
+        cout.flush();
+        marcarFase(metricas, FASE_IMPRESSAO, marca);
+        if (metricas) {
+            escreverMetricas(coletadas, opcoes.metricas);
+            simulacao.imprimirResumo(cerr);
+        }
+        if (qualidade) qualidade->imprimirResumo(cerr);
+        delete qualidade;
+        delete tabela;
+        return 0;
+    }
 
-        corrida->construirRotaBasica();
-        corrida->calcularTrechosEDistancia();
+    Escalonador escalonador(CAPACIDADE_INICIAL_EVENTOS, params.gama, opcoes.fila);
 
-        escalonador.adicionarCorrida(corrida);
+    cout << fixed << setprecision(2);
+
+    // agrupamento guloso (em paralelo por blocos independentes se pedido)
+    PoolThreads* pool = (opcoes.threads > 1) ? new PoolThreads(opcoes.threads) : nullptr;
+
+    if (configuracoes) {
+        // um conjunto de parâmetros por tarefa, sobre as mesmas demandas
+        executarVarredura(demandas, tabela->getIds(), configuracoes, qtdConfiguracoes,
+                          pool, opcoes.prefixoVarredura, cout);
+        delete pool;
+        encerrarSaida(saida, saidaOriginal);
+        delete[] configuracoes;
+        delete tabela;
+        return 0;
     }
 
-    escalonador.simularEImprimir();
+    // modo viário: nós das demandas agora; os trechos, durante o agrupamento
+    RedeViaria* rede = nullptr;
+    if (opcoes.grafo) {
+        rede = new RedeViaria(grafo, demandas, params.delta);
+        tabela->definirTrechos(rede->getTrechosEmbarque(), rede->getTrechosDesembarque());
+    }
 
-    delete[] grupo;
-    delete[] usada;
-    delete[] demandas;
+    int qtdGrupos;
+    int* limites = agruparDemandas(demandas, params, pool, qtdGrupos,
+                                   metricas ? &coletadas.agrupamento : nullptr, rede,
+                                   tabela->getIds());
+    marcarFase(metricas, FASE_AGRUPAMENTO, marca);
+
+    if (opcoes.analitico) {
+        // sem fila de eventos (as corridas não interagem); empates no tempo
+        // final saem por ordem de chegada, como com --fila calendario
+        simularAnalitico(demandas, limites, qtdGrupos, params.gama, pool, cout, metricas,
+                         qualidade);
+    } else {
+        // as corridas são construídas durante a simulação, quando começam
+        FonteGrupos fonte(*tabela, limites, qtdGrupos);
+        escalonador.setSaida(saida);
+        escalonador.setMetricas(metricas);
+        escalonador.setFrota(frota);
+        escalonador.setQualidade(qualidade);
+
+        // com ponto de controle, std::cout passa a contar os bytes escritos
+        SaidaContada contada(saidaOriginal, 0);
+        PontoControle pontoControle(opcoes.pontoControle, params, fonte, contada);
+        if (opcoes.pontoControle) {
+            cout.rdbuf(&contada);
+            escalonador.setPontoControle(&pontoControle, opcoes.intervaloControle);
+        }
+        if (opcoes.corrotinas) {
+            escalonador.simularCorrotinas(&fonte);
+        } else {
+            escalonador.simularEImprimir(&fonte);
+        }
+        if (opcoes.pontoControle) {
+            cout.flush();
+            cout.rdbuf(saidaOriginal);
+        }
+    }
+    delete pool;
+
+    // o que ainda estiver no buffer de saída conta como impressão
+    marca = iniciarFase(metricas);
+    encerrarSaida(saida, saidaOriginal);
+    cout.flush();
+    marcarFase(metricas, FASE_IMPRESSAO, marca);
+    if (metricas) escreverMetricas(coletadas, opcoes.metricas);
+    if (rede) rede->getEstatisticas().imprimirResumo(cerr);
+    if (frota && metricas) frota->getEstatisticas().imprimirResumo(cerr);
+    if (qualidade) qualidade->imprimirResumo(cerr);
+
+    delete qualidade;
+    delete[] limites;
+    delete tabela;
+    delete rede;
 
     return 0;
 }
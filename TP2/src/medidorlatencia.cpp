@@ -0,0 +1,29 @@
+#include "medidorlatencia.hpp"
+#include "cronometro.hpp"
+#include <ostream>
+
+MedidorLatencia::MedidorLatencia()
+    : qtdCorridas(0),
+      soma(0.0),
+      minima(0.0),
+      maxima(0.0) {}
+
+/*
+ * A corrida acabou de ser impressa: a latência vai até agora.
+ */
+void MedidorLatencia::corridaFinalizada(const Corrida& c) {
+    double latencia = instanteAtual() - c.getInstanteEntrada();
+
+    if (qtdCorridas == 0 || latencia < minima) minima = latencia;
+    if (qtdCorridas == 0 || latencia > maxima) maxima = latencia;
+    soma += latencia;
+    ++qtdCorridas;
+}
+
+void MedidorLatencia::imprimirResumo(std::ostream& out) const {
+    double media = (qtdCorridas > 0) ? soma / qtdCorridas : 0.0;
+    out << "latencia: corridas " << qtdCorridas
+        << " media_ms " << media * 1e3
+        << " min_ms " << minima * 1e3
+        << " max_ms " << maxima * 1e3 << "\n";
+}
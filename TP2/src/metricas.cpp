@@ -0,0 +1,127 @@
+#include "metricas.hpp"
+#include "cronometro.hpp"
+#include "compatibilidade.hpp"
+#include <iomanip>
+#include <ostream>
+
+static const char* NOMES_RECUSA[NUM_MOTIVOS_RECUSA] = {"delta", "eta", "alfa", "beta", "lambda"};
+
+static const char* NOMES_FASE[NUM_FASES] = {
+    "leitura", "agrupamento", "montagem", "simulacao", "impressao"
+};
+
+const char* nomeMotivoRecusa(MotivoRecusa motivo) {
+    return NOMES_RECUSA[motivo];
+}
+
+void ContadoresAgrupamento::zerar() {
+    candidatos = 0;
+    for (int m = 0; m < NUM_MOTIVOS_RECUSA; ++m) {
+        recusas[m] = 0;
+    }
+    recusasLambdaSemRaiz = 0;
+    reavaliacoesCompletas = 0;
+    raizes = 0;
+    grupos = 0;
+    for (int k = 0; k <= MAX_TAM_HISTOGRAMA; ++k) {
+        tamanhos[k] = 0;
+    }
+}
+
+void ContadoresAgrupamento::somar(const ContadoresAgrupamento& outros) {
+    candidatos += outros.candidatos;
+    for (int m = 0; m < NUM_MOTIVOS_RECUSA; ++m) {
+        recusas[m] += outros.recusas[m];
+    }
+    recusasLambdaSemRaiz += outros.recusasLambdaSemRaiz;
+    reavaliacoesCompletas += outros.reavaliacoesCompletas;
+    raizes += outros.raizes;
+    grupos += outros.grupos;
+    for (int k = 0; k <= MAX_TAM_HISTOGRAMA; ++k) {
+        tamanhos[k] += outros.tamanhos[k];
+    }
+}
+
+void ContadoresAgrupamento::registrarGrupo(int tamanho) {
+    ++grupos;
+    ++tamanhos[tamanho < MAX_TAM_HISTOGRAMA ? tamanho : MAX_TAM_HISTOGRAMA];
+}
+
+void ContadoresFila::zerar() {
+    insercoes = 0;
+    remocoes = 0;
+    iniciosDiretos = 0;
+    tamanhoMaximo = 0;
+}
+
+void Metricas::zerar() {
+    agrupamento.zerar();
+    fila.zerar();
+    for (int f = 0; f < NUM_FASES; ++f) {
+        tempoFase[f] = 0.0;
+    }
+}
+
+double iniciarFase(const Metricas* metricas) {
+    return metricas ? instanteAtual() : 0.0;
+}
+
+/*
+ * Soma à fase o tempo desde `inicio` e devolve o instante atual.
+ */
+double marcarFase(Metricas* metricas, FaseExecucao fase, double inicio) {
+    if (!metricas) return 0.0;
+    double agora = instanteAtual();
+    metricas->tempoFase[fase] += agora - inicio;
+    return agora;
+}
+
+/*
+ * Um objeto JSON com as fases (em segundos), os contadores do agrupamento
+ * (e a versão da verificação de α e β em uso, ver compatibilidade.hpp),
+ * o histograma de tamanhos dos grupos (só tamanhos presentes) e os da fila.
+ */
+void Metricas::escreverJson(std::ostream& out) const {
+    std::ios::fmtflags formato = out.flags();
+    std::streamsize precisao = out.precision();
+    out << std::fixed << std::setprecision(6);
+
+    out << "{\n  \"fases_s\": {";
+    for (int f = 0; f < NUM_FASES; ++f) {
+        out << (f ? ", " : "") << "\"" << NOMES_FASE[f] << "\": " << tempoFase[f];
+    }
+    out << "},\n";
+
+    const ContadoresAgrupamento& a = agrupamento;
+    out << "  \"agrupamento\": {\n"
+        << "    \"verificacao_alfa_beta\": \"" << implementacaoCompatibilidade() << "\",\n"
+        << "    \"candidatos\": " << a.candidatos << ",\n"
+        << "    \"recusas\": {";
+    for (int m = 0; m < NUM_MOTIVOS_RECUSA; ++m) {
+        out << (m ? ", " : "") << "\"" << NOMES_RECUSA[m] << "\": " << a.recusas[m];
+    }
+    out << "},\n"
+        << "    \"recusas_lambda_sem_raiz\": " << a.recusasLambdaSemRaiz << ",\n"
+        << "    \"reavaliacoes_completas\": " << a.reavaliacoesCompletas << ",\n"
+        << "    \"raizes\": " << a.raizes << ",\n"
+        << "    \"grupos\": " << a.grupos << ",\n"
+        << "    \"tamanhos_grupo\": {";
+    bool primeiro = true;
+    for (int k = 0; k <= MAX_TAM_HISTOGRAMA; ++k) {
+        if (a.tamanhos[k] == 0) continue;
+        out << (primeiro ? "" : ", ") << "\"" << (k == MAX_TAM_HISTOGRAMA ? ">=" : "") << k
+            << "\": " << a.tamanhos[k];
+        primeiro = false;
+    }
+    out << "}\n  },\n";
+
+    out << "  \"fila\": {"
+        << "\"insercoes\": " << fila.insercoes
+        << ", \"remocoes\": " << fila.remocoes
+        << ", \"inicios_diretos\": " << fila.iniciosDiretos
+        << ", \"tamanho_maximo\": " << fila.tamanhoMaximo << "}\n"
+        << "}\n";
+
+    out.flags(formato);
+    out.precision(precisao);
+}
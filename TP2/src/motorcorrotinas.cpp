@@ -0,0 +1,210 @@
+#include "motorcorrotinas.hpp"
+#include "escalonador.hpp"
+#include "cronometro.hpp"
+#include "rastro.hpp"
+#include <new>
+
+// Capacidade inicial da agenda; o heap cresce quando enche
+static const int CAPACIDADE_AGENDA = 1024;
+
+// Quadros criados de uma vez quando a lista livre esvazia
+static const int QUADROS_POR_BLOCO = 256;
+
+// Alinhamento dos quadros (o mesmo do operator new comum)
+static const std::size_t ALINHAMENTO_QUADRO = alignof(std::max_align_t);
+
+static std::size_t arredondar(std::size_t bytes) {
+    return (bytes + ALINHAMENTO_QUADRO - 1) / ALINHAMENTO_QUADRO * ALINHAMENTO_QUADRO;
+}
+
+// Lista livre de quadros de um único tamanho, fixado pelo primeiro pedido.
+// Os quadros livres são encadeados pelo seu primeiro ponteiro; os blocos,
+// por um cabeçalho antes do primeiro quadro.
+struct PoolQuadros {
+    std::size_t tamanho;
+    void* livres;
+    void* blocos;
+
+    PoolQuadros() : tamanho(0), livres(nullptr), blocos(nullptr) {}
+
+    ~PoolQuadros() {
+        while (blocos) {
+            void* proximo = *static_cast<void**>(blocos);
+            ::operator delete(blocos);
+            blocos = proximo;
+        }
+    }
+
+    void novoBloco() {
+        char* bloco = static_cast<char*>(
+            ::operator new(ALINHAMENTO_QUADRO + tamanho * QUADROS_POR_BLOCO));
+        *reinterpret_cast<void**>(bloco) = blocos;
+        blocos = bloco;
+
+        char* quadros = bloco + ALINHAMENTO_QUADRO;
+        for (int k = QUADROS_POR_BLOCO - 1; k >= 0; --k) {
+            void* quadro = quadros + k * tamanho;
+            *static_cast<void**>(quadro) = livres;
+            livres = quadro;
+        }
+    }
+};
+
+static thread_local PoolQuadros pool;
+
+void* alocarQuadro(std::size_t bytes) {
+    std::size_t tamanho = arredondar(bytes);
+    if (pool.tamanho == 0) pool.tamanho = tamanho;
+    if (tamanho != pool.tamanho) return ::operator new(bytes);
+
+    if (!pool.livres) pool.novoBloco();
+    void* quadro = pool.livres;
+    pool.livres = *static_cast<void**>(quadro);
+    return quadro;
+}
+
+void liberarQuadro(void* quadro, std::size_t bytes) noexcept {
+    if (arredondar(bytes) != pool.tamanho) {
+        ::operator delete(quadro);
+        return;
+    }
+    *static_cast<void**>(quadro) = pool.livres;
+    pool.livres = quadro;
+}
+
+AgendaCorrotinas::AgendaCorrotinas(int capacidadeInicial, ContadoresFila& contadores_)
+    : heap(capacidadeInicial),
+      proximaSeq(0),
+      porChegada(false),
+      contadores(contadores_) {}
+
+/*
+ * Uma simulação completa não deixa corrotinas suspensas; se sobrar alguma,
+ * seu quadro é liberado (a corrida dela não é impressa).
+ */
+AgendaCorrotinas::~AgendaCorrotinas() {
+    double tempo;
+    int grupo;
+    while (!heap.vazio()) {
+        std::coroutine_handle<> corrotina = removerMinimo(tempo, grupo);
+        if (corrotina) corrotina.destroy();
+    }
+}
+
+ChaveEvento AgendaCorrotinas::chave(double tempo) {
+    ChaveEvento c = {tempo, porChegada ? proximaSeq++ : 0};
+    return c;
+}
+
+void AgendaCorrotinas::desempatarPorChegada() {
+    porChegada = true;
+}
+
+void AgendaCorrotinas::registrarInsercao() {
+    ++contadores.insercoes;
+    if (heap.getTamanho() > contadores.tamanhoMaximo) contadores.tamanhoMaximo = heap.getTamanho();
+}
+
+void AgendaCorrotinas::agendar(double tempo, std::coroutine_handle<> corrotina) {
+    heap.inserir(chave(tempo), Agendado{corrotina.address(), -1});
+    registrarInsercao();
+}
+
+void AgendaCorrotinas::agendarInicio(double tempo, int grupo) {
+    heap.inserir(chave(tempo), Agendado{nullptr, grupo});
+    registrarInsercao();
+}
+
+bool AgendaCorrotinas::obterMinimo(double& tempo) const {
+    ChaveEvento c;
+    Agendado agendado;
+    if (!heap.obterMinimo(c, agendado)) return false;
+    tempo = c.tempo;
+    return true;
+}
+
+std::coroutine_handle<> AgendaCorrotinas::removerMinimo(double& tempo, int& grupo) {
+    ChaveEvento c = {0.0, 0};
+    Agendado agendado = {nullptr, -1};
+    heap.removerMinimo(c, agendado);
+    tempo = c.tempo;
+    grupo = agendado.grupo;
+    ++contadores.remocoes;
+    return std::coroutine_handle<>::from_address(agendado.corrotina);
+}
+
+/*
+ * Corrida como corrotina: espera a chegada a cada parada e, depois da
+ * última, finaliza a corrida como o motor de eventos.
+ */
+TarefaCorrida Escalonador::executarCorrida(AgendaCorrotinas& agenda, Corrida* c) {
+    double t = c->getTempoInicio();
+    int numParadas = c->getNumeroParadas();
+    RASTRO(rastrearParada(c, 0, t));
+    for (int i = 0; i + 1 < numParadas; ++i) {
+        double dist = c->getTrecho(i)->getDistancia();
+        t += (gama > 0.0) ? (dist / gama) : 0.0;
+        co_await agenda.avancarAte(t);
+        RASTRO(rastrearParada(c, i + 1, t));
+    }
+    finalizarCorrida(c);
+}
+
+/*
+ * O mesmo laço de simularEImprimir: com uma fonte que conhece os grupos de
+ * antemão, os inícios vão todos para a agenda antes, e a corrida de um
+ * início é montada quando ele sai; senão, a agenda desempata por chegada e
+ * a corrida da fonte que começa até o instante da próxima corrotina
+ * suspensa é iniciada antes dela. Fora isso, a corrotina de menor tempo é
+ * retomada.
+ */
+void Escalonador::simularCorrotinas(FonteCorridas* fonte) {
+    RASTRO_TRECHO("simulacao");
+    AgendaCorrotinas agenda(CAPACIDADE_AGENDA, contadoresFila);
+
+    double inicio = metricas ? instanteAtual() : 0.0;
+    double montagemAntes = metricas ? metricas->tempoFase[FASE_MONTAGEM] : 0.0;
+    double impressaoAntes = metricas ? metricas->tempoFase[FASE_IMPRESSAO] : 0.0;
+
+    int primeiro = 0;
+    int qtdInicios = fonte ? fonte->entregarGrupos(primeiro) : -1;
+    for (int g = primeiro; g < primeiro + qtdInicios; ++g) {
+        agenda.agendarInicio(fonte->tempoGrupo(g), g);
+    }
+    if (qtdInicios < 0) agenda.desempatarPorChegada();
+
+    double tempo = 0.0;
+    while (true) {
+        bool temSuspensa = agenda.obterMinimo(tempo);
+
+        Corrida* corrida = nullptr;
+        if (fonte && fonte->temProxima() &&
+            (!temSuspensa || fonte->tempoProxima() <= tempo)) {
+            ++contadoresFila.iniciosDiretos;
+            corrida = criarCorrida(fonte, -1);
+        } else if (temSuspensa) {
+            int grupo;
+            std::coroutine_handle<> corrotina = agenda.removerMinimo(relogio, grupo);
+            if (corrotina) {
+                corrotina.resume();
+                continue;
+            }
+            corrida = criarCorrida(fonte, grupo);
+        } else {
+            break;
+        }
+
+        relogio = corrida->getTabela()->getColunas().tempo(corrida->getDemanda(0));
+        corrida->setTempoInicio(relogio);
+        RASTRO(rastrearCorrida(corrida));
+        executarCorrida(agenda, corrida);
+    }
+
+    if (metricas) {
+        double total = instanteAtual() - inicio;
+        double montagem = metricas->tempoFase[FASE_MONTAGEM] - montagemAntes;
+        double impressao = metricas->tempoFase[FASE_IMPRESSAO] - impressaoAntes;
+        metricas->tempoFase[FASE_SIMULACAO] += total - montagem - impressao;
+        metricas->fila = contadoresFila;
+    }
+}
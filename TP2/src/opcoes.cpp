@@ -0,0 +1,263 @@
+#include "opcoes.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Corridas finalizadas entre pontos de controle, se --intervalo-controle não for dado
+static const int INTERVALO_CONTROLE_PADRAO = 100000;
+
+/*
+ * Converte o valor de uma opção numérica inteira positiva.
+ */
+static bool lerInteiroPositivo(const char* texto, int& valor) {
+    char* fim = nullptr;
+    long v = std::strtol(texto, &fim, 10);
+    if (fim == texto || *fim != '\0' || v <= 0) return false;
+    valor = static_cast<int>(v);
+    return true;
+}
+
+/*
+ * Opções reconhecidas:
+ *   --threads N                agrupa em paralelo com N threads
+ *   --fila heap|calendario     fila de eventos do Escalonador; a calendário
+ *                              solta empates por ordem de chegada, e o heap,
+ *                              na ordem do simulador original
+ *   --motor eventos|corrotinas uma cadeia de eventos ou uma corrotina por
+ *                              corrida (ver motorcorrotinas.hpp)
+ *   --continuo                 modo contínuo: agrupa e simula enquanto lê
+ *                              (a entrada precisa estar ordenada por tempo)
+ *   --saida direta|assincrona  escrita da saída na thread da simulação
+ *                              ou em uma thread escritora
+ *   --analitico                tempos das corridas em forma fechada, sem
+ *                              fila de eventos (paralelo com --threads);
+ *                              empates saem como com --fila calendario
+ *   --varredura ARQ            simula cada conjunto de parâmetros de ARQ
+ *                              (ver lerConfiguracoes) e imprime um resumo
+ *   --varredura-saida PREFIXO  grava também a saída completa de cada conjunto
+ *                              (a de --analitico)
+ *   --metricas DESTINO         escreve contadores e tempos por fase em JSON
+ *                              no arquivo DESTINO ("-" para std::cerr), e
+ *                              em std::cerr a latência do modo contínuo e os
+ *                              resumos de --frota, --fragmentos e --regioes
+ *   --qualidade                escreve em std::cerr média e percentis de
+ *                              espera, desvio, ocupação e duração das corridas
+ *   --binario ARQ              lê parâmetros e demandas do arquivo binário
+ *                              em colunas ARQ (ver ArquivoColunar)
+ *   --converter ARQ            converte a entrada de texto para ARQ, sem simular
+ *   --grafo ARQ                distâncias pela malha viária de ARQ em vez da
+ *                              reta (ver GrafoViario e RedeViaria)
+ *   --ponto-controle ARQ       grava o estado da simulação em ARQ a cada
+ *                              intervalo de corridas (ver PontoControle)
+ *   --intervalo-controle N     corridas finalizadas entre pontos de controle
+ *   --retomar ARQ              continua a simulação do ponto de controle ARQ,
+ *                              sem ler a entrada
+ *   --frota ARQ                as corridas disputam os veículos de ARQ, cada
+ *                              uma com o livre mais próximo (ver Frota);
+ *                              empates saem por ordem de chegada
+ *   --fragmentos ARQ...        lê as demandas dos arquivos binários ARQ...
+ *                              (todos os argumentos seguintes que não começam
+ *                              com "--"), mesclados por tempo, no modo contínuo
+ *   --regioes ARQ              simula à parte as demandas de cada região de
+ *                              ARQ (ver ParticaoRegioes), em paralelo
+ *   --rastro ARQ               grava agrupamento, corridas, paradas e fases
+ *                              e os escreve em ARQ no formato de traços do
+ *                              Chrome (só se compilado com make re RASTRO=1)
+ */
+bool lerOpcoes(int argc, char** argv, Opcoes& opcoes) {
+    opcoes.threads = 1;
+    opcoes.threadsDefinido = false;
+    opcoes.fila = FILA_HEAP;
+    opcoes.corrotinas = false;
+    opcoes.continuo = false;
+    opcoes.saidaAssincrona = false;
+    opcoes.analitico = false;
+    opcoes.varredura = nullptr;
+    opcoes.prefixoVarredura = nullptr;
+    opcoes.metricas = nullptr;
+    opcoes.qualidade = false;
+    opcoes.binario = nullptr;
+    opcoes.converter = nullptr;
+    opcoes.grafo = nullptr;
+    opcoes.pontoControle = nullptr;
+    opcoes.intervaloControle = INTERVALO_CONTROLE_PADRAO;
+    opcoes.retomar = nullptr;
+    opcoes.frota = nullptr;
+    opcoes.fragmentos = nullptr;
+    opcoes.qtdFragmentos = 0;
+    opcoes.regioes = nullptr;
+    opcoes.rastro = nullptr;
+    bool intervaloDefinido = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+
+        if (std::strcmp(arg, "--threads") == 0 && i + 1 < argc) {
+            if (!lerInteiroPositivo(argv[++i], opcoes.threads)) {
+                std::cerr << "valor invalido para --threads: " << argv[i] << "\n";
+                return false;
+            }
+            opcoes.threadsDefinido = true;
+        } else if (std::strcmp(arg, "--fila") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            if (std::strcmp(valor, "heap") == 0) {
+                opcoes.fila = FILA_HEAP;
+            } else if (std::strcmp(valor, "calendario") == 0) {
+                opcoes.fila = FILA_CALENDARIO;
+            } else {
+                std::cerr << "valor invalido para --fila: " << valor << "\n";
+                return false;
+            }
+        } else if (std::strcmp(arg, "--motor") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            if (std::strcmp(valor, "eventos") == 0) {
+                opcoes.corrotinas = false;
+            } else if (std::strcmp(valor, "corrotinas") == 0) {
+                opcoes.corrotinas = true;
+            } else {
+                std::cerr << "valor invalido para --motor: " << valor << "\n";
+                return false;
+            }
+        } else if (std::strcmp(arg, "--saida") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            if (std::strcmp(valor, "direta") == 0) {
+                opcoes.saidaAssincrona = false;
+            } else if (std::strcmp(valor, "assincrona") == 0) {
+                opcoes.saidaAssincrona = true;
+            } else {
+                std::cerr << "valor invalido para --saida: " << valor << "\n";
+                return false;
+            }
+        } else if (std::strcmp(arg, "--analitico") == 0) {
+            opcoes.analitico = true;
+        } else if (std::strcmp(arg, "--varredura") == 0 && i + 1 < argc) {
+            opcoes.varredura = argv[++i];
+        } else if (std::strcmp(arg, "--varredura-saida") == 0 && i + 1 < argc) {
+            opcoes.prefixoVarredura = argv[++i];
+        } else if (std::strcmp(arg, "--metricas") == 0 && i + 1 < argc) {
+            opcoes.metricas = argv[++i];
+        } else if (std::strcmp(arg, "--qualidade") == 0) {
+            opcoes.qualidade = true;
+        } else if (std::strcmp(arg, "--binario") == 0 && i + 1 < argc) {
+            opcoes.binario = argv[++i];
+        } else if (std::strcmp(arg, "--converter") == 0 && i + 1 < argc) {
+            opcoes.converter = argv[++i];
+        } else if (std::strcmp(arg, "--grafo") == 0 && i + 1 < argc) {
+            opcoes.grafo = argv[++i];
+        } else if (std::strcmp(arg, "--ponto-controle") == 0 && i + 1 < argc) {
+            opcoes.pontoControle = argv[++i];
+        } else if (std::strcmp(arg, "--intervalo-controle") == 0 && i + 1 < argc) {
+            if (!lerInteiroPositivo(argv[++i], opcoes.intervaloControle)) {
+                std::cerr << "valor invalido para --intervalo-controle: " << argv[i] << "\n";
+                return false;
+            }
+            intervaloDefinido = true;
+        } else if (std::strcmp(arg, "--retomar") == 0 && i + 1 < argc) {
+            opcoes.retomar = argv[++i];
+        } else if (std::strcmp(arg, "--frota") == 0 && i + 1 < argc) {
+            opcoes.frota = argv[++i];
+        } else if (std::strcmp(arg, "--fragmentos") == 0) {
+            opcoes.fragmentos = argv + i + 1;
+            opcoes.qtdFragmentos = 0;
+            while (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+                ++opcoes.qtdFragmentos;
+                ++i;
+            }
+            if (opcoes.qtdFragmentos == 0) {
+                std::cerr << "--fragmentos exige ao menos um arquivo\n";
+                return false;
+            }
+        } else if (std::strcmp(arg, "--regioes") == 0 && i + 1 < argc) {
+            opcoes.regioes = argv[++i];
+        } else if (std::strcmp(arg, "--rastro") == 0 && i + 1 < argc) {
+            opcoes.rastro = argv[++i];
+        } else if (std::strcmp(arg, "--continuo") == 0) {
+            opcoes.continuo = true;
+        } else {
+            std::cerr << "opcao desconhecida: " << arg << "\n";
+            return false;
+        }
+    }
+
+    if (opcoes.analitico && opcoes.continuo) {
+        std::cerr << "--analitico precisa de todas as demandas; nao combina com --continuo\n";
+        return false;
+    }
+    if (opcoes.varredura && opcoes.continuo) {
+        std::cerr << "--varredura precisa de todas as demandas; nao combina com --continuo\n";
+        return false;
+    }
+    if (opcoes.metricas && opcoes.varredura) {
+        std::cerr << "--metricas nao se aplica a --varredura\n";
+        return false;
+    }
+    if (opcoes.qualidade && opcoes.varredura) {
+        std::cerr << "--qualidade nao se aplica a --varredura\n";
+        return false;
+    }
+    if (opcoes.prefixoVarredura && !opcoes.varredura) {
+        std::cerr << "--varredura-saida exige --varredura\n";
+        return false;
+    }
+    if (opcoes.binario && opcoes.continuo) {
+        std::cerr << "--binario ja tem todas as demandas; nao combina com --continuo\n";
+        return false;
+    }
+    if (opcoes.grafo && (opcoes.continuo || opcoes.varredura)) {
+        std::cerr << "--grafo precisa de todas as demandas com um so conjunto de parametros; "
+                     "nao combina com --continuo nem com --varredura\n";
+        return false;
+    }
+    if (opcoes.converter && (opcoes.binario || opcoes.continuo || opcoes.analitico ||
+                             opcoes.varredura || opcoes.metricas || opcoes.grafo ||
+                             opcoes.pontoControle || opcoes.retomar || opcoes.frota ||
+                             opcoes.corrotinas || opcoes.qualidade || opcoes.regioes)) {
+        std::cerr << "--converter so le a entrada de texto; nao combina com opcoes de simulacao\n";
+        return false;
+    }
+    if ((opcoes.pontoControle || opcoes.retomar) &&
+        (opcoes.continuo || opcoes.analitico || opcoes.varredura || opcoes.saidaAssincrona)) {
+        std::cerr << "--ponto-controle e --retomar sao da simulacao por eventos com saida direta; "
+                     "nao combinam com --continuo, --analitico, --varredura nem --saida assincrona\n";
+        return false;
+    }
+    if (opcoes.retomar && (opcoes.binario || opcoes.grafo)) {
+        std::cerr << "--retomar ja tem as demandas e os trechos no ponto de controle; "
+                     "nao combina com --binario nem com --grafo\n";
+        return false;
+    }
+    if (opcoes.frota && (opcoes.analitico || opcoes.varredura || opcoes.grafo ||
+                         opcoes.pontoControle || opcoes.retomar)) {
+        std::cerr << "--frota faz as corridas interagirem pela fila de eventos; nao combina com "
+                     "--analitico, --varredura, --grafo, --ponto-controle nem --retomar\n";
+        return false;
+    }
+    if (opcoes.corrotinas && (opcoes.fila != FILA_HEAP || opcoes.analitico || opcoes.varredura ||
+                              opcoes.pontoControle || opcoes.retomar || opcoes.frota)) {
+        std::cerr << "--motor corrotinas tem agenda propria e so simula as corridas; nao combina com "
+                     "--fila calendario, --analitico, --varredura, --ponto-controle, --retomar "
+                     "nem --frota\n";
+        return false;
+    }
+    if (opcoes.qtdFragmentos > 0 &&
+        (opcoes.binario || opcoes.converter || opcoes.analitico || opcoes.varredura ||
+         opcoes.grafo || opcoes.pontoControle || opcoes.retomar)) {
+        std::cerr << "--fragmentos mescla as demandas durante o modo continuo; nao combina com "
+                     "--binario, --converter, --analitico, --varredura, --grafo, "
+                     "--ponto-controle nem --retomar\n";
+        return false;
+    }
+    if (opcoes.regioes &&
+        (opcoes.continuo || opcoes.qtdFragmentos > 0 || opcoes.analitico || opcoes.varredura ||
+         opcoes.grafo || opcoes.pontoControle || opcoes.retomar || opcoes.frota)) {
+        std::cerr << "--regioes divide todas as demandas entre simulacoes independentes; nao combina "
+                     "com --continuo, --fragmentos, --analitico, --varredura, --grafo, "
+                     "--ponto-controle, --retomar nem --frota\n";
+        return false;
+    }
+    if (intervaloDefinido && !opcoes.pontoControle) {
+        std::cerr << "--intervalo-controle exige --ponto-controle\n";
+        return false;
+    }
+    return true;
+}
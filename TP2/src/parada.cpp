@@ -6,12 +6,12 @@
 Parada::Parada()
     : ponto{0.0, 0.0},
       tipo(PARADA_EMBARQUE),
-      demanda(nullptr) {}
+      demanda(-1) {}
 
 /*
  Construtor completo.
  */
-Parada::Parada(const Ponto& p, TipoParada tipo_, Demanda* demanda_)
+Parada::Parada(const Ponto& p, TipoParada tipo_, int demanda_)
     : ponto(p),
       tipo(tipo_),
       demanda(demanda_) {}
@@ -33,10 +33,10 @@ TipoParada Parada::getTipo() const {
 }
 
 /*
- * Retorna a demanda associada a esta parada.
+ * Retorna o índice da demanda associada a esta parada (-1 se nenhuma).
  * Cada parada está vinculada exatamente a uma demanda.
  */
-Demanda* Parada::getDemanda() const {
+int Parada::getDemanda() const {
     return demanda;
 }
 
@@ -55,8 +55,8 @@ void Parada::setTipo(TipoParada t) {
 }
 
 /*
- * Atualiza o ponteiro para a demanda associada.
+ * Atualiza o índice da demanda associada.
  */
-void Parada::setDemanda(Demanda* d) {
+void Parada::setDemanda(int d) {
     demanda = d;
 }
@@ -0,0 +1,175 @@
+#include "particaoregioes.hpp"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Mais regiões que isso é quase certamente erro no arquivo (cada uma vira
+// uma simulação própria)
+static const long long MAX_REGIOES = 1 << 20;
+
+ParticaoRegioes::ParticaoRegioes()
+    : qtdRegioes(0),
+      colunasGrade(0),
+      linhasGrade(0),
+      minX(0.0),
+      minY(0.0),
+      maxX(0.0),
+      maxY(0.0),
+      inicioPoligono(nullptr),
+      xs(nullptr),
+      ys(nullptr),
+      envolventes(nullptr) {}
+
+ParticaoRegioes::~ParticaoRegioes() {
+    liberarMemoria();
+}
+
+void ParticaoRegioes::liberarMemoria() {
+    delete[] inicioPoligono;
+    delete[] xs;
+    delete[] ys;
+    delete[] envolventes;
+    inicioPoligono = nullptr;
+    xs = ys = envolventes = nullptr;
+    qtdRegioes = colunasGrade = linhasGrade = 0;
+}
+
+/*
+ * Lê o cabeçalho ("grade" ou "poligonos") e o resto do formato
+ * correspondente (ver particaoregioes.hpp).
+ */
+bool ParticaoRegioes::carregar(const char* caminho) {
+    liberarMemoria();
+
+    std::ifstream arquivo(caminho);
+    if (!arquivo) {
+        std::cerr << "nao foi possivel abrir " << caminho << "\n";
+        return false;
+    }
+
+    char tipo[16] = "";
+    arquivo.width(sizeof(tipo));
+    arquivo >> tipo;
+
+    if (std::strcmp(tipo, "grade") == 0) {
+        long long nx = 0, ny = 0;
+        if (!(arquivo >> nx >> ny >> minX >> minY >> maxX >> maxY) ||
+            nx <= 0 || ny <= 0 || nx > MAX_REGIOES || ny > MAX_REGIOES ||
+            nx * ny > MAX_REGIOES ||
+            !std::isfinite(minX) || !std::isfinite(minY) ||
+            !std::isfinite(maxX) || !std::isfinite(maxY) ||
+            !(maxX > minX) || !(maxY > minY)) {
+            std::cerr << caminho << ": grade invalida (esperado: grade NX NY XMIN YMIN XMAX YMAX)\n";
+            return false;
+        }
+        colunasGrade = static_cast<int>(nx);
+        linhasGrade = static_cast<int>(ny);
+        qtdRegioes = colunasGrade * linhasGrade;
+        return true;
+    }
+
+    if (std::strcmp(tipo, "poligonos") != 0) {
+        std::cerr << caminho << ": cabecalho invalido (esperado: grade ou poligonos)\n";
+        return false;
+    }
+
+    long long k = 0;
+    if (!(arquivo >> k) || k <= 0 || k > MAX_REGIOES) {
+        std::cerr << caminho << ": quantidade de poligonos invalida\n";
+        return false;
+    }
+    qtdRegioes = static_cast<int>(k);
+    inicioPoligono = new int[qtdRegioes + 1];
+    envolventes = new double[4 * qtdRegioes];
+
+    // os vértices crescem por dobra, pois só se sabe o total no fim
+    int capacidade = 16;
+    int total = 0;
+    xs = new double[capacidade];
+    ys = new double[capacidade];
+
+    for (int r = 0; r < qtdRegioes; ++r) {
+        int n = 0;
+        if (!(arquivo >> n) || n < 3) {
+            std::cerr << caminho << ": poligono " << r << " precisa de ao menos 3 vertices\n";
+            liberarMemoria();
+            return false;
+        }
+        inicioPoligono[r] = total;
+        double* env = envolventes + 4 * r;
+
+        for (int v = 0; v < n; ++v) {
+            if (total == capacidade) {
+                capacidade *= 2;
+                double* nx = new double[capacidade];
+                double* ny = new double[capacidade];
+                std::memcpy(nx, xs, total * sizeof(double));
+                std::memcpy(ny, ys, total * sizeof(double));
+                delete[] xs;
+                delete[] ys;
+                xs = nx;
+                ys = ny;
+            }
+            double x, y;
+            if (!(arquivo >> x >> y) || !std::isfinite(x) || !std::isfinite(y)) {
+                std::cerr << caminho << ": vertice invalido no poligono " << r << "\n";
+                liberarMemoria();
+                return false;
+            }
+            xs[total] = x;
+            ys[total] = y;
+            ++total;
+
+            if (v == 0 || x < env[0]) env[0] = x;
+            if (v == 0 || y < env[1]) env[1] = y;
+            if (v == 0 || x > env[2]) env[2] = x;
+            if (v == 0 || y > env[3]) env[3] = y;
+        }
+    }
+    inicioPoligono[qtdRegioes] = total;
+    return true;
+}
+
+int ParticaoRegioes::getQtdRegioes() const {
+    return qtdRegioes;
+}
+
+int ParticaoRegioes::regiaoGrade(const Ponto& p) const {
+    if (!(p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY)) return -1;
+
+    int cx = static_cast<int>((p.x - minX) / (maxX - minX) * colunasGrade);
+    int cy = static_cast<int>((p.y - minY) / (maxY - minY) * linhasGrade);
+    if (cx >= colunasGrade) cx = colunasGrade - 1;
+    if (cy >= linhasGrade) cy = linhasGrade - 1;
+    return cy * colunasGrade + cx;
+}
+
+/*
+ * Teste do raio: conta quantas arestas cruzam a semirreta horizontal que
+ * sai de p para a direita.
+ */
+bool ParticaoRegioes::dentroPoligono(int k, const Ponto& p) const {
+    const double* env = envolventes + 4 * k;
+    if (p.x < env[0] || p.x > env[2] || p.y < env[1] || p.y > env[3]) return false;
+
+    int ini = inicioPoligono[k];
+    int fim = inicioPoligono[k + 1];
+    bool dentro = false;
+    for (int i = ini, j = fim - 1; i < fim; j = i++) {
+        if ((ys[i] > p.y) != (ys[j] > p.y)) {
+            double x = xs[j] + (p.y - ys[j]) * (xs[i] - xs[j]) / (ys[i] - ys[j]);
+            if (p.x < x) dentro = !dentro;
+        }
+    }
+    return dentro;
+}
+
+int ParticaoRegioes::regiao(const Ponto& p) const {
+    if (colunasGrade > 0) return regiaoGrade(p);
+
+    for (int k = 0; k < qtdRegioes; ++k) {
+        if (dentroPoligono(k, p)) return k;
+    }
+    return -1;
+}
@@ -0,0 +1,458 @@
+#include "pontocontrole.hpp"
+#include "agrupador.hpp"
+#include "escalonador.hpp"
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char ASSINATURA[8] = {'T', 'P', '2', 'C', 'T', 'R', 'L', '\0'};
+static const std::uint32_t VERSAO = 1;
+
+struct CabecalhoPontoControle {
+    char assinatura[8];
+    std::uint32_t versao;
+    std::int32_t eta;
+    double gama;
+    double delta;
+    double alfa;
+    double beta;
+    double lambda;
+    std::int64_t numDemandas;
+    std::int64_t qtdPendentes;       // eventos na fila (corridas e inícios)
+    std::int64_t qtdRestantes;       // grupos que a fonte ainda não entregou
+    std::int64_t deslocamentoSaida;  // bytes de saída já escritos
+    double relogio;
+    std::uint32_t temTrechos;        // 1 no modo viário
+    std::uint32_t reservado;
+    std::int64_t insercoes;          // ContadoresFila
+    std::int64_t remocoes;
+    std::int64_t iniciosDiretos;
+    std::int64_t tamanhoMaximo;
+};
+
+static_assert(sizeof(CabecalhoPontoControle) == 136,
+              "cabecalho do ponto de controle mudou de tamanho");
+
+SaidaContada::SaidaContada(std::streambuf* destino_, long long inicial)
+    : destino(destino_),
+      buffer(nullptr),
+      capacidade(CAPACIDADE_PADRAO),
+      entregues(inicial) {
+    buffer = new char[capacidade];
+    setp(buffer, buffer + capacidade);
+}
+
+SaidaContada::~SaidaContada() {
+    esvaziar();
+    delete[] buffer;
+}
+
+/*
+ * Repassa o buffer ao destino. Só o que o destino aceitou é contado.
+ */
+bool SaidaContada::esvaziar() {
+    std::streamsize n = pptr() - pbase();
+    bool ok = true;
+    if (n > 0) {
+        std::streamsize escritos = destino->sputn(pbase(), n);
+        entregues += escritos;
+        ok = (escritos == n);
+    }
+    setp(buffer, buffer + capacidade);
+    return ok;
+}
+
+int SaidaContada::overflow(int c) {
+    if (!esvaziar()) return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+/*
+ * Trechos que cabem vão para o buffer; um maior que o buffer inteiro
+ * vai direto ao destino.
+ */
+std::streamsize SaidaContada::xsputn(const char* s, std::streamsize n) {
+    if (n > epptr() - pptr()) {
+        if (!esvaziar()) return 0;
+        if (n >= capacidade) {
+            std::streamsize escritos = destino->sputn(s, n);
+            entregues += escritos;
+            return escritos;
+        }
+    }
+    std::memcpy(pptr(), s, static_cast<std::size_t>(n));
+    pbump(static_cast<int>(n));
+    return n;
+}
+
+int SaidaContada::sync() {
+    bool ok = esvaziar();
+    return (destino->pubsync() == 0 && ok) ? 0 : -1;
+}
+
+long long SaidaContada::getEscritos() const {
+    return entregues + (pptr() - pbase());
+}
+
+PontoControle::PontoControle(const char* caminho_, const Parametros& params_,
+                             const FonteGrupos& fonte_, SaidaContada& saida_)
+    : caminho(caminho_),
+      params(params_),
+      fonte(fonte_),
+      saida(saida_) {}
+
+/*
+ * Grava uma coluna com as demandas na ordem de `indices`.
+ */
+static void gravarColuna(std::ostream& arquivo, const double* coluna, const int* indices,
+                         int n, double* aux) {
+    for (int k = 0; k < n; ++k) aux[k] = coluna[indices[k]];
+    arquivo.write(reinterpret_cast<const char*>(aux),
+                  static_cast<std::streamsize>(n) * sizeof(double));
+}
+
+/*
+ * Junta as demandas dos eventos pendentes (na ordem da cópia da fila: a
+ * corrida em andamento ou o grupo de um início) e dos grupos restantes (na
+ * ordem de início) e grava tudo no arquivo temporário, que só então
+ * substitui o ponto de controle anterior.
+ */
+bool PontoControle::gravar(const Evento* eventos, int qtd, double relogio,
+                           const ContadoresFila& contadores) {
+    // a saída no disco tem que chegar ao deslocamento gravado
+    std::cout.flush();
+
+    const TabelaDemandas& tabela = fonte.getDemandas();
+    const ColunasDemandas& colunas = tabela.getColunas();
+    int qtdRestantes = fonte.getQtdRestantes();
+    int qtdGrupos = qtd + qtdRestantes;
+
+    int n = 0;
+    for (int k = 0; k < qtd; ++k) {
+        if (eventos[k].tipo == EVENTO_INICIO) {
+            int inicio, fim;
+            fonte.getGrupo(eventos[k].indiceParada, inicio, fim);
+            n += fim - inicio;
+        } else {
+            n += eventos[k].corrida->getQtdDemandas();
+        }
+    }
+    for (int r = 0; r < qtdRestantes; ++r) {
+        int inicio, fim;
+        fonte.getRestante(r, inicio, fim);
+        n += fim - inicio;
+    }
+
+    int* indices = new int[n > 0 ? n : 1];
+    int* limites = new int[qtdGrupos + 1];
+    int total = 0;
+    for (int k = 0; k < qtd; ++k) {
+        limites[k] = total;
+        if (eventos[k].tipo == EVENTO_INICIO) {
+            int inicio, fim;
+            fonte.getGrupo(eventos[k].indiceParada, inicio, fim);
+            for (int d = inicio; d < fim; ++d) indices[total++] = d;
+        } else {
+            const Corrida* c = eventos[k].corrida;
+            for (int i = 0; i < c->getQtdDemandas(); ++i) indices[total++] = c->getDemanda(i);
+        }
+    }
+    for (int r = 0; r < qtdRestantes; ++r) {
+        int inicio, fim;
+        fonte.getRestante(r, inicio, fim);
+        limites[qtd + r] = total;
+        for (int d = inicio; d < fim; ++d) indices[total++] = d;
+    }
+    limites[qtdGrupos] = total;
+
+    CabecalhoPontoControle cab;
+    std::memset(&cab, 0, sizeof(cab));
+    std::memcpy(cab.assinatura, ASSINATURA, sizeof(ASSINATURA));
+    cab.versao = VERSAO;
+    cab.eta = params.eta;
+    cab.gama = params.gama;
+    cab.delta = params.delta;
+    cab.alfa = params.alfa;
+    cab.beta = params.beta;
+    cab.lambda = params.lambda;
+    cab.numDemandas = n;
+    cab.qtdPendentes = qtd;
+    cab.qtdRestantes = qtdRestantes;
+    cab.deslocamentoSaida = saida.getEscritos();
+    cab.relogio = relogio;
+    cab.temTrechos = colunas.trechosEmbarque ? 1 : 0;
+    cab.insercoes = contadores.insercoes;
+    cab.remocoes = contadores.remocoes;
+    cab.iniciosDiretos = contadores.iniciosDiretos;
+    cab.tamanhoMaximo = contadores.tamanhoMaximo;
+
+    std::size_t tamCaminho = std::strlen(caminho);
+    char* temporario = new char[tamCaminho + 5];
+    std::memcpy(temporario, caminho, tamCaminho);
+    std::memcpy(temporario + tamCaminho, ".tmp", 5);
+
+    std::ofstream arquivo(temporario, std::ios::binary | std::ios::trunc);
+    bool ok = static_cast<bool>(arquivo);
+    if (ok) {
+        arquivo.write(reinterpret_cast<const char*>(&cab), sizeof(cab));
+
+        int* ids = new int[n > 0 ? n : 1];
+        for (int k = 0; k < n; ++k) ids[k] = tabela.getId(indices[k]);
+        arquivo.write(reinterpret_cast<const char*>(ids),
+                      static_cast<std::streamsize>(n) * sizeof(int));
+        delete[] ids;
+
+        double* aux = new double[n > 0 ? n : 1];
+        gravarColuna(arquivo, colunas.tempos, indices, n, aux);
+        gravarColuna(arquivo, colunas.origemX, indices, n, aux);
+        gravarColuna(arquivo, colunas.origemY, indices, n, aux);
+        gravarColuna(arquivo, colunas.destinoX, indices, n, aux);
+        gravarColuna(arquivo, colunas.destinoY, indices, n, aux);
+        if (cab.temTrechos) {
+            gravarColuna(arquivo, colunas.trechosEmbarque, indices, n, aux);
+            gravarColuna(arquivo, colunas.trechosDesembarque, indices, n, aux);
+        }
+        delete[] aux;
+
+        arquivo.write(reinterpret_cast<const char*>(limites),
+                      static_cast<std::streamsize>(qtdGrupos + 1) * sizeof(int));
+        for (int k = 0; k < qtd; ++k) {
+            arquivo.write(reinterpret_cast<const char*>(&eventos[k].tempo), sizeof(double));
+        }
+        for (int k = 0; k < qtd; ++k) {
+            std::int32_t parada = (eventos[k].tipo == EVENTO_INICIO) ? -1 : eventos[k].indiceParada;
+            arquivo.write(reinterpret_cast<const char*>(&parada), sizeof(parada));
+        }
+
+        arquivo.close();
+        ok = !arquivo.fail() && std::rename(temporario, caminho) == 0;
+    }
+    if (!ok) {
+        std::cerr << "nao foi possivel gravar o ponto de controle em " << caminho << "\n";
+    }
+
+    delete[] temporario;
+    delete[] indices;
+    delete[] limites;
+    return ok;
+}
+
+RetomadaSimulacao::RetomadaSimulacao()
+    : tabela(nullptr),
+      trechos(nullptr),
+      limites(nullptr),
+      qtdPendentes(0),
+      qtdRestantes(0),
+      temposEventos(nullptr),
+      paradasEventos(nullptr),
+      relogio(0.0),
+      deslocamentoSaida(0) {
+    std::memset(&params, 0, sizeof(params));
+    contadores.zerar();
+}
+
+RetomadaSimulacao::~RetomadaSimulacao() {
+    liberar();
+}
+
+void RetomadaSimulacao::liberar() {
+    delete tabela;
+    delete[] trechos;
+    delete[] limites;
+    delete[] temposEventos;
+    delete[] paradasEventos;
+    tabela = nullptr;
+    trechos = nullptr;
+    limites = nullptr;
+    temposEventos = nullptr;
+    paradasEventos = nullptr;
+    qtdPendentes = qtdRestantes = 0;
+}
+
+/*
+ * Lê o bloco seguinte do arquivo; falha se o arquivo acabar antes.
+ */
+static bool lerBloco(std::istream& arquivo, void* destino, long long bytes) {
+    arquivo.read(static_cast<char*>(destino), static_cast<std::streamsize>(bytes));
+    return static_cast<bool>(arquivo);
+}
+
+/*
+ * Lê o cabeçalho e as colunas, preenche a tabela e confere que os limites
+ * formam grupos não vazios cobrindo todas as demandas e que cada evento
+ * aponta para uma parada da sua corrida ou é o início do seu grupo.
+ */
+bool RetomadaSimulacao::ler(const char* caminho) {
+    liberar();
+
+    std::ifstream arquivo(caminho, std::ios::binary);
+    if (!arquivo) {
+        std::cerr << "nao foi possivel abrir " << caminho << "\n";
+        return false;
+    }
+
+    CabecalhoPontoControle cab;
+    bool valido = lerBloco(arquivo, &cab, sizeof(cab)) &&
+                  std::memcmp(cab.assinatura, ASSINATURA, sizeof(ASSINATURA)) == 0 &&
+                  cab.versao == VERSAO &&
+                  cab.numDemandas >= 0 && cab.numDemandas <= INT_MAX &&
+                  cab.qtdPendentes >= 0 && cab.qtdRestantes >= 0 &&
+                  cab.qtdPendentes + cab.qtdRestantes <= cab.numDemandas &&
+                  cab.deslocamentoSaida >= 0;
+    if (!valido) {
+        std::cerr << caminho << " nao e um ponto de controle (versao " << VERSAO << ")\n";
+        return false;
+    }
+
+    int n = static_cast<int>(cab.numDemandas);
+    qtdPendentes = static_cast<int>(cab.qtdPendentes);
+    qtdRestantes = static_cast<int>(cab.qtdRestantes);
+    int qtdGrupos = qtdPendentes + qtdRestantes;
+    long long tamanho = n > 0 ? n : 1;
+
+    int* ids = new int[tamanho];
+    double* valores = new double[5 * tamanho];
+    limites = new int[qtdGrupos + 1];
+    temposEventos = new double[qtdPendentes > 0 ? qtdPendentes : 1];
+    paradasEventos = new int[qtdPendentes > 0 ? qtdPendentes : 1];
+    if (cab.temTrechos) trechos = new double[2 * tamanho];
+
+    valido = lerBloco(arquivo, ids, n * static_cast<long long>(sizeof(int)));
+    for (int c = 0; c < 5 && valido; ++c) {
+        valido = lerBloco(arquivo, valores + c * tamanho, n * static_cast<long long>(sizeof(double)));
+    }
+    if (valido && trechos) {
+        valido = lerBloco(arquivo, trechos, n * static_cast<long long>(sizeof(double))) &&
+                 lerBloco(arquivo, trechos + n, n * static_cast<long long>(sizeof(double)));
+    }
+    valido = valido &&
+             lerBloco(arquivo, limites, (qtdGrupos + 1) * static_cast<long long>(sizeof(int))) &&
+             lerBloco(arquivo, temposEventos, qtdPendentes * static_cast<long long>(sizeof(double))) &&
+             lerBloco(arquivo, paradasEventos, qtdPendentes * static_cast<long long>(sizeof(int)));
+
+    valido = valido && limites[0] == 0 && limites[qtdGrupos] == n;
+    for (int g = 0; g < qtdGrupos && valido; ++g) {
+        valido = limites[g + 1] > limites[g];
+    }
+    // a corrida de um grupo de q demandas tem 2q paradas; -1 é o início
+    for (int k = 0; k < qtdPendentes && valido; ++k) {
+        valido = paradasEventos[k] >= -1 &&
+                 paradasEventos[k] < 2 * (limites[k + 1] - limites[k]) &&
+                 !std::isnan(temposEventos[k]);
+    }
+    if (!valido) {
+        std::cerr << caminho << ": ponto de controle incompleto ou corrompido\n";
+        delete[] ids;
+        delete[] valores;
+        liberar();
+        return false;
+    }
+
+    tabela = new TabelaDemandas(n);
+    for (int i = 0; i < n; ++i) {
+        Ponto origem = {valores[tamanho + i], valores[2 * tamanho + i]};
+        Ponto destino = {valores[3 * tamanho + i], valores[4 * tamanho + i]};
+        tabela->definir(i, ids[i], valores[i], origem, destino);
+    }
+    if (trechos) tabela->definirTrechos(trechos, trechos + n);
+    delete[] ids;
+    delete[] valores;
+
+    params.eta = cab.eta;
+    params.gama = cab.gama;
+    params.delta = cab.delta;
+    params.alfa = cab.alfa;
+    params.beta = cab.beta;
+    params.lambda = cab.lambda;
+    relogio = cab.relogio;
+    deslocamentoSaida = cab.deslocamentoSaida;
+    contadores.insercoes = cab.insercoes;
+    contadores.remocoes = cab.remocoes;
+    contadores.iniciosDiretos = cab.iniciosDiretos;
+    contadores.tamanhoMaximo = cab.tamanhoMaximo;
+    return true;
+}
+
+const Parametros& RetomadaSimulacao::getParametros() const {
+    return params;
+}
+
+TabelaDemandas& RetomadaSimulacao::getTabela() {
+    return *tabela;
+}
+
+const int* RetomadaSimulacao::getLimites() const {
+    return limites;
+}
+
+int RetomadaSimulacao::getQtdGrupos() const {
+    return qtdPendentes + qtdRestantes;
+}
+
+int RetomadaSimulacao::getQtdPendentes() const {
+    return qtdPendentes;
+}
+
+long long RetomadaSimulacao::getDeslocamentoSaida() const {
+    return deslocamentoSaida;
+}
+
+/*
+ * Cada corrida em andamento é montada de novo a partir das suas demandas,
+ * com o início de quando foi criada; o início de um grupo volta como início
+ * do grupo k da fonte. Os eventos voltam à fila na ordem em que foram
+ * copiados dela.
+ */
+void RetomadaSimulacao::restaurar(Escalonador& escalonador) {
+    Evento* eventos = new Evento[qtdPendentes > 0 ? qtdPendentes : 1];
+    for (int k = 0; k < qtdPendentes; ++k) {
+        if (paradasEventos[k] < 0) {
+            eventos[k].tempo = temposEventos[k];
+            eventos[k].tipo = EVENTO_INICIO;
+            eventos[k].corrida = nullptr;
+            eventos[k].indiceParada = k;
+            continue;
+        }
+        Corrida* corrida = montarCorrida(*tabela, limites[k], limites[k + 1]);
+        corrida->setTempoInicio(tabela->getColunas().tempo(limites[k]));
+
+        eventos[k].tempo = temposEventos[k];
+        eventos[k].tipo = EVENTO_PARADA;
+        eventos[k].corrida = corrida;
+        eventos[k].indiceParada = paradasEventos[k];
+    }
+    escalonador.restaurar(eventos, qtdPendentes, relogio, contadores);
+    delete[] eventos;
+}
+
+/*
+ * Com >>, as escritas vão para o fim do arquivo, que passa a ser o
+ * deslocamento; com 1<>, a posição é levada até ele.
+ */
+bool posicionarSaida(long long deslocamento) {
+    struct stat info;
+    if (fstat(STDOUT_FILENO, &info) != 0 || !S_ISREG(info.st_mode)) return true;
+
+    if (info.st_size < deslocamento) {
+        std::cerr << "a saida tem " << info.st_size << " bytes, mas o ponto de controle "
+                  << "parou em " << deslocamento << " (use >> para continuar o arquivo)\n";
+        return false;
+    }
+    if (ftruncate(STDOUT_FILENO, static_cast<off_t>(deslocamento)) != 0 ||
+        lseek(STDOUT_FILENO, static_cast<off_t>(deslocamento), SEEK_SET) < 0) {
+        std::cerr << "nao foi possivel posicionar a saida em " << deslocamento << "\n";
+        return false;
+    }
+    return true;
+}
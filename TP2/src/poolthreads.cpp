@@ -0,0 +1,103 @@
+#include "poolthreads.hpp"
+
+/*
+ * Construtor: cria numThreads - 1 threads auxiliares.
+ * A thread que chama executar() também trabalha, então numThreads = 1
+ * não cria nenhuma thread e executa tudo sequencialmente.
+ */
+PoolThreads::PoolThreads(int numThreads_)
+    : threads(nullptr),
+      numThreads(numThreads_ > 0 ? numThreads_ : 1),
+      funcao(nullptr),
+      contexto(nullptr),
+      numTarefas(0),
+      proxima(0),
+      geracao(0),
+      ativos(0),
+      encerrar(false) {
+    if (numThreads > 1) {
+        threads = new std::thread[numThreads - 1];
+        for (int i = 0; i < numThreads - 1; ++i) {
+            threads[i] = std::thread(&PoolThreads::laco, this);
+        }
+    }
+}
+
+/*
+ * Destrutor: sinaliza o encerramento e aguarda as threads auxiliares.
+ */
+PoolThreads::~PoolThreads() {
+    {
+        std::lock_guard<std::mutex> trava(mtx);
+        encerrar = true;
+    }
+    cvTrabalho.notify_all();
+
+    for (int i = 0; i < numThreads - 1; ++i) {
+        threads[i].join();
+    }
+    delete[] threads;
+}
+
+int PoolThreads::getNumThreads() const {
+    return numThreads;
+}
+
+/*
+ * Retira índices do lote atual até que acabem.
+ */
+void PoolThreads::executarTarefas() {
+    while (true) {
+        int i = proxima.fetch_add(1);
+        if (i >= numTarefas) break;
+        funcao(i, contexto);
+    }
+}
+
+/*
+ * Laço das threads auxiliares: espera um novo lote, trabalha nele
+ * e avisa quando termina.
+ */
+void PoolThreads::laco() {
+    long vista = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> trava(mtx);
+            cvTrabalho.wait(trava, [&] { return encerrar || geracao != vista; });
+            if (encerrar) return;
+            vista = geracao;
+        }
+
+        executarTarefas();
+
+        {
+            std::lock_guard<std::mutex> trava(mtx);
+            --ativos;
+        }
+        cvFim.notify_one();
+    }
+}
+
+/*
+ * Executa funcao(i, contexto) para cada i em [0, numTarefas_).
+ * Bloqueia até todas as tarefas do lote terminarem.
+ */
+void PoolThreads::executar(int numTarefas_, FuncaoTarefa funcao_, void* contexto_) {
+    if (numTarefas_ <= 0) return;
+
+    {
+        std::lock_guard<std::mutex> trava(mtx);
+        funcao = funcao_;
+        contexto = contexto_;
+        numTarefas = numTarefas_;
+        proxima.store(0);
+        ativos = numThreads - 1;
+        ++geracao;
+    }
+    cvTrabalho.notify_all();
+
+    executarTarefas();
+
+    std::unique_lock<std::mutex> trava(mtx);
+    cvFim.wait(trava, [&] { return ativos == 0; });
+}
@@ -0,0 +1,124 @@
+#include "qualidadeservico.hpp"
+#include "agrupador.hpp"
+#include <ostream>
+
+// Capacidade inicial das distâncias acumuladas (paradas); dobra quando falta
+static const int CAPACIDADE_INICIAL_PARADAS = 16;
+
+// Uma corrida montada: trechos e demandas vêm do objeto
+struct RotaCorrida {
+    const Corrida& corrida;
+    const ColunasDemandas& colunas;
+
+    int qtdDemandas() const { return corrida.getQtdDemandas(); }
+    double trecho(int k) const { return corrida.getTrecho(k)->getDistancia(); }
+    double solicitacao(int i) const { return colunas.tempo(corrida.getDemanda(i)); }
+    Ponto origem(int i) const { return colunas.origem(corrida.getDemanda(i)); }
+    Ponto destino(int i) const { return colunas.destino(corrida.getDemanda(i)); }
+};
+
+// Um grupo da simulação analítica: trechos recalculados das colunas, como
+// em percorrerRota (pela malha, os gravados pelo agrupamento)
+struct RotaColunas {
+    const ColunasDemandas& colunas;
+    int inicio;
+    int qtd;
+
+    int qtdDemandas() const { return qtd; }
+    Ponto parada(int k) const {
+        return (k < qtd) ? colunas.origem(inicio + k) : colunas.destino(inicio + k - qtd);
+    }
+    double trecho(int k) const {
+        if (colunas.trechosEmbarque) {
+            int chegada = k + 1;
+            return (chegada < qtd) ? colunas.trechosEmbarque[inicio + chegada]
+                                   : colunas.trechosDesembarque[inicio + chegada - qtd];
+        }
+        return distPontos(parada(k), parada(k + 1));
+    }
+    double solicitacao(int i) const { return colunas.tempo(inicio + i); }
+    Ponto origem(int i) const { return colunas.origem(inicio + i); }
+    Ponto destino(int i) const { return colunas.destino(inicio + i); }
+};
+
+QualidadeServico::QualidadeServico(double gama_)
+    : gama(gama_),
+      acumuladas(nullptr),
+      capacidade(0) {}
+
+QualidadeServico::~QualidadeServico() {
+    delete[] acumuladas;
+}
+
+/*
+ * Acumula as distâncias das paradas e tira delas as quatro medidas.
+ */
+template <typename Rota>
+void QualidadeServico::registrarRota(const Rota& rota, double tempoInicio, double tempoFim) {
+    int q = rota.qtdDemandas();
+    int numParadas = 2 * q;
+    if (numParadas > capacidade) {
+        int novaCap = capacidade ? capacidade : CAPACIDADE_INICIAL_PARADAS;
+        while (novaCap < numParadas) novaCap *= 2;
+        delete[] acumuladas;
+        acumuladas = new double[novaCap];
+        capacidade = novaCap;
+    }
+
+    acumuladas[0] = 0.0;
+    for (int k = 1; k < numParadas; ++k) {
+        acumuladas[k] = acumuladas[k - 1] + rota.trecho(k - 1);
+    }
+    double total = acumuladas[numParadas - 1];
+
+    double aBordo = 0.0;
+    for (int i = 0; i < q; ++i) {
+        double restante = total - acumuladas[i];
+        double embarque = tempoFim - ((gama > 0.0) ? (restante / gama) : 0.0);
+        espera.registrar(embarque - rota.solicitacao(i));
+
+        double percorrida = acumuladas[q + i] - acumuladas[i];
+        aBordo += percorrida;
+        double reta = distPontos(rota.origem(i), rota.destino(i));
+        if (reta > 0.0) desvio.registrar(percorrida / reta);
+    }
+
+    if (total > 0.0) ocupacao.registrar(aBordo / total);
+    duracao.registrar(tempoFim - tempoInicio);
+}
+
+void QualidadeServico::registrarCorrida(const Corrida& c) {
+    RotaCorrida rota = {c, c.getTabela()->getColunas()};
+    registrarRota(rota, c.getTempoInicio(), c.getTempoFim());
+}
+
+void QualidadeServico::registrarGrupo(const ColunasDemandas& demandas, int inicio, int fim,
+                                      double tempoFim) {
+    RotaColunas rota = {demandas, inicio, fim - inicio};
+    registrarRota(rota, demandas.tempo(inicio), tempoFim);
+}
+
+void QualidadeServico::somar(const QualidadeServico& outra) {
+    espera.somar(outra.espera);
+    desvio.somar(outra.desvio);
+    ocupacao.somar(outra.ocupacao);
+    duracao.somar(outra.duracao);
+}
+
+static void imprimirMedida(std::ostream& out, const char* nome, const HistogramaLog& h) {
+    out << "qualidade " << nome << ": n " << h.getTotal()
+        << " media " << h.getMedia()
+        << " min " << h.getMinimo()
+        << " p50 " << h.percentil(0.50)
+        << " p90 " << h.percentil(0.90)
+        << " p99 " << h.percentil(0.99)
+        << " p999 " << h.percentil(0.999)
+        << " max " << h.getMaximo() << "\n";
+}
+
+void QualidadeServico::imprimirResumo(std::ostream& out) const {
+    imprimirMedida(out, "espera", espera);
+    imprimirMedida(out, "desvio", desvio);
+    imprimirMedida(out, "ocupacao", ocupacao);
+    imprimirMedida(out, "duracao", duracao);
+}
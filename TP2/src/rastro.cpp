@@ -0,0 +1,276 @@
+#include "rastro.hpp"
+#include <iostream>
+
+#ifdef TP2_RASTRO
+
+#include "corrida.hpp"
+#include "cronometro.hpp"
+#include "tabelademandas.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+
+// Registros por anel (potências de 2). Cada thread tem um anel para os
+// trechos, que são poucos, e outro para os demais, para que as paradas não
+// sobrescrevam as fases.
+static const long long CAPACIDADE_ANEL = 1 << 18;
+static const long long CAPACIDADE_TRECHOS = 1 << 12;
+
+// Capacidade inicial da lista de anéis; dobra quando falta
+static const int CAPACIDADE_INICIAL_ANEIS = 16;
+
+// Identificadores dos dois processos do traço
+static const int PROCESSO_PAREDE = 1;
+static const int PROCESSO_SIMULADO = 2;
+
+enum TipoRegistro {
+    REGISTRO_TRECHO = 0,
+    REGISTRO_GRUPO,
+    REGISTRO_CORRIDA,
+    REGISTRO_PARADA,
+    REGISTRO_FIM
+};
+
+// Um registro do anel (40 bytes); o significado dos campos depende do tipo
+struct RegistroRastro {
+    double instante;      // segundos: de parede (trecho) ou simulados
+    double duracao;       // segundos de parede (trecho); 0 nos demais
+    const char* nome;     // trecho (literal); nullptr nos demais
+    int corrida;          // id da corrida (id da sua primeira demanda) ou da semente do grupo
+    int a;                // parada, ou tamanho do grupo
+    int b;                // demandas da corrida, ou id da candidata recusada
+    unsigned char tipo;   // TipoRegistro
+    unsigned char motivo; // MotivoRecusa (grupo)
+};
+
+struct AnelRastro {
+    RegistroRastro* registros;
+    long long escritos;   // total gravado; o registro k fica em k % CAPACIDADE_ANEL
+    RegistroRastro* trechos;
+    long long trechosEscritos;
+    int thread;           // ordem de registro dos anéis
+};
+
+bool rastroAtivo = false;
+
+static const char* caminhoRastro = nullptr;
+static double inicioRastro = 0.0;
+
+static std::mutex mtxAneis;   // só para registrar um anel novo
+static AnelRastro** aneis = nullptr;
+static int qtdAneis = 0;
+static int capAneis = 0;
+
+static thread_local AnelRastro* anelLocal = nullptr;
+
+/*
+ * Anéis da thread atual, criados e registrados no primeiro uso.
+ */
+static AnelRastro* anelAtual() {
+    if (anelLocal) return anelLocal;
+
+    AnelRastro* anel = new AnelRastro;
+    anel->registros = new RegistroRastro[CAPACIDADE_ANEL];
+    anel->escritos = 0;
+    anel->trechos = new RegistroRastro[CAPACIDADE_TRECHOS];
+    anel->trechosEscritos = 0;
+
+    std::lock_guard<std::mutex> trava(mtxAneis);
+    if (qtdAneis == capAneis) {
+        int novaCap = capAneis ? 2 * capAneis : CAPACIDADE_INICIAL_ANEIS;
+        AnelRastro** novos = new AnelRastro*[novaCap];
+        for (int k = 0; k < qtdAneis; ++k) {
+            novos[k] = aneis[k];
+        }
+        delete[] aneis;
+        aneis = novos;
+        capAneis = novaCap;
+    }
+    anel->thread = qtdAneis;
+    aneis[qtdAneis++] = anel;
+    anelLocal = anel;
+    return anel;
+}
+
+static RegistroRastro& novoRegistro(TipoRegistro tipo) {
+    AnelRastro* anel = anelAtual();
+    RegistroRastro& r = (tipo == REGISTRO_TRECHO)
+        ? anel->trechos[anel->trechosEscritos++ & (CAPACIDADE_TRECHOS - 1)]
+        : anel->registros[anel->escritos++ & (CAPACIDADE_ANEL - 1)];
+    r.duracao = 0.0;
+    r.nome = nullptr;
+    r.corrida = r.a = r.b = 0;
+    r.tipo = static_cast<unsigned char>(tipo);
+    r.motivo = 0;
+    return r;
+}
+
+static int idCorrida(const Corrida* c) {
+    return c->getTabela()->getId(c->getDemanda(0));
+}
+
+void rastrearTrecho(const char* nome, double inicio, double fim) {
+    RegistroRastro& r = novoRegistro(REGISTRO_TRECHO);
+    r.instante = inicio - inicioRastro;
+    r.duracao = fim - inicio;
+    r.nome = nome;
+}
+
+void rastrearGrupo(double tempo, int semente, int tamanho, int recusada, MotivoRecusa motivo) {
+    RegistroRastro& r = novoRegistro(REGISTRO_GRUPO);
+    r.instante = tempo;
+    r.corrida = semente;
+    r.a = tamanho;
+    r.b = recusada;
+    r.motivo = static_cast<unsigned char>(motivo);
+}
+
+void rastrearCorrida(const Corrida* c) {
+    RegistroRastro& r = novoRegistro(REGISTRO_CORRIDA);
+    r.instante = c->getTempoInicio();
+    r.corrida = idCorrida(c);
+    r.a = c->getNumeroParadas();
+    r.b = c->getQtdDemandas();
+}
+
+void rastrearParada(const Corrida* c, int parada, double tempo) {
+    RegistroRastro& r = novoRegistro(REGISTRO_PARADA);
+    r.instante = tempo;
+    r.corrida = idCorrida(c);
+    r.a = parada;
+    r.b = c->getQtdDemandas();
+}
+
+void rastrearFim(const Corrida* c) {
+    RegistroRastro& r = novoRegistro(REGISTRO_FIM);
+    r.instante = c->getTempoFim();
+    r.corrida = idCorrida(c);
+}
+
+TrechoRastro::TrechoRastro(const char* nome_)
+    : nome(nome_),
+      inicio(rastroAtivo ? instanteAtual() : 0.0) {}
+
+TrechoRastro::~TrechoRastro() {
+    if (rastroAtivo) rastrearTrecho(nome, inicio, instanteAtual());
+}
+
+/*
+ * Um evento do traço: trechos são eventos completos ("X") no tempo de
+ * parede; grupos são marcas ("i"), e corridas e paradas são eventos
+ * assíncronos ("b", "n", "e") com o id da corrida, no tempo simulado.
+ */
+static void escreverRegistro(std::ostream& out, const RegistroRastro& r, int thread) {
+    double us = r.instante * 1e6;
+    switch (r.tipo) {
+    case REGISTRO_TRECHO:
+        out << "{\"name\":\"" << r.nome << "\",\"ph\":\"X\",\"pid\":" << PROCESSO_PAREDE
+            << ",\"tid\":" << thread << ",\"ts\":" << us << ",\"dur\":" << r.duracao * 1e6 << "}";
+        break;
+    case REGISTRO_GRUPO:
+        out << "{\"name\":\"grupo\",\"ph\":\"i\",\"s\":\"t\",\"pid\":" << PROCESSO_SIMULADO
+            << ",\"tid\":" << thread << ",\"ts\":" << us
+            << ",\"args\":{\"semente\":" << r.corrida << ",\"tamanho\":" << r.a
+            << ",\"recusada\":" << r.b << ",\"motivo\":\""
+            << nomeMotivoRecusa(static_cast<MotivoRecusa>(r.motivo)) << "\"}}";
+        break;
+    case REGISTRO_CORRIDA:
+        out << "{\"name\":\"corrida\",\"cat\":\"corrida\",\"ph\":\"b\",\"id\":" << r.corrida
+            << ",\"pid\":" << PROCESSO_SIMULADO << ",\"tid\":" << thread << ",\"ts\":" << us
+            << ",\"args\":{\"paradas\":" << r.a << ",\"demandas\":" << r.b << "}}";
+        break;
+    case REGISTRO_PARADA:
+        out << "{\"name\":\"" << (r.a < r.b ? "embarque" : "desembarque")
+            << "\",\"cat\":\"corrida\",\"ph\":\"n\",\"id\":" << r.corrida
+            << ",\"pid\":" << PROCESSO_SIMULADO << ",\"tid\":" << thread << ",\"ts\":" << us
+            << ",\"args\":{\"parada\":" << r.a << "}}";
+        break;
+    default:
+        out << "{\"name\":\"corrida\",\"cat\":\"corrida\",\"ph\":\"e\",\"id\":" << r.corrida
+            << ",\"pid\":" << PROCESSO_SIMULADO << ",\"tid\":" << thread << ",\"ts\":" << us << "}";
+        break;
+    }
+}
+
+/*
+ * Escreve o que sobrou de um anel, do registro mais antigo ao mais novo;
+ * retorna quantos foram escritos e soma os sobrescritos.
+ */
+static long long escreverAnel(std::ostream& out, const RegistroRastro* anel, long long escritos,
+                              long long capacidade, int thread, long long& sobrescritos) {
+    long long primeiro = escritos - capacidade;
+    if (primeiro < 0) primeiro = 0;
+    for (long long i = primeiro; i < escritos; ++i) {
+        out << ",\n";
+        escreverRegistro(out, anel[i & (capacidade - 1)], thread);
+    }
+    sobrescritos += primeiro;
+    return escritos - primeiro;
+}
+
+/*
+ * Chamada por atexit: escreve os anéis de todas as threads e um resumo em
+ * std::cerr. Todas as threads que
+ * gravaram já terminaram.
+ */
+static void exportarRastro() {
+    rastroAtivo = false;
+
+    std::ofstream arquivo(caminhoRastro);
+    if (!arquivo) {
+        std::cerr << "nao foi possivel escrever o rastro em " << caminhoRastro << "\n";
+        return;
+    }
+    arquivo << std::fixed << std::setprecision(3);
+    arquivo << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    arquivo << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << PROCESSO_PAREDE
+            << ",\"args\":{\"name\":\"tempo de parede\"}},\n";
+    arquivo << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << PROCESSO_SIMULADO
+            << ",\"args\":{\"name\":\"tempo simulado\"}}";
+
+    int threads = qtdAneis;
+    long long registros = 0;
+    long long sobrescritos = 0;
+    for (int k = 0; k < qtdAneis; ++k) {
+        AnelRastro* anel = aneis[k];
+        for (int p = PROCESSO_PAREDE; p <= PROCESSO_SIMULADO; ++p) {
+            arquivo << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << p
+                    << ",\"tid\":" << anel->thread
+                    << ",\"args\":{\"name\":\"thread " << anel->thread << "\"}}";
+        }
+
+        registros += escreverAnel(arquivo, anel->trechos, anel->trechosEscritos,
+                                  CAPACIDADE_TRECHOS, anel->thread, sobrescritos);
+        registros += escreverAnel(arquivo, anel->registros, anel->escritos,
+                                  CAPACIDADE_ANEL, anel->thread, sobrescritos);
+
+        delete[] anel->trechos;
+        delete[] anel->registros;
+        delete anel;
+    }
+    delete[] aneis;
+    aneis = nullptr;
+    qtdAneis = capAneis = 0;
+
+    arquivo << "\n]}\n";
+    std::cerr << "rastro: threads " << threads << " registros " << registros
+              << " sobrescritos " << sobrescritos << "\n";
+}
+
+bool iniciarRastro(const char* caminho) {
+    caminhoRastro = caminho;
+    inicioRastro = instanteAtual();
+    rastroAtivo = true;
+    std::atexit(exportarRastro);
+    return true;
+}
+
+#else
+
+bool iniciarRastro(const char*) {
+    std::cerr << "--rastro exige o simulador compilado com o rastro (make re RASTRO=1)\n";
+    return false;
+}
+
+#endif // TP2_RASTRO
@@ -0,0 +1,319 @@
+#include "redeviaria.hpp"
+#include "cronometro.hpp"
+#include <cmath>
+#include <ostream>
+
+// Capacidade inicial de cada cache (potência de 2)
+static const int CAPACIDADE_INICIAL_CACHE = 1024;
+
+// Folga relativa do descarte pela reta, para que arredondamentos na soma dos
+// arcos nunca façam a reta passar de um caminho que está no limite
+static const double FOLGA_RETA = 1e-9;
+
+void EstatisticasViarias::zerar() {
+    consultas = 0;
+    acertos = 0;
+    descartesPorReta = 0;
+    buscas = 0;
+    nosFixados = 0;
+    tempoBuscas = 0.0;
+    maiorBusca = 0.0;
+}
+
+void EstatisticasViarias::somar(const EstatisticasViarias& outras) {
+    consultas += outras.consultas;
+    acertos += outras.acertos;
+    descartesPorReta += outras.descartesPorReta;
+    buscas += outras.buscas;
+    nosFixados += outras.nosFixados;
+    tempoBuscas += outras.tempoBuscas;
+    if (outras.maiorBusca > maiorBusca) maiorBusca = outras.maiorBusca;
+}
+
+void EstatisticasViarias::imprimirResumo(std::ostream& out) const {
+    double taxa = (consultas > 0) ? static_cast<double>(acertos) / consultas : 0.0;
+    double media = (buscas > 0) ? tempoBuscas / buscas : 0.0;
+    double nosMedio = (buscas > 0) ? static_cast<double>(nosFixados) / buscas : 0.0;
+    out << "viario: consultas " << consultas
+        << " acertos " << acertos
+        << " taxa_acerto " << taxa
+        << " descartes_reta " << descartesPorReta
+        << " buscas " << buscas
+        << " nos_por_busca " << nosMedio
+        << " busca_media_us " << media * 1e6
+        << " busca_max_us " << maiorBusca * 1e6 << "\n";
+}
+
+/*
+ * Espalha os bits do par de nós antes de tomar a posição no vetor.
+ */
+static unsigned long long misturar(unsigned long long chave) {
+    chave ^= chave >> 33;
+    chave *= 0xff51afd7ed558ccdULL;
+    chave ^= chave >> 33;
+    return chave;
+}
+
+CacheDistancias::CacheDistancias()
+    : chaves(nullptr),
+      valores(nullptr),
+      geracoes(nullptr),
+      capacidade(CAPACIDADE_INICIAL_CACHE),
+      quantidade(0),
+      geracao(1) {
+    chaves = new unsigned long long[capacidade];
+    valores = new double[capacidade];
+    geracoes = new unsigned[capacidade]();
+}
+
+CacheDistancias::~CacheDistancias() {
+    delete[] chaves;
+    delete[] valores;
+    delete[] geracoes;
+}
+
+bool CacheDistancias::buscar(unsigned long long chave, double& valor) const {
+    int mascara = capacidade - 1;
+    for (int p = static_cast<int>(misturar(chave)) & mascara; geracoes[p] == geracao;
+         p = (p + 1) & mascara) {
+        if (chaves[p] == chave) {
+            valor = valores[p];
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Insere uma chave que não está no cache. Acima de metade da capacidade,
+ * o vetor dobra antes.
+ */
+void CacheDistancias::inserir(unsigned long long chave, double valor) {
+    if (2 * (quantidade + 1) > capacidade) crescer();
+
+    int mascara = capacidade - 1;
+    int p = static_cast<int>(misturar(chave)) & mascara;
+    while (geracoes[p] == geracao) p = (p + 1) & mascara;
+    chaves[p] = chave;
+    valores[p] = valor;
+    geracoes[p] = geracao;
+    ++quantidade;
+}
+
+void CacheDistancias::crescer() {
+    int antigaCap = capacidade;
+    unsigned long long* antigasChaves = chaves;
+    double* antigosValores = valores;
+    unsigned* antigasGeracoes = geracoes;
+
+    capacidade *= 2;
+    chaves = new unsigned long long[capacidade];
+    valores = new double[capacidade];
+    geracoes = new unsigned[capacidade]();
+    unsigned geracaoAntiga = geracao;
+    geracao = 1;
+    quantidade = 0;
+
+    for (int p = 0; p < antigaCap; ++p) {
+        if (antigasGeracoes[p] == geracaoAntiga) inserir(antigasChaves[p], antigosValores[p]);
+    }
+
+    delete[] antigasChaves;
+    delete[] antigosValores;
+    delete[] antigasGeracoes;
+}
+
+void CacheDistancias::limpar() {
+    quantidade = 0;
+    if (++geracao == 0) {
+        // a geração deu a volta: as marcas antigas poderiam voltar a valer
+        for (int p = 0; p < capacidade; ++p) geracoes[p] = 0;
+        geracao = 1;
+    }
+}
+
+ConsultaViaria::ConsultaViaria(const RedeViaria& rede_)
+    : rede(rede_),
+      busca(rede_.getGrafo()),
+      atual(0),
+      janelaAtual(NAN) {
+    estatisticas.zerar();
+}
+
+/*
+ * Com a janela seguinte, o cache da atual passa a ser o da anterior e o
+ * mais antigo é reaproveitado vazio; um salto maior (ou um recuo, com a
+ * entrada fora de ordem) descarta os dois.
+ */
+void ConsultaViaria::avancarJanela(double tempo) {
+    double janela = rede.getJanela();
+    double indice = (janela > 0.0 && std::isfinite(janela)) ? std::floor(tempo / janela) : 0.0;
+    if (indice == janelaAtual) return;
+
+    if (indice == janelaAtual + 1.0) {
+        atual = 1 - atual;
+        caches[atual].limpar();
+    } else {
+        caches[0].limpar();
+        caches[1].limpar();
+    }
+    janelaAtual = indice;
+}
+
+static unsigned long long chavePar(int u, int v) {
+    return (static_cast<unsigned long long>(u) << 32) | static_cast<unsigned>(v);
+}
+
+/*
+ * Procura o par na janela atual e depois na anterior (copiando para a atual).
+ */
+bool ConsultaViaria::procurar(unsigned long long chave, double& d) {
+    if (caches[atual].buscar(chave, d)) return true;
+    if (caches[1 - atual].buscar(chave, d)) {
+        caches[atual].inserir(chave, d);
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Busca na malha, medindo a latência.
+ */
+double ConsultaViaria::buscar(int u, int v, double limite) {
+    long long fixadosAntes = busca.getNosFixados();
+    double inicio = instanteAtual();
+    double d = busca.distancia(u, v, limite);
+    double duracao = instanteAtual() - inicio;
+
+    ++estatisticas.buscas;
+    estatisticas.nosFixados += busca.getNosFixados() - fixadosAntes;
+    estatisticas.tempoBuscas += duracao;
+    if (duracao > estatisticas.maiorBusca) estatisticas.maiorBusca = duracao;
+    return d;
+}
+
+double ConsultaViaria::distancia(int u, int v) {
+    if (u == v) return 0.0;
+    ++estatisticas.consultas;
+
+    unsigned long long chave = chavePar(u, v);
+    double d;
+    if (procurar(chave, d)) {
+        ++estatisticas.acertos;
+        return d;
+    }
+    d = buscar(u, v, INFINITO_BUSCA);
+    caches[atual].inserir(chave, d);
+    return d;
+}
+
+/*
+ * Pares que passam do limite pela reta nem chegam ao cache. A busca dos
+ * demais para no limite; só uma distância exata (dentro dele) é guardada.
+ */
+bool ConsultaViaria::excede(int u, int v, double limite) {
+    const GrafoViario& grafo = rede.getGrafo();
+    double fator = grafo.getFatorReta();
+    if (fator > 0.0) {
+        Ponto a = grafo.getPonto(u);
+        Ponto b = grafo.getPonto(v);
+        double dx = a.x - b.x;
+        double dy = a.y - b.y;
+        double piso = fator * std::sqrt(dx * dx + dy * dy);
+        if (piso > limite + std::fabs(limite) * FOLGA_RETA) {
+            ++estatisticas.descartesPorReta;
+            return true;
+        }
+    }
+
+    if (u == v) return 0.0 > limite;
+    ++estatisticas.consultas;
+
+    unsigned long long chave = chavePar(u, v);
+    double d;
+    if (procurar(chave, d)) {
+        ++estatisticas.acertos;
+        return d > limite;
+    }
+    d = buscar(u, v, limite);
+    if (d <= limite) caches[atual].inserir(chave, d);
+    return d > limite;
+}
+
+const EstatisticasViarias& ConsultaViaria::getEstatisticas() const {
+    return estatisticas;
+}
+
+/*
+ * Leva cada origem e destino ao nó mais próximo da malha.
+ */
+RedeViaria::RedeViaria(const GrafoViario& grafo_, const ColunasDemandas& demandas,
+                       double janela_)
+    : grafo(grafo_),
+      numDemandas(demandas.numDemandas),
+      nosOrigem(nullptr),
+      nosDestino(nullptr),
+      trechosEmbarque(nullptr),
+      trechosDesembarque(nullptr),
+      janela(janela_) {
+    int n = numDemandas > 0 ? numDemandas : 1;
+    nosOrigem = new int[n];
+    nosDestino = new int[n];
+    trechosEmbarque = new double[n]();
+    trechosDesembarque = new double[n]();
+
+    for (int i = 0; i < numDemandas; ++i) {
+        nosOrigem[i] = grafo.noMaisProximo(demandas.origem(i));
+        nosDestino[i] = grafo.noMaisProximo(demandas.destino(i));
+    }
+    estatisticas.zerar();
+}
+
+RedeViaria::~RedeViaria() {
+    delete[] nosOrigem;
+    delete[] nosDestino;
+    delete[] trechosEmbarque;
+    delete[] trechosDesembarque;
+}
+
+const GrafoViario& RedeViaria::getGrafo() const {
+    return grafo;
+}
+
+double RedeViaria::getJanela() const {
+    return janela;
+}
+
+int RedeViaria::getNoOrigem(int i) const {
+    return nosOrigem[i];
+}
+
+int RedeViaria::getNoDestino(int i) const {
+    return nosDestino[i];
+}
+
+void RedeViaria::definirTrechos(int i, double embarque, double desembarque) {
+    trechosEmbarque[i] = embarque;
+    trechosDesembarque[i] = desembarque;
+}
+
+void RedeViaria::definirTrechoDesembarque(int i, double desembarque) {
+    trechosDesembarque[i] = desembarque;
+}
+
+const double* RedeViaria::getTrechosEmbarque() const {
+    return trechosEmbarque;
+}
+
+const double* RedeViaria::getTrechosDesembarque() const {
+    return trechosDesembarque;
+}
+
+void RedeViaria::somarEstatisticas(const EstatisticasViarias& outras) {
+    std::lock_guard<std::mutex> trava(mtx);
+    estatisticas.somar(outras);
+}
+
+const EstatisticasViarias& RedeViaria::getEstatisticas() const {
+    return estatisticas;
+}
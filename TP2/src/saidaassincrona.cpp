@@ -0,0 +1,152 @@
+#include "saidaassincrona.hpp"
+#include <cstring>
+
+/*
+ * Construtor: aloca o anel e inicia a thread escritora.
+ * O produtor começa escrevendo no bloco 0.
+ */
+SaidaAssincrona::SaidaAssincrona(std::streambuf* destino_, int numBlocos_, int tamBloco_)
+    : destino(destino_),
+      memoria(nullptr),
+      tamanhos(nullptr),
+      numBlocos(numBlocos_ > 1 ? numBlocos_ : 2),
+      tamBloco(tamBloco_ > 0 ? tamBloco_ : TAM_BLOCO_PADRAO),
+      publicados(0),
+      consumidos(0),
+      encerrar(false),
+      produtorEsperando(false),
+      escritoraEsperando(false) {
+    memoria = new char[static_cast<std::size_t>(numBlocos) * tamBloco];
+    tamanhos = new int[numBlocos];
+    setp(bloco(0), bloco(0) + tamBloco);
+
+    escritora = std::thread(&SaidaAssincrona::laco, this);
+}
+
+SaidaAssincrona::~SaidaAssincrona() {
+    fechar();
+    delete[] tamanhos;
+    delete[] memoria;
+}
+
+char* SaidaAssincrona::bloco(unsigned indice) const {
+    return memoria + static_cast<std::size_t>(indice % numBlocos) * tamBloco;
+}
+
+/*
+ * Acorda o outro lado se ele estiver (ou estiver prestes a ficar) dormindo.
+ * Quem dorme marca a flag antes de reavaliar a condição sob a trava, então
+ * ou ele vê o contador novo, ou esta thread vê a flag e o notifica.
+ */
+void SaidaAssincrona::acordar(std::atomic<bool>& esperando) {
+    if (esperando.load()) {
+        std::lock_guard<std::mutex> trava(mtx);
+        cv.notify_all();
+    }
+}
+
+/*
+ * Publica o bloco atual (se tiver algo) e passa a escrever no próximo,
+ * esperando a escritora liberar um bloco se o anel estiver cheio.
+ */
+void SaidaAssincrona::publicar() {
+    int usados = static_cast<int>(pptr() - pbase());
+    if (usados == 0) return;
+
+    unsigned p = publicados.load(std::memory_order_relaxed);
+    tamanhos[p % numBlocos] = usados;
+    publicados.store(++p);
+    acordar(escritoraEsperando);
+
+    if (p - consumidos.load() >= static_cast<unsigned>(numBlocos)) {
+        std::unique_lock<std::mutex> trava(mtx);
+        produtorEsperando.store(true);
+        cv.wait(trava, [&] {
+            return p - consumidos.load() < static_cast<unsigned>(numBlocos);
+        });
+        produtorEsperando.store(false);
+    }
+    setp(bloco(p), bloco(p) + tamBloco);
+}
+
+/*
+ * Thread escritora: copia os blocos publicados para o destino, em ordem.
+ * Quando o anel esvazia, descarrega o destino antes de dormir, para que a
+ * saída não fique parada no buffer dele.
+ */
+void SaidaAssincrona::laco() {
+    unsigned c = consumidos.load(std::memory_order_relaxed);
+    while (true) {
+        if (publicados.load() == c) {
+            destino->pubsync();
+
+            std::unique_lock<std::mutex> trava(mtx);
+            escritoraEsperando.store(true);
+            cv.wait(trava, [&] { return publicados.load() != c || encerrar.load(); });
+            escritoraEsperando.store(false);
+
+            // encerrar é marcado depois da última publicação
+            if (publicados.load() == c) return;
+        }
+
+        destino->sputn(bloco(c), tamanhos[c % numBlocos]);
+        consumidos.store(++c);
+        acordar(produtorEsperando);
+    }
+}
+
+int SaidaAssincrona::overflow(int c) {
+    publicar();
+    if (c != traits_type::eof()) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize SaidaAssincrona::xsputn(const char* s, std::streamsize n) {
+    std::streamsize restante = n;
+    while (restante > 0) {
+        std::streamsize livre = epptr() - pptr();
+        if (livre == 0) {
+            publicar();
+            continue;
+        }
+        std::streamsize k = (restante < livre) ? restante : livre;
+        std::memcpy(pptr(), s, static_cast<std::size_t>(k));
+        pbump(static_cast<int>(k));
+        s += k;
+        restante -= k;
+    }
+    return n;
+}
+
+int SaidaAssincrona::sync() {
+    publicar();
+    return 0;
+}
+
+char* SaidaAssincrona::reservar(int n) {
+    if (n > tamBloco) return nullptr;
+    if (epptr() - pptr() < n) {
+        publicar();
+    }
+    return pptr();
+}
+
+void SaidaAssincrona::confirmar(char* fim) {
+    pbump(static_cast<int>(fim - pptr()));
+}
+
+void SaidaAssincrona::fechar() {
+    if (!escritora.joinable()) return;
+
+    publicar();
+    {
+        std::lock_guard<std::mutex> trava(mtx);
+        encerrar.store(true);
+        cv.notify_all();
+    }
+    escritora.join();
+    destino->pubsync();
+}
@@ -0,0 +1,398 @@
+#include "simulacaoanalitica.hpp"
+#include "agrupador.hpp"
+#include "formatacao.hpp"
+#include "qualidadeservico.hpp"
+#include "rastro.hpp"
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+// Corridas por tarefa no cálculo dos tempos e na formatação
+static const int CORRIDAS_POR_TAREFA = 4096;
+
+// Tarefas de formatação por thread em cada rodada (limita a memória)
+static const int TAREFAS_POR_RODADA = 4;
+
+// Texto formatado de um lote de corridas
+struct BufferLote {
+    char* dados;
+    int tamanho;
+    int capacidade;
+
+    void garantir(int extra) {
+        if (tamanho + extra <= capacidade) return;
+        int novaCap = capacidade ? capacidade : 4096;
+        while (novaCap < tamanho + extra) novaCap *= 2;
+        char* novos = new char[novaCap];
+        if (tamanho > 0) std::memcpy(novos, dados, tamanho);
+        delete[] dados;
+        dados = novos;
+        capacidade = novaCap;
+    }
+};
+
+// Dados compartilhados pelas tarefas
+struct ContextoAnalitico {
+    ColunasDemandas demandas;
+    const int* limites;
+    int qtdGrupos;
+    double gama;
+
+    // tempos das paradas: a corrida g ocupa 2 * tamanho posições a partir de
+    // 2 * limites[g] (cada demanda tem duas paradas)
+    double* tempos;
+    double* distancias;     // distância total da rota de cada grupo
+
+    int* ordem;             // grupos na ordem de finalização
+    int* aux;               // vetor auxiliar do merge sort
+    int numPartes;          // partes ordenadas independentemente
+    int larguraIntercalacao; // partes por metade na rodada de intercalação atual
+
+    int primeiroLote;       // lotes de formatação da rodada atual
+    BufferLote* lotes;      // um por lote da rodada
+
+    QualidadeServico* qualidade;  // nullptr sem --qualidade
+    std::mutex mtxQualidade;      // protege a soma das tarefas em qualidade
+};
+
+static int numTarefas(int total, int porTarefa) {
+    return (total + porTarefa - 1) / porTarefa;
+}
+
+/*
+ * Ponto da parada k da rota básica do grupo [inicio, fim):
+ * as origens na ordem, depois os destinos na mesma ordem.
+ */
+static Ponto pontoParada(const ColunasDemandas& demandas, int inicio, int fim, int k) {
+    int tam = fim - inicio;
+    return (k < tam) ? demandas.origem(inicio + k)
+                     : demandas.destino(inicio + k - tam);
+}
+
+/*
+ * Modo viário: distância do trecho que chega à parada k, gravada pelo agrupamento.
+ */
+static double trechoParada(const ColunasDemandas& demandas, int inicio, int fim, int k) {
+    int tam = fim - inicio;
+    return (k < tam) ? demandas.trechosEmbarque[inicio + k]
+                     : demandas.trechosDesembarque[inicio + k - tam];
+}
+
+/*
+ * Percorre a rota do grupo [inicio, fim) com as mesmas contas, na mesma
+ * ordem, que Corrida::calcularTrechosEDistancia e o Escalonador (evento a
+ * evento). Guarda o tempo de cada parada em t, se não for nullptr, e
+ * devolve a distância total e o tempo da última parada.
+ */
+static double percorrerRota(const ColunasDemandas& demandas, int inicio, int fim, double gama,
+                            double* t, double& tempoFim) {
+    int numParadas = 2 * (fim - inicio);
+    double distancia = 0.0;
+    double tempo = demandas.tempo(inicio);
+    if (t) t[0] = tempo;
+
+    Ponto anterior = pontoParada(demandas, inicio, fim, 0);
+    for (int k = 1; k < numParadas; ++k) {
+        Ponto atual = pontoParada(demandas, inicio, fim, k);
+        double dist = demandas.trechosEmbarque ? trechoParada(demandas, inicio, fim, k)
+                                               : distPontos(anterior, atual);
+        distancia += dist;
+        tempo = tempo + ((gama > 0.0) ? (dist / gama) : 0.0);
+        if (t) t[k] = tempo;
+        anterior = atual;
+    }
+
+    tempoFim = tempo;
+    return distancia;
+}
+
+/*
+ * Passo 1: tempos das paradas das corridas do lote de grupos `tarefa`.
+ */
+static void calcularTempos(int tarefa, void* contexto) {
+    RASTRO_TRECHO("tempos das corridas");
+    ContextoAnalitico* ctx = static_cast<ContextoAnalitico*>(contexto);
+    int primeiro = tarefa * CORRIDAS_POR_TAREFA;
+    int ultimo = primeiro + CORRIDAS_POR_TAREFA;
+    if (ultimo > ctx->qtdGrupos) ultimo = ctx->qtdGrupos;
+
+    // a qualidade do lote é medida à parte e somada no fim
+    QualidadeServico* local = ctx->qualidade ? new QualidadeServico(ctx->gama) : nullptr;
+
+    for (int g = primeiro; g < ultimo; ++g) {
+        int inicio = ctx->limites[g];
+        double tempoFim;
+        ctx->distancias[g] = percorrerRota(ctx->demandas, inicio, ctx->limites[g + 1], ctx->gama,
+                                           ctx->tempos + 2 * inicio, tempoFim);
+        if (local) local->registrarGrupo(ctx->demandas, inicio, ctx->limites[g + 1], tempoFim);
+    }
+
+    if (local) {
+        std::lock_guard<std::mutex> trava(ctx->mtxQualidade);
+        ctx->qualidade->somar(*local);
+        delete local;
+    }
+}
+
+/*
+ * true se o Escalonador finalizaria a corrida a antes da corrida b.
+ * Compara os eventos de trás para frente até encontrar tempos diferentes.
+ */
+static bool finalizaAntes(const ContextoAnalitico* ctx, int a, int b) {
+    const double* ta = ctx->tempos + 2 * ctx->limites[a];
+    const double* tb = ctx->tempos + 2 * ctx->limites[b];
+    int i = 2 * (ctx->limites[a + 1] - ctx->limites[a]) - 1;
+    int j = 2 * (ctx->limites[b + 1] - ctx->limites[b]) - 1;
+
+    while (true) {
+        if (ta[i] != tb[j]) return ta[i] < tb[j];
+
+        // um início de corrida é processado antes dos eventos da fila
+        if (i == 0 || j == 0) {
+            if (i == 0 && j == 0) return a < b;
+            return i == 0;
+        }
+        --i;
+        --j;
+    }
+}
+
+/*
+ * Intercala ordem[ini, meio) e ordem[meio, fim) em aux e copia de volta.
+ */
+static void intercalar(ContextoAnalitico* ctx, int ini, int meio, int fim) {
+    int* ordem = ctx->ordem;
+    int* aux = ctx->aux;
+
+    int i = ini, j = meio, k = ini;
+    while (i < meio && j < fim) {
+        aux[k++] = finalizaAntes(ctx, ordem[j], ordem[i]) ? ordem[j++] : ordem[i++];
+    }
+    while (i < meio) aux[k++] = ordem[i++];
+    while (j < fim) aux[k++] = ordem[j++];
+
+    std::memcpy(ordem + ini, aux + ini, sizeof(int) * (fim - ini));
+}
+
+static void ordenarIntervalo(ContextoAnalitico* ctx, int ini, int fim) {
+    if (fim - ini < 2) return;
+
+    int meio = (ini + fim) / 2;
+    ordenarIntervalo(ctx, ini, meio);
+    ordenarIntervalo(ctx, meio, fim);
+    intercalar(ctx, ini, meio, fim);
+}
+
+// Início da parte p quando ordem é dividida em numPartes partes
+static int inicioParte(const ContextoAnalitico* ctx, int p) {
+    if (p >= ctx->numPartes) return ctx->qtdGrupos;
+    return static_cast<int>(static_cast<long long>(ctx->qtdGrupos) * p / ctx->numPartes);
+}
+
+/*
+ * Passo 2a: ordena a parte `tarefa` sequencialmente.
+ */
+static void ordenarParte(int tarefa, void* contexto) {
+    RASTRO_TRECHO("ordenacao das corridas");
+    ContextoAnalitico* ctx = static_cast<ContextoAnalitico*>(contexto);
+    ordenarIntervalo(ctx, inicioParte(ctx, tarefa), inicioParte(ctx, tarefa + 1));
+}
+
+/*
+ * Passo 2b: intercala o par de sequências `tarefa` da rodada atual,
+ * cada uma com larguraIntercalacao partes já ordenadas.
+ */
+static void intercalarPar(int tarefa, void* contexto) {
+    ContextoAnalitico* ctx = static_cast<ContextoAnalitico*>(contexto);
+    int w = ctx->larguraIntercalacao;
+    int p = 2 * w * tarefa;
+    intercalar(ctx, inicioParte(ctx, p), inicioParte(ctx, p + w), inicioParte(ctx, p + 2 * w));
+}
+
+/*
+ * Linha de saída do grupo g, no formato de Corrida::imprimirSaida.
+ * Retorna nullptr se algum valor precisar do formatador geral.
+ */
+static char* formatarLinha(char* p, const ContextoAnalitico* ctx, int g) {
+    int inicio = ctx->limites[g];
+    int fim = ctx->limites[g + 1];
+    int numParadas = 2 * (fim - inicio);
+
+    if (!(p = escreverFixo2(p, ctx->tempos[2 * fim - 1]))) return nullptr;
+    *p++ = ' ';
+    if (!(p = escreverFixo2(p, ctx->distancias[g]))) return nullptr;
+    *p++ = ' ';
+    p = escreverInteiro(p, numParadas);
+
+    for (int k = 0; k < numParadas; ++k) {
+        Ponto pt = pontoParada(ctx->demandas, inicio, fim, k);
+        *p++ = ' ';
+        if (!(p = escreverFixo2(p, pt.x))) return nullptr;
+        *p++ = ' ';
+        if (!(p = escreverFixo2(p, pt.y))) return nullptr;
+    }
+    *p++ = '\n';
+    return p;
+}
+
+/*
+ * A mesma linha pelo std::ostream (fixed, duas casas).
+ */
+static void imprimirLinha(std::ostream& out, const ContextoAnalitico* ctx, int g) {
+    int inicio = ctx->limites[g];
+    int fim = ctx->limites[g + 1];
+    int numParadas = 2 * (fim - inicio);
+
+    out << ctx->tempos[2 * fim - 1] << " " << ctx->distancias[g] << " " << numParadas;
+    for (int k = 0; k < numParadas; ++k) {
+        Ponto pt = pontoParada(ctx->demandas, inicio, fim, k);
+        out << " " << pt.x << " " << pt.y;
+    }
+    out << "\n";
+}
+
+/*
+ * Passo 3: formata as linhas do lote de corridas `tarefa` (em ordem de
+ * finalização) no buffer correspondente da rodada.
+ */
+static void formatarLote(int tarefa, void* contexto) {
+    RASTRO_TRECHO("formatacao");
+    ContextoAnalitico* ctx = static_cast<ContextoAnalitico*>(contexto);
+    int lote = ctx->primeiroLote + tarefa;
+    int primeiro = lote * CORRIDAS_POR_TAREFA;
+    int ultimo = primeiro + CORRIDAS_POR_TAREFA;
+    if (ultimo > ctx->qtdGrupos) ultimo = ctx->qtdGrupos;
+
+    BufferLote& buf = ctx->lotes[tarefa];
+    buf.tamanho = 0;
+
+    for (int pos = primeiro; pos < ultimo; ++pos) {
+        int g = ctx->ordem[pos];
+        int numParadas = 2 * (ctx->limites[g + 1] - ctx->limites[g]);
+
+        // mesmo limite de Corrida::tamanhoMaximoSaida
+        buf.garantir(TAM_MAX_FIXO2 * (2 + 2 * numParadas) + TAM_MAX_INTEIRO + 2 * numParadas + 4);
+        char* p = formatarLinha(buf.dados + buf.tamanho, ctx, g);
+        if (p) {
+            buf.tamanho = static_cast<int>(p - buf.dados);
+        } else {
+            // valores fora do alcance do formatador rápido
+            std::ostringstream linha;
+            linha << std::fixed << std::setprecision(2);
+            imprimirLinha(linha, ctx, g);
+            const std::string texto = linha.str();
+            buf.garantir(static_cast<int>(texto.size()));
+            std::memcpy(buf.dados + buf.tamanho, texto.data(), texto.size());
+            buf.tamanho += static_cast<int>(texto.size());
+        }
+    }
+}
+
+/*
+ * Executa as tarefas no pool, ou em sequência se não houver pool.
+ */
+static void executar(PoolThreads* pool, int qtd, FuncaoTarefa funcao, ContextoAnalitico* ctx) {
+    if (pool) {
+        pool->executar(qtd, funcao, ctx);
+    } else {
+        for (int i = 0; i < qtd; ++i) {
+            funcao(i, ctx);
+        }
+    }
+}
+
+void simularAnalitico(const ColunasDemandas& demandas, const int* limites, int qtdGrupos,
+                      double gama, PoolThreads* pool, std::ostream& out, Metricas* metricas,
+                      QualidadeServico* qualidade) {
+    RASTRO_TRECHO("simulacao analitica");
+    if (qtdGrupos <= 0) return;
+
+    int numThreads = pool ? pool->getNumThreads() : 1;
+    int numDemandas = limites[qtdGrupos];
+
+    ContextoAnalitico ctx;
+    ctx.demandas = demandas;
+    ctx.limites = limites;
+    ctx.qtdGrupos = qtdGrupos;
+    ctx.gama = gama;
+    ctx.tempos = new double[2 * static_cast<long long>(numDemandas)];
+    ctx.distancias = new double[qtdGrupos];
+    ctx.ordem = new int[qtdGrupos];
+    ctx.aux = new int[qtdGrupos];
+    ctx.qualidade = qualidade;
+
+    double marca = iniciarFase(metricas);
+
+    // 1) tempos das paradas
+    executar(pool, numTarefas(qtdGrupos, CORRIDAS_POR_TAREFA), calcularTempos, &ctx);
+    marca = marcarFase(metricas, FASE_MONTAGEM, marca);
+
+    // 2) ordem de finalização: partes ordenadas em paralelo, depois
+    //    intercaladas duas a duas
+    for (int g = 0; g < qtdGrupos; ++g) {
+        ctx.ordem[g] = g;
+    }
+    ctx.numPartes = (qtdGrupos >= 2 * numThreads) ? 2 * numThreads : 1;
+    executar(pool, ctx.numPartes, ordenarParte, &ctx);
+    for (int w = 1; w < ctx.numPartes; w *= 2) {
+        ctx.larguraIntercalacao = w;
+        executar(pool, numTarefas(ctx.numPartes, 2 * w), intercalarPar, &ctx);
+    }
+    delete[] ctx.aux;
+    ctx.aux = nullptr;
+    marca = marcarFase(metricas, FASE_SIMULACAO, marca);
+
+    // 3) formatação em rodadas de lotes, escritos em ordem
+    int totalLotes = numTarefas(qtdGrupos, CORRIDAS_POR_TAREFA);
+    int lotesPorRodada = TAREFAS_POR_RODADA * numThreads;
+    ctx.lotes = new BufferLote[lotesPorRodada];
+    for (int b = 0; b < lotesPorRodada; ++b) {
+        ctx.lotes[b].dados = nullptr;
+        ctx.lotes[b].tamanho = 0;
+        ctx.lotes[b].capacidade = 0;
+    }
+
+    for (ctx.primeiroLote = 0; ctx.primeiroLote < totalLotes; ctx.primeiroLote += lotesPorRodada) {
+        int qtd = totalLotes - ctx.primeiroLote;
+        if (qtd > lotesPorRodada) qtd = lotesPorRodada;
+
+        executar(pool, qtd, formatarLote, &ctx);
+        for (int b = 0; b < qtd; ++b) {
+            out.write(ctx.lotes[b].dados, ctx.lotes[b].tamanho);
+        }
+    }
+
+    marcarFase(metricas, FASE_IMPRESSAO, marca);
+
+    for (int b = 0; b < lotesPorRodada; ++b) {
+        delete[] ctx.lotes[b].dados;
+    }
+    delete[] ctx.lotes;
+    delete[] ctx.ordem;
+    delete[] ctx.distancias;
+    delete[] ctx.tempos;
+}
+
+ResumoSimulacao resumirAnalitico(const ColunasDemandas& demandas, const int* limites,
+                                 int qtdGrupos, double gama) {
+    ResumoSimulacao resumo;
+    resumo.qtdCorridas = qtdGrupos;
+    resumo.distanciaTotal = 0.0;
+    resumo.duracaoMedia = 0.0;
+    resumo.tempoFimMaximo = 0.0;
+
+    double somaDuracoes = 0.0;
+    for (int g = 0; g < qtdGrupos; ++g) {
+        int inicio = limites[g];
+        double tempoFim;
+        resumo.distanciaTotal += percorrerRota(demandas, inicio, limites[g + 1], gama,
+                                               nullptr, tempoFim);
+        somaDuracoes += tempoFim - demandas.tempo(inicio);
+        if (g == 0 || tempoFim > resumo.tempoFimMaximo) resumo.tempoFimMaximo = tempoFim;
+    }
+
+    if (qtdGrupos > 0) resumo.duracaoMedia = somaDuracoes / qtdGrupos;
+    return resumo;
+}
@@ -0,0 +1,365 @@
+#include "simulacaoregioes.hpp"
+#include "agrupador.hpp"
+#include "daryheap.hpp"
+#include "escalonador.hpp"
+#include "fontegrupos.hpp"
+#include "observadorcorridas.hpp"
+#include "qualidadeservico.hpp"
+#include "rastro.hpp"
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+// Capacidade inicial da fila de eventos de cada região
+static const int CAPACIDADE_INICIAL_EVENTOS = 1024;
+
+// Capacidades iniciais do registro de uma região; dobram quando faltam
+static const long long CAPACIDADE_INICIAL_TEXTO = 4096;
+static const int CAPACIDADE_INICIAL_LINHAS = 64;
+
+// Linhas de uma região, formatadas quando o Escalonador finaliza cada
+// corrida: o texto de todas em sequência, e o tempo final e o fim de cada uma
+class RegistroRegiao : public ObservadorCorridas {
+private:
+    char* texto;
+    long long tamTexto;
+    long long capTexto;
+
+    double* tempos;
+    long long* fins;      // a linha k é texto[fins[k - 1], fins[k])
+    int qtdLinhas;
+    int capLinhas;
+
+    void garantirTexto(long long n);
+
+public:
+    RegistroRegiao();
+    ~RegistroRegiao() override;
+
+    RegistroRegiao(const RegistroRegiao&) = delete;
+    RegistroRegiao& operator=(const RegistroRegiao&) = delete;
+
+    void corridaFinalizada(const Corrida& c) override;
+
+    int getQtdLinhas() const { return qtdLinhas; }
+    double getTempo(int k) const { return tempos[k]; }
+    const char* getLinha(int k, long long& tamanho) const {
+        long long inicio = (k > 0) ? fins[k - 1] : 0;
+        tamanho = fins[k] - inicio;
+        return texto + inicio;
+    }
+};
+
+RegistroRegiao::RegistroRegiao()
+    : texto(new char[CAPACIDADE_INICIAL_TEXTO]),
+      tamTexto(0),
+      capTexto(CAPACIDADE_INICIAL_TEXTO),
+      tempos(new double[CAPACIDADE_INICIAL_LINHAS]),
+      fins(new long long[CAPACIDADE_INICIAL_LINHAS]),
+      qtdLinhas(0),
+      capLinhas(CAPACIDADE_INICIAL_LINHAS) {}
+
+RegistroRegiao::~RegistroRegiao() {
+    delete[] texto;
+    delete[] tempos;
+    delete[] fins;
+}
+
+/*
+ * Garante n bytes livres depois do texto.
+ */
+void RegistroRegiao::garantirTexto(long long n) {
+    if (tamTexto + n <= capTexto) return;
+    long long novaCap = capTexto;
+    while (novaCap < tamTexto + n) novaCap *= 2;
+    char* novo = new char[novaCap];
+    std::memcpy(novo, texto, tamTexto);
+    delete[] texto;
+    texto = novo;
+    capTexto = novaCap;
+}
+
+/*
+ * Formata a linha direto no texto, como a saída assíncrona; se algum valor
+ * precisar do formatador geral, passa por um ostream com o formato de
+ * std::cout.
+ */
+void RegistroRegiao::corridaFinalizada(const Corrida& c) {
+    garantirTexto(c.tamanhoMaximoSaida());
+    char* fim = c.formatarSaida(texto + tamTexto);
+    if (fim) {
+        tamTexto = fim - texto;
+    } else {
+        std::ostringstream linha;
+        linha << std::fixed << std::setprecision(2);
+        c.imprimirSaida(linha);
+        std::string s = linha.str();
+        garantirTexto(static_cast<long long>(s.size()));
+        std::memcpy(texto + tamTexto, s.data(), s.size());
+        tamTexto += static_cast<long long>(s.size());
+    }
+
+    if (qtdLinhas == capLinhas) {
+        int novaCap = capLinhas * 2;
+        double* novosTempos = new double[novaCap];
+        long long* novosFins = new long long[novaCap];
+        std::memcpy(novosTempos, tempos, qtdLinhas * sizeof(double));
+        std::memcpy(novosFins, fins, qtdLinhas * sizeof(long long));
+        delete[] tempos;
+        delete[] fins;
+        tempos = novosTempos;
+        fins = novosFins;
+        capLinhas = novaCap;
+    }
+    tempos[qtdLinhas] = c.getTempoFim();
+    fins[qtdLinhas] = tamTexto;
+    ++qtdLinhas;
+}
+
+// Chave da mescla: a próxima linha de uma simulação
+struct ChaveRegiao {
+    double tempo;
+    int simulacao;
+};
+
+struct PrecedeChaveRegiao {
+    bool operator()(const ChaveRegiao& a, const ChaveRegiao& b) const {
+        if (a.tempo != b.tempo) return a.tempo < b.tempo;
+        return a.simulacao < b.simulacao;
+    }
+};
+
+/*
+ * Ordena as simulações pela quantidade de demandas, da maior para a menor,
+ * de forma estável (merge sort).
+ */
+static void ordenarPorTamanho(const int* tamanhos, int* ordem, int* aux, int ini, int fim) {
+    if (fim - ini < 2) return;
+
+    int meio = (ini + fim) / 2;
+    ordenarPorTamanho(tamanhos, ordem, aux, ini, meio);
+    ordenarPorTamanho(tamanhos, ordem, aux, meio, fim);
+
+    int i = ini, j = meio, k = ini;
+    while (i < meio && j < fim) {
+        aux[k++] = (tamanhos[ordem[j]] > tamanhos[ordem[i]]) ? ordem[j++] : ordem[i++];
+    }
+    while (i < meio) aux[k++] = ordem[i++];
+    while (j < fim) aux[k++] = ordem[j++];
+
+    for (k = ini; k < fim; ++k) {
+        ordem[k] = aux[k];
+    }
+}
+
+SimulacaoRegioes::SimulacaoRegioes()
+    : qtdSimulacoes(0),
+      tabelas(nullptr),
+      registros(nullptr),
+      tarefas(nullptr),
+      qtdTarefas(0),
+      internas(0),
+      cruzadas(0) {}
+
+SimulacaoRegioes::~SimulacaoRegioes() {
+    liberarMemoria();
+}
+
+void SimulacaoRegioes::liberarMemoria() {
+    for (int s = 0; s < qtdSimulacoes; ++s) {
+        delete tabelas[s];
+        delete registros[s];
+    }
+    delete[] tabelas;
+    delete[] registros;
+    delete[] tarefas;
+    tabelas = nullptr;
+    registros = nullptr;
+    tarefas = nullptr;
+    qtdSimulacoes = qtdTarefas = 0;
+    internas = cruzadas = 0;
+}
+
+/*
+ * Duas passadas: a primeira acha a simulação de cada demanda e conta, a
+ * segunda copia as demandas para tabelas do tamanho exato.
+ */
+void SimulacaoRegioes::dividir(const TabelaDemandas& tabela, const ParticaoRegioes& particao) {
+    liberarMemoria();
+
+    int reserva = particao.getQtdRegioes();
+    qtdSimulacoes = reserva + 1;
+    tabelas = new TabelaDemandas*[qtdSimulacoes];
+    registros = new RegistroRegiao*[qtdSimulacoes];
+
+    const ColunasDemandas& demandas = tabela.getColunas();
+    int n = tabela.getNumDemandas();
+    int* simulacaoDemanda = new int[n];
+    int* tamanhos = new int[qtdSimulacoes];
+    for (int s = 0; s < qtdSimulacoes; ++s) {
+        tamanhos[s] = 0;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        int r = particao.regiao(demandas.origem(i));
+        int s = (r >= 0 && particao.regiao(demandas.destino(i)) == r) ? r : reserva;
+        simulacaoDemanda[i] = s;
+        ++tamanhos[s];
+    }
+    cruzadas = tamanhos[reserva];
+    internas = n - cruzadas;
+
+    int* posicoes = new int[qtdSimulacoes];
+    for (int s = 0; s < qtdSimulacoes; ++s) {
+        tabelas[s] = tamanhos[s] ? new TabelaDemandas(tamanhos[s]) : nullptr;
+        registros[s] = tamanhos[s] ? new RegistroRegiao() : nullptr;
+        posicoes[s] = 0;
+        if (tamanhos[s]) ++qtdTarefas;
+    }
+    for (int i = 0; i < n; ++i) {
+        int s = simulacaoDemanda[i];
+        tabelas[s]->definir(posicoes[s]++, tabela.getId(i), demandas.tempo(i),
+                            demandas.origem(i), demandas.destino(i));
+    }
+
+    tarefas = new int[qtdTarefas];
+    for (int s = 0, t = 0; s < qtdSimulacoes; ++s) {
+        if (tamanhos[s]) tarefas[t++] = s;
+    }
+    int* aux = new int[qtdTarefas];
+    ordenarPorTamanho(tamanhos, tarefas, aux, 0, qtdTarefas);
+
+    delete[] aux;
+    delete[] posicoes;
+    delete[] tamanhos;
+    delete[] simulacaoDemanda;
+}
+
+int SimulacaoRegioes::getQtdTarefas() const {
+    return qtdTarefas;
+}
+
+// O que cada tarefa precisa para simular a sua região
+struct ContextoRegioes {
+    TabelaDemandas** tabelas;
+    RegistroRegiao** registros;
+    QualidadeServico** qualidades;   // um por tarefa (nullptr se sem qualidade)
+    const int* tarefas;
+    const Parametros* params;
+    TipoFila fila;
+    bool corrotinas;
+};
+
+/*
+ * Agrupamento e simulação de uma região, como no caminho sequencial de
+ * main, com as linhas indo para o registro da região.
+ */
+static void simularRegiao(int indice, void* contexto) {
+    RASTRO_TRECHO("regiao");
+    ContextoRegioes* ctx = static_cast<ContextoRegioes*>(contexto);
+    int s = ctx->tarefas[indice];
+    TabelaDemandas& tabela = *ctx->tabelas[s];
+
+    int qtdGrupos;
+    int* limites = agruparDemandas(tabela.getColunas(), *ctx->params, nullptr, qtdGrupos,
+                                   nullptr, nullptr, tabela.getIds());
+
+    FonteGrupos fonte(tabela, limites, qtdGrupos);
+    Escalonador escalonador(CAPACIDADE_INICIAL_EVENTOS, ctx->params->gama, ctx->fila);
+    escalonador.setDestino(nullptr);
+    escalonador.setObservador(ctx->registros[s]);
+    if (ctx->qualidades) escalonador.setQualidade(ctx->qualidades[indice]);
+
+    if (ctx->corrotinas) {
+        escalonador.simularCorrotinas(&fonte);
+    } else {
+        escalonador.simularEImprimir(&fonte);
+    }
+    delete[] limites;
+}
+
+void SimulacaoRegioes::simular(const Parametros& params, TipoFila fila, bool corrotinas,
+                               PoolThreads* pool, QualidadeServico* qualidade) {
+    ContextoRegioes ctx;
+    ctx.tabelas = tabelas;
+    ctx.registros = registros;
+    ctx.qualidades = nullptr;
+    ctx.tarefas = tarefas;
+    ctx.params = &params;
+    ctx.fila = fila;
+    ctx.corrotinas = corrotinas;
+
+    if (qualidade) {
+        ctx.qualidades = new QualidadeServico*[qtdTarefas];
+        for (int t = 0; t < qtdTarefas; ++t) {
+            ctx.qualidades[t] = new QualidadeServico(params.gama);
+        }
+    }
+
+    if (pool) {
+        pool->executar(qtdTarefas, simularRegiao, &ctx);
+    } else {
+        for (int t = 0; t < qtdTarefas; ++t) {
+            simularRegiao(t, &ctx);
+        }
+    }
+
+    if (qualidade) {
+        for (int t = 0; t < qtdTarefas; ++t) {
+            qualidade->somar(*ctx.qualidades[t]);
+            delete ctx.qualidades[t];
+        }
+        delete[] ctx.qualidades;
+    }
+}
+
+/*
+ * Mescla de qtdTarefas registros ordenados: o heap guarda a próxima linha
+ * de cada um.
+ */
+void SimulacaoRegioes::escrever(std::ostream& out) const {
+    RASTRO_TRECHO("mescla das regioes");
+    DaryHeap<ChaveRegiao, int, 4, PrecedeChaveRegiao> heap;
+    heap.reservar(qtdTarefas);
+
+    int* posicoes = new int[qtdSimulacoes];
+    for (int s = 0; s < qtdSimulacoes; ++s) {
+        posicoes[s] = 0;
+        if (registros[s] && registros[s]->getQtdLinhas() > 0) {
+            ChaveRegiao chave = {registros[s]->getTempo(0), s};
+            heap.inserir(chave, s);
+        }
+    }
+
+    ChaveRegiao chave = {0.0, 0};
+    int s = 0;
+    while (heap.removerMinimo(chave, s)) {
+        const RegistroRegiao* registro = registros[s];
+        int k = posicoes[s]++;
+        long long tamanho;
+        const char* linha = registro->getLinha(k, tamanho);
+        out.write(linha, tamanho);
+
+        if (k + 1 < registro->getQtdLinhas()) {
+            ChaveRegiao proxima = {registro->getTempo(k + 1), s};
+            heap.inserir(proxima, s);
+        }
+    }
+    delete[] posicoes;
+}
+
+void SimulacaoRegioes::imprimirResumo(std::ostream& out) const {
+    int maior = 0;
+    for (int s = 0; s < qtdSimulacoes; ++s) {
+        if (tabelas[s] && tabelas[s]->getNumDemandas() > maior) {
+            maior = tabelas[s]->getNumDemandas();
+        }
+    }
+    out << "regioes: regioes " << (qtdSimulacoes - 1)
+        << " simuladas " << qtdTarefas
+        << " internas " << internas
+        << " cruzadas " << cruzadas
+        << " maior " << maior << "\n";
+}
@@ -0,0 +1,144 @@
+#include "tabelademandas.hpp"
+
+/*
+ * Aloca o bloco da tabela: as cinco colunas quentes e os ids (se a tabela
+ * for dona deles), as corridas e os estados, nessa ordem para manter o
+ * alinhamento de cada vetor.
+ */
+void TabelaDemandas::alocar(bool comDados) {
+    long long n = numDemandas > 0 ? numDemandas : 1;
+    long long bytesValores = comDados ? 5 * n * static_cast<long long>(sizeof(double)) : 0;
+    long long bytesCorridas = n * static_cast<long long>(sizeof(Corrida*));
+    long long bytesIds = comDados ? n * static_cast<long long>(sizeof(int)) : 0;
+    long long bytesEstados = n;
+
+    bloco = new char[bytesValores + bytesCorridas + bytesIds + bytesEstados];
+    char* p = bloco;
+
+    valores = comDados ? reinterpret_cast<double*>(p) : nullptr;
+    p += bytesValores;
+    corridas = reinterpret_cast<Corrida**>(p);
+    p += bytesCorridas;
+    idsProprios = comDados ? reinterpret_cast<int*>(p) : nullptr;
+    p += bytesIds;
+    estados = reinterpret_cast<unsigned char*>(p);
+
+    for (int i = 0; i < numDemandas; ++i) {
+        corridas[i] = nullptr;
+        estados[i] = DEMANDA_DEMANDADA;
+    }
+
+    if (comDados) {
+        colunas.numDemandas = numDemandas;
+        colunas.tempos = valores;
+        colunas.origemX = valores + n;
+        colunas.origemY = valores + 2 * n;
+        colunas.destinoX = valores + 3 * n;
+        colunas.destinoY = valores + 4 * n;
+        colunas.trechosEmbarque = nullptr;
+        colunas.trechosDesembarque = nullptr;
+        ids = idsProprios;
+    }
+}
+
+/*
+ * Tabela dona de tudo, a ser preenchida com definir.
+ */
+TabelaDemandas::TabelaDemandas(int numDemandas_)
+    : numDemandas(numDemandas_ > 0 ? numDemandas_ : 0),
+      bloco(nullptr),
+      valores(nullptr),
+      idsProprios(nullptr),
+      ids(nullptr),
+      corridas(nullptr),
+      estados(nullptr) {
+    alocar(true);
+}
+
+/*
+ * Tabela sobre colunas e ids de fora (que devem durar mais que ela).
+ */
+TabelaDemandas::TabelaDemandas(const ColunasDemandas& colunas_, const int* ids_)
+    : numDemandas(colunas_.numDemandas),
+      bloco(nullptr),
+      valores(nullptr),
+      idsProprios(nullptr),
+      colunas(colunas_),
+      ids(ids_),
+      corridas(nullptr),
+      estados(nullptr) {
+    alocar(false);
+}
+
+TabelaDemandas::~TabelaDemandas() {
+    delete[] bloco;
+}
+
+int TabelaDemandas::getNumDemandas() const {
+    return numDemandas;
+}
+
+const ColunasDemandas& TabelaDemandas::getColunas() const {
+    return colunas;
+}
+
+const int* TabelaDemandas::getIds() const {
+    return ids;
+}
+
+void TabelaDemandas::definir(int i, int id, double tempo, const Ponto& origem,
+                             const Ponto& destino) {
+    long long n = numDemandas;
+    idsProprios[i] = id;
+    valores[i] = tempo;
+    valores[n + i] = origem.x;
+    valores[2 * n + i] = origem.y;
+    valores[3 * n + i] = destino.x;
+    valores[4 * n + i] = destino.y;
+}
+
+void TabelaDemandas::definir(int i, const Demanda& d) {
+    definir(i, d.getId(), d.getTempoSolicitacao(), d.getOrigem(), d.getDestino());
+}
+
+void TabelaDemandas::copiar(int destino, int origem) {
+    definir(destino, ids[origem], colunas.tempo(origem),
+            colunas.origem(origem), colunas.destino(origem));
+    corridas[destino] = corridas[origem];
+    estados[destino] = estados[origem];
+}
+
+TabelaDemandas* TabelaDemandas::copiarTrecho(int inicio, int fim) const {
+    TabelaDemandas* copia = new TabelaDemandas(fim - inicio);
+    for (int k = inicio; k < fim; ++k) {
+        copia->definir(k - inicio, ids[k], colunas.tempo(k),
+                       colunas.origem(k), colunas.destino(k));
+        copia->estados[k - inicio] = estados[k];
+    }
+    return copia;
+}
+
+void TabelaDemandas::definirTrechos(const double* embarque, const double* desembarque) {
+    colunas.trechosEmbarque = embarque;
+    colunas.trechosDesembarque = desembarque;
+}
+
+int TabelaDemandas::getId(int i) const {
+    return ids[i];
+}
+
+EstadoDemanda TabelaDemandas::getEstado(int i) const {
+    return static_cast<EstadoDemanda>(estados[i]);
+}
+
+void TabelaDemandas::setEstado(int i, EstadoDemanda estado) {
+    estados[i] = static_cast<unsigned char>(estado);
+}
+
+Corrida* TabelaDemandas::getCorrida(int i) const {
+    return corridas[i];
+}
+
+void TabelaDemandas::setCorrida(int i, Corrida* corrida) {
+    corridas[i] = corrida;
+}
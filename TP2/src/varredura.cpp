@@ -0,0 +1,206 @@
+#include "varredura.hpp"
+#include "agrupador.hpp"
+#include "simulacaoanalitica.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static const int NUM_CAMPOS = 6;    // η, γ, δ, α, β, λ
+
+// Vetor de parâmetros que dobra de tamanho quando enche
+struct ListaConfiguracoes {
+    Parametros* itens;
+    int qtd;
+    int capacidade;
+
+    void adicionar(const Parametros& p) {
+        if (qtd == capacidade) {
+            int novaCap = capacidade ? capacidade * 2 : 16;
+            Parametros* novos = new Parametros[novaCap];
+            for (int i = 0; i < qtd; ++i) {
+                novos[i] = itens[i];
+            }
+            delete[] itens;
+            itens = novos;
+            capacidade = novaCap;
+        }
+        itens[qtd++] = p;
+    }
+};
+
+/*
+ * Converte um campo "v1,v2,..." em valores. Retorna a quantidade
+ * de valores, ou 0 se algum não for um número.
+ */
+static int lerValores(const std::string& campo, double*& valores) {
+    int qtd = 1;
+    for (char ch : campo) {
+        if (ch == ',') ++qtd;
+    }
+    valores = new double[qtd];
+
+    const char* p = campo.c_str();
+    for (int i = 0; i < qtd; ++i) {
+        char* fim = nullptr;
+        valores[i] = std::strtod(p, &fim);
+        if (fim == p || (*fim != ',' && *fim != '\0')) {
+            delete[] valores;
+            valores = nullptr;
+            return 0;
+        }
+        p = fim + 1;
+    }
+    return qtd;
+}
+
+/*
+ * Acrescenta à lista todas as combinações dos valores dos campos.
+ */
+static void expandirGrade(double* const* valores, const int* qtdValores, ListaConfiguracoes& lista) {
+    int indice[NUM_CAMPOS] = {0, 0, 0, 0, 0, 0};
+
+    while (true) {
+        Parametros p;
+        p.eta = static_cast<int>(valores[0][indice[0]]);
+        p.gama = valores[1][indice[1]];
+        p.delta = valores[2][indice[2]];
+        p.alfa = valores[3][indice[3]];
+        p.beta = valores[4][indice[4]];
+        p.lambda = valores[5][indice[5]];
+        lista.adicionar(p);
+
+        // próxima combinação (o último campo varia mais rápido)
+        int c = NUM_CAMPOS - 1;
+        while (c >= 0 && ++indice[c] == qtdValores[c]) {
+            indice[c] = 0;
+            --c;
+        }
+        if (c < 0) return;
+    }
+}
+
+Parametros* lerConfiguracoes(std::istream& in, int& qtdConfiguracoes) {
+    ListaConfiguracoes lista = {nullptr, 0, 0};
+    qtdConfiguracoes = 0;
+
+    std::string linha;
+    int numLinha = 0;
+    while (std::getline(in, linha)) {
+        ++numLinha;
+
+        std::istringstream campos(linha);
+        std::string campo[NUM_CAMPOS];
+        if (!(campos >> campo[0]) || campo[0][0] == '#') continue;
+
+        double* valores[NUM_CAMPOS] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+        int qtdValores[NUM_CAMPOS];
+        bool valida = true;
+        for (int c = 0; c < NUM_CAMPOS && valida; ++c) {
+            if (c > 0 && !(campos >> campo[c])) {
+                valida = false;
+                break;
+            }
+            qtdValores[c] = lerValores(campo[c], valores[c]);
+            valida = qtdValores[c] > 0;
+        }
+        std::string sobra;
+        if (campos >> sobra) valida = false;
+
+        if (valida) {
+            expandirGrade(valores, qtdValores, lista);
+        }
+        for (int c = 0; c < NUM_CAMPOS; ++c) {
+            delete[] valores[c];
+        }
+
+        if (!valida) {
+            std::cerr << "varredura: linha " << numLinha
+                      << " invalida (esperado: eta gama delta alfa beta lambda)\n";
+            delete[] lista.itens;
+            return nullptr;
+        }
+    }
+
+    if (lista.qtd == 0) {
+        std::cerr << "varredura: nenhum conjunto de parametros\n";
+        delete[] lista.itens;
+        return nullptr;
+    }
+
+    qtdConfiguracoes = lista.qtd;
+    return lista.itens;
+}
+
+// Dados compartilhados pelas tarefas; cada tarefa escreve só o seu resumo
+struct ContextoVarredura {
+    ColunasDemandas demandas;
+    const int* ids;
+    const Parametros* configuracoes;
+    const char* prefixoSaida;
+    ResumoSimulacao* resumos;
+};
+
+/*
+ * Agrupa e simula as demandas com o conjunto de parâmetros `indice`.
+ */
+static void simularConfiguracao(int indice, void* contexto) {
+    ContextoVarredura* ctx = static_cast<ContextoVarredura*>(contexto);
+    const Parametros& params = ctx->configuracoes[indice];
+
+    int qtdGrupos;
+    int* limites = agruparDemandas(ctx->demandas, params, nullptr, qtdGrupos,
+                                   nullptr, nullptr, ctx->ids);
+    ctx->resumos[indice] = resumirAnalitico(ctx->demandas, limites, qtdGrupos, params.gama);
+
+    if (ctx->prefixoSaida) {
+        std::ostringstream nome;
+        nome << ctx->prefixoSaida << indice << ".txt";
+        std::ofstream arquivo(nome.str().c_str());
+        if (arquivo) {
+            simularAnalitico(ctx->demandas, limites, qtdGrupos, params.gama, nullptr, arquivo);
+        } else {
+            ctx->resumos[indice].qtdCorridas = -1;   // sinaliza a falha na tabela
+        }
+    }
+    delete[] limites;
+}
+
+void executarVarredura(const ColunasDemandas& demandas, const int* ids,
+                       const Parametros* configuracoes, int qtdConfiguracoes,
+                       PoolThreads* pool, const char* prefixoSaida, std::ostream& out) {
+    ContextoVarredura ctx;
+    ctx.demandas = demandas;
+    ctx.ids = ids;
+    ctx.configuracoes = configuracoes;
+    ctx.prefixoSaida = prefixoSaida;
+    ctx.resumos = new ResumoSimulacao[qtdConfiguracoes];
+
+    if (pool) {
+        pool->executar(qtdConfiguracoes, simularConfiguracao, &ctx);
+    } else {
+        for (int k = 0; k < qtdConfiguracoes; ++k) {
+            simularConfiguracao(k, &ctx);
+        }
+    }
+
+    out << "eta\tgama\tdelta\talfa\tbeta\tlambda\tcorridas\tdistancia_total\tduracao_media\tfim_ultima\n";
+    for (int k = 0; k < qtdConfiguracoes; ++k) {
+        const Parametros& p = configuracoes[k];
+        const ResumoSimulacao& r = ctx.resumos[k];
+        if (r.qtdCorridas < 0) {
+            std::cerr << "varredura: nao foi possivel escrever a saida do conjunto " << k << "\n";
+        }
+
+        out << std::defaultfloat << std::setprecision(6)
+            << p.eta << "\t" << p.gama << "\t" << p.delta << "\t"
+            << p.alfa << "\t" << p.beta << "\t" << p.lambda << "\t"
+            << (r.qtdCorridas < 0 ? 0 : r.qtdCorridas) << "\t"
+            << std::fixed << std::setprecision(2)
+            << r.distanciaTotal << "\t" << r.duracaoMedia << "\t" << r.tempoFimMaximo << "\n";
+    }
+
+    delete[] ctx.resumos;
+}